@@ -1,437 +1,965 @@
-#pragma once
-
-#include "application.h"
-
-/*
-	An action for the program to perform
-*/
-class action_t
-{
-	protected:
-	int option_num = 0;
-
-	public:
-	enum type_t
-	{
-		FILENAME,
-		LOGIN,
-		DELETE,
-		ADD,
-		MODIFY,
-		SEC_LEVEL,
-		ADD_QUESTION,
-		DEL_QUESTION,
-		ADD_BACKUP,
-		DEL_BACKUP,
-		PRINT,
-		SEARCH,
-		SET_KEY
-	};
-
-	type_t type;	// Type of action
-	std::vector<std::string> options;
-	bool completed = false;
-
-	action_t() {}
-	action_t(type_t);
-	action_t(type_t, int, char*[], int&, int);
-
-	virtual bool exec() = 0;
-	void add_options(int, char*[], int&, int);
-
-	virtual action_t& operator+=(std::string) = 0;
-};
-
-class singleval_action_t : public action_t
-{
-	protected:
-	std::string value;
-
-	public:
-	singleval_action_t(type_t type, std::string value) : action_t(type)
-	{
-		this->value = value;
-	}
-
-	singleval_action_t& operator+=(std::string option)
-	{
-		value = option;
-		option_num++;
-		return *this;
-	}
-};
-
-class namedlist_action_t : public action_t
-{
-	protected:
-	std::string name;
-	std::vector<std::string> items;
-
-	public:
-	namedlist_action_t(type_t type) : action_t(type) {}
-
-	namedlist_action_t& operator+=(std::string option)
-	{
-		switch (option_num)
-		{
-		case 0:
-			name = option;
-			break;
-		default:
-			items.push_back(option);
-		}
-
-		option_num++;
-		return *this;
-	}
-};
-
-class filename_action_t : public singleval_action_t
-{
-	public:
-	filename_action_t(std::string value) : singleval_action_t(FILENAME, value) {}
-
-	bool exec()
-	{
-		credentials_filename = value;
-		return true;
-	}
-};
-
-class login_action_t : public singleval_action_t
-{
-	public:
-	login_action_t(std::string value) : singleval_action_t(LOGIN, value) {}
-
-	bool exec()
-	{
-		if (!session)
-			session = new session_t(value, credentials_filename, keystore_filename, seclevel_filename);
-
-		if (!session->is_logged_in())
-		{
-			delete session;
-			session = nullptr;
-		}
-
-		if (session)
-			std::cout << "Logged in successfully" << std::endl;
-		else
-			std::cout << "Error logging in" << std::endl;
-
-		return session;
-	}
-};
-
-class delete_action_t : public singleval_action_t
-{
-	public:
-	delete_action_t(std::string value) : singleval_action_t(DELETE, value) {}
-
-	bool exec()
-	{
-		if (!confirm_deletion(value))	// Only delete if user confirms
-			return false;
-
-		bool out = session && session->delete_credentials(value);
-
-		if (out)
-			std::cout << "Credentials deleted successfully" << std::endl;
-		else
-			std::cout << "Error deleting credentials" << std::endl;
-
-		return out;
-	}
-};
-
-class add_action_t : public action_t
-{
-	std::string name, username, password;
-
-	public:
-	add_action_t() : action_t(ADD) {}
-	add_action_t(int argc, char* argv[], int& i) : action_t(ADD, argc, argv, i, 3) {}
-
-	bool exec()
-	{
-		if (session)
-		{
-			session->add_credentials(name, username, password);
-			std::cout << "Credentials added sucessfully" << std::endl;
-		}
-		else
-			std::cout << "Could not add credentials given no login" << std::endl;
-
-		return session;
-	}
-
-	add_action_t& operator+=(std::string option)
-	{
-		switch (option_num)
-		{
-			case 0:
-				name = option;
-				break;
-			case 1:
-				username = option;
-				break;
-			case 2:
-				password = option;
-		}
-
-		option_num++;
-		return *this;
-	}
-};
-
-class modify_action_t : public action_t
-{
-	std::string name, field, value;
-
-	public:
-	modify_action_t() : action_t(MODIFY) {}
-	modify_action_t(int argc, char* argv[], int& i) : action_t(MODIFY, argc, argv, i, 3) {}
-
-	bool exec()
-	{
-		bool out = false;
-
-		if (session)
-			out = session->modify_credentials(name, field, value);
-		else
-			std::cout << "Could not modify credentials given no login" << std::endl;
-
-		if (out)
-			std::cout << "Credentials modified sucessfully" << std::endl;
-		else
-			std::cout << "Error modifying credentials" << std::endl;
-
-		return out;
-	}
-
-	modify_action_t& operator+=(std::string option)
-	{
-		switch (option_num)
-		{
-			case 0:
-				name = option;
-				break;
-			case 1:
-				field = option;
-				break;
-			case 2:
-				value = option;
-		}
-
-		option_num++;
-		return *this;
-	}
-};
-
-class seclevel_action_t : public namedlist_action_t
-{
-	public:
-	seclevel_action_t() : namedlist_action_t(SEC_LEVEL) {}
-
-	bool exec()
-	{
-		unsigned int successes = 0;
-
-		if (session)
-			successes = session->set_security_level(name, items);
-		else
-			std::cout << "Could not set security levels given no login" << std::endl;
-
-		if (successes == 0)
-			std::cout << "No security levels set" << std::endl;	// There are two possibilities here; the first is that all of the security-level setting was erronous and the second is that there were no names
-		else if (successes < items.size())
-			std::cout << "Error setting some security levels" << std::endl;
-		else
-			std::cout << "Security levels set successfully" << std::endl;
-
-		return successes == items.size();
-	}
-};
-
-class add_questions_action_t : public namedlist_action_t
-{
-	std::vector<std::pair<std::string, std::string>> get_questions()
-	{
-		std::vector<std::pair<std::string, std::string>> out;
-		
-		for (unsigned int i = 0; i + 1 < items.size(); i += 2)	// Iterate in question/answer pairs
-			out.push_back(std::pair<std::string, std::string>(items.at(i), items.at(i + 1)));
-
-		return out;
-	}
-
-	public:
-	add_questions_action_t() : namedlist_action_t(ADD_QUESTION) {}
-
-	bool exec()
-	{
-		bool out = false;
-
-		if (session)
-			out = session->add_questions(name, get_questions());
-		else
-			std::cout << "Could not add secret questions given no login" << std::endl;
-
-		if (out)
-			std::cout << "Secret questions added successfully" << std::endl;
-		else
-			std::cout << "Error adding secret questions" << std::endl;
-
-		return out;
-	}
-};
-
-class delete_questions_action_t : public namedlist_action_t
-{
-	public:
-	delete_questions_action_t() : namedlist_action_t(DEL_QUESTION) {}
-
-	bool exec()
-	{
-		unsigned int successes = 0;
-
-		if (session)
-			successes = session->delete_questions(name, items);
-		else
-			std::cout << "Could not delete secret questions given no login" << std::endl;
-
-		if (successes == 0)
-			std::cout << "No secret questions deleted" << std::endl;
-		else if (successes < items.size())
-			std::cout << "One or more secret questions not deleted" << std::endl;
-		else
-			std::cout << "Secret questions deleted successfully" << std::endl;
-
-		return successes == items.size();
-	}
-};
-
-class add_backups_action_t : public namedlist_action_t
-{
-	public:
-	add_backups_action_t() : namedlist_action_t(ADD_BACKUP) {}
-
-	bool exec()
-	{
-		bool out = false;
-
-		if (session)
-			out = session->add_backups(name, items);
-		else
-			std::cout << "Could not add backup codes given no login" << std::endl;
-
-		if (out)
-			std::cout << "Backup codes added successfully" << std::endl;
-		else
-			std::cout << "Error adding backup codes" << std::endl;
-
-		return out;
-	}
-};
-
-class delete_backups_action_t : public namedlist_action_t
-{
-	public:
-	delete_backups_action_t() : namedlist_action_t(DEL_BACKUP) {}
-
-	bool exec()
-	{
-		unsigned int successes = 0;
-
-		if (session)
-			successes = session->delete_backups(name, items);
-		else
-			std::cout << "Could not delete backup codes given no login" << std::endl;
-
-		if (successes == 0)
-			std::cout << "No backup codes deleted" << std::endl;
-		else if (successes < items.size())
-			std::cout << "One or more backup codes not deleted" << std::endl;
-		else
-			std::cout << "Backup codes deleted successfully" << std::endl;
-
-		return successes == items.size();
-	}
-};
-
-class print_action_t : public action_t
-{
-	public:
-	print_action_t() : action_t(PRINT) {}
-	
-	bool exec()
-	{
-		if (session)
-			session->print_credentials();
-		else
-			std::cout << "Could not print credentials given no login" << std::endl;
-
-		return session;
-	}
-
-	print_action_t& operator+=(std::string option)
-	{
-		option_num++;
-		return *this;
-	}
-};
-
-class search_action_t : public singleval_action_t
-{
-	public:
-	search_action_t(std::string value) : singleval_action_t(SEARCH, value) {}
-	
-	bool exec()
-	{
-		if (session)
-			session->search_credentials(value);
-		else
-			std::cout << "Could not filter credentials given no login" << std::endl;
-
-		return session;
-	}
-};
-
-class set_key_action_t : public singleval_action_t
-{
-	public:
-	set_key_action_t(std::string value) : singleval_action_t(SET_KEY, value) {}
-
-	bool exec()
-	{
-		if (session)
-			session->set_key(value);
-		else
-			std::cout << "Could not set program key given no login" << std::endl;
-
-		return session;
-	}
-};
-
-action_t::action_t(type_t type)
-{
-	this->type = type;
-}
-
-/*
-	Initialize action and read in arguments from the command line
-*/
-action_t::action_t(action_t::type_t type, int argc, char* argv[], int& i, int n) : action_t(type)
-{
-	add_options(argc, argv, i, n);
-}
-
-/*
-	Read in n arguments from the command line and apply them to this action
-*/
-void action_t::add_options(int argc, char* argv[], int& i, int n)
-{
-	for (; n > 0; n--)
-		if (++i < argc)
-			*this += argv[i];
+#pragma once
+
+#include "application.h"
+
+#define BATCH_RUN_LENGTH 16384	// Most operations of one type a batch gathers before running them together
+
+/*
+	An action for the program to perform
+*/
+class action_t
+{
+	protected:
+	int option_num = 0;
+
+	public:
+	enum type_t
+	{
+		FILENAME,
+		CORPUS,
+		THREADS,
+		FORMAT,
+		COLUMNS,
+		METRICS,
+		RECORD,
+		LOGIN,
+		BATCH,
+		DELETE,
+		ADD,
+		MODIFY,
+		SEC_LEVEL,
+		ROTATE,
+		ADD_QUESTION,
+		DEL_QUESTION,
+		ADD_BACKUP,
+		DEL_BACKUP,
+		PRINT,
+		SEARCH,
+		FUZZY_SEARCH,
+		AUDIT,
+		BUILD_BLOOM,
+		BUILD_DICTIONARY,
+		BREACHES,
+		DUE,
+		SET_KEY,
+		MEMORY_REPORT
+	};
+
+	type_t type;	// Type of action
+	std::vector<std::string> options;
+	bool completed = false;
+
+	action_t() {}
+	action_t(type_t);
+	virtual ~action_t() {}
+
+	virtual void prepare(std::vector<action_t*>) {}	// Called on the first of a run of actions of one type with the whole run, before any of them execute
+	virtual bool exec() = 0;
+	void add_options(int, char*[], int&, int);
+	const char* get_type_name();
+
+	virtual action_t& operator+=(std::string) = 0;
+};
+
+std::vector<action_t*> get_actions(int, char**);
+
+class singleval_action_t : public action_t
+{
+	protected:
+	std::string value;
+
+	public:
+	singleval_action_t(type_t type, std::string value) : action_t(type)
+	{
+		this->value = value;
+	}
+
+	singleval_action_t& operator+=(std::string option)
+	{
+		value = option;
+		option_num++;
+		return *this;
+	}
+};
+
+class namedlist_action_t : public action_t
+{
+	protected:
+	std::string name;
+	std::vector<std::string> items;
+
+	public:
+	namedlist_action_t(type_t type) : action_t(type) {}
+
+	namedlist_action_t& operator+=(std::string option)
+	{
+		switch (option_num)
+		{
+		case 0:
+			name = option;
+			break;
+		default:
+			items.push_back(option);
+		}
+
+		option_num++;
+		return *this;
+	}
+};
+
+class filename_action_t : public singleval_action_t
+{
+	public:
+	filename_action_t(std::string value) : singleval_action_t(FILENAME, value) {}
+
+	bool exec()
+	{
+		credentials_filename = value;
+		return true;
+	}
+};
+
+class corpus_action_t : public singleval_action_t
+{
+	public:
+	corpus_action_t(std::string value) : singleval_action_t(CORPUS, value) {}
+
+	bool exec()
+	{
+		breach_filename = value;
+		return true;
+	}
+};
+
+class threads_action_t : public singleval_action_t
+{
+	public:
+	threads_action_t(std::string value) : singleval_action_t(THREADS, value) {}
+
+	bool exec()
+	{
+		scan_threads = std::max(1, std::atoi(value.c_str()));
+		return true;
+	}
+};
+
+class format_action_t : public singleval_action_t
+{
+	public:
+	format_action_t(std::string value) : singleval_action_t(FORMAT, value) {}
+
+	bool exec()
+	{
+		if (set_output_format(value))
+			return true;
+
+		std::cout << "Unknown output format " << value << ", expected table, json or ndjson" << std::endl;
+		return false;
+	}
+};
+
+class columns_action_t : public singleval_action_t
+{
+	public:
+	columns_action_t(std::string value) : singleval_action_t(COLUMNS, value) {}
+
+	bool exec()
+	{
+		if (set_credentials_columns(value))
+			return true;
+
+		std::cout << "Unknown columns " << value << ", expected a comma-separated list of name, username, password, level, date, questions and backups" << std::endl;
+		return false;
+	}
+};
+
+class metrics_action_t : public singleval_action_t
+{
+	public:
+	metrics_action_t(std::string value) : singleval_action_t(METRICS, value) {}
+
+	bool exec()
+	{
+		metrics_filename = value;
+		return true;
+	}
+};
+
+class record_action_t : public singleval_action_t
+{
+	public:
+	record_action_t(std::string value) : singleval_action_t(RECORD, value) {}
+
+	bool exec()
+	{
+		if (get_workload_recorder().is_open() || get_workload_recorder().open(value))
+			return true;
+
+		std::cout << "Could not open workload log " << value << std::endl;
+		return false;
+	}
+};
+
+class login_action_t : public singleval_action_t
+{
+	public:
+	login_action_t(std::string value) : singleval_action_t(LOGIN, value) {}
+
+	bool exec()
+	{
+		if (!session)
+			session = new session_t(value, credentials_filename, keystore_filename, seclevel_filename);
+
+		if (!session->is_logged_in())
+		{
+			delete session;
+			session = nullptr;
+		}
+
+		if (session)
+			std::cout << "Logged in successfully" << std::endl;
+		else
+			std::cout << "Error logging in" << std::endl;
+
+		return session;
+	}
+};
+
+/*
+	Run action lines from a file, or from standard input if the filename is "-", in one session. Lines take the same -a, -d, -m, -q, -b and -l options as the command line, and blank lines and lines starting with # are skipped. Questions are answered yes, since the lines already say what to do, and each operation reports on one status line.
+*/
+class batch_action_t : public singleval_action_t
+{
+	std::vector<std::pair<unsigned int, action_t*>> run;	// Consecutive operations of one type, with their line numbers
+	unsigned int operations = 0;
+	unsigned int failures = 0;
+
+	static bool is_batchable(type_t type)
+	{
+		return type == DELETE || type == ADD || type == MODIFY || type == SEC_LEVEL || type == ADD_QUESTION || type == DEL_QUESTION || type == ADD_BACKUP || type == DEL_BACKUP;
+	}
+
+	void report(unsigned int line_number, bool out, std::string message)
+	{
+		while (!message.empty() && message.back() == '\n')
+			message.pop_back();
+		for (size_t j = message.find('\n'); j != std::string::npos; j = message.find('\n', j))
+			message.replace(j, 1, "; ");
+
+		std::cout << line_number << '\t' << (out ? "ok" : "error") << '\t' << message << '\n';
+		operations++;
+		failures += !out;
+	}
+
+	/*
+		Run the pending operations together, so that they can share work
+	*/
+	void flush()
+	{
+		if (run.empty())
+			return;
+
+		std::vector<action_t*> actions;
+		for (unsigned int i = 0; i < run.size(); i++)
+			actions.push_back(run.at(i).second);
+
+		std::streambuf* console = std::cout.rdbuf();
+		std::stringstream status;	// Whatever an operation prints becomes its status line
+
+		std::cout.rdbuf(status.rdbuf());
+		actions.front()->prepare(actions);
+		std::cout.rdbuf(console);
+
+		for (unsigned int i = 0; i < run.size(); i++)
+		{
+			status.str(std::string());
+
+			std::cout.rdbuf(status.rdbuf());
+			bool out;
+			{
+				operation_timer_t timer(run.at(i).second->type, run.at(i).second->get_type_name());
+				out = run.at(i).second->exec();
+			}
+			std::cout.rdbuf(console);
+
+			report(run.at(i).first, out, status.str());
+			delete run.at(i).second;
+		}
+
+		run.clear();
+	}
+
+	public:
+	batch_action_t(std::string value) : singleval_action_t(BATCH, value) {}
+
+	bool exec()
+	{
+		if (!session)
+		{
+			std::cout << "Could not run batch given no login" << std::endl;
+			return false;
+		}
+
+		std::ifstream file;
+		if (value != "-")
+		{
+			file.open(value);
+			if (!file.is_open())
+			{
+				std::cout << "Could not open batch file " << value << std::endl;
+				return false;
+			}
+		}
+
+		std::istream& input = value == "-" ? std::cin : file;
+		unsigned int line_number = 0;
+		std::string line;
+
+		confirm_policy_t policy = confirm_policy;
+		confirm_policy = ASSUME_YES;
+
+		while (std::getline(input, line))
+		{
+			line_number++;
+
+			std::string error;
+			std::vector<std::string> words = tokenize(line, &error);
+			if (words.empty() || words.front()[0] == '#')
+				continue;
+
+			if (!error.empty())	// Never run an operation with text other than what was written
+			{
+				flush();
+				report(line_number, false, error);
+				continue;
+			}
+
+			std::vector<char*> args = { const_cast<char*>("batch") };	// Stands in for the program name
+			for (unsigned int i = 0; i < words.size(); i++)
+				args.push_back(&words.at(i)[0]);
+			args.push_back(nullptr);
+
+			std::vector<action_t*> actions;
+			try
+			{
+				actions = get_actions(args.size() - 1, args.data());
+			}
+			catch (const std::exception&)	// Counts that aren't numbers
+			{
+				actions.clear();
+			}
+
+			if (actions.empty())
+			{
+				flush();
+				report(line_number, false, "Unrecognized operation");
+				continue;
+			}
+
+			for (unsigned int i = 0; i < actions.size(); i++)
+			{
+				if (!run.empty() && (run.back().second->type != actions.at(i)->type || run.size() >= BATCH_RUN_LENGTH))
+					flush();
+
+				if (is_batchable(actions.at(i)->type))
+					run.push_back({ line_number, actions.at(i) });
+				else
+				{
+					flush();
+					report(line_number, false, "Not allowed in a batch");
+					delete actions.at(i);
+				}
+			}
+		}
+
+		flush();
+		confirm_policy = policy;
+		std::cout << "Batch complete: " << operations << " operation" << (operations != 1 ? "s" : "") << ", " << failures << " failed" << std::endl;
+
+		return failures == 0;
+	}
+};
+
+class delete_action_t : public singleval_action_t
+{
+	bool prepared = false;
+	bool confirmed = false;
+	bool deleted = false;
+
+	public:
+	delete_action_t(std::string value) : singleval_action_t(DELETE, value) {}
+
+	/*
+		Confirm every deletion in the run, then delete them all in one pass over the credentials
+	*/
+	void prepare(std::vector<action_t*> run)
+	{
+		std::vector<delete_action_t*> confirmed_actions;
+		std::vector<std::string> names;
+
+		for (unsigned int i = 0; i < run.size(); i++)
+		{
+			delete_action_t* action = static_cast<delete_action_t*>(run.at(i));
+			action->prepared = true;
+			action->confirmed = confirm_deletion(action->value);	// Only delete if user confirms
+
+			if (action->confirmed)
+			{
+				confirmed_actions.push_back(action);
+				names.push_back(action->value);
+			}
+		}
+
+		if (!session)
+			return;
+
+		std::vector<bool> deleted = session->delete_credentials(names);
+		for (unsigned int i = 0; i < confirmed_actions.size(); i++)
+			confirmed_actions.at(i)->deleted = deleted.at(i);
+	}
+
+	bool exec()
+	{
+		if (!prepared)
+		{
+			confirmed = confirm_deletion(value);	// Only delete if user confirms
+			deleted = confirmed && session && session->delete_credentials(value);
+		}
+
+		if (!confirmed)
+			return false;
+
+		if (deleted)
+			std::cout << "Credentials deleted successfully" << std::endl;
+		else
+			std::cout << "Error deleting credentials" << std::endl;
+
+		return deleted;
+	}
+};
+
+class add_action_t : public action_t
+{
+	std::string name, username, password;
+	std::string warnings;
+	bool prepared = false;
+
+	public:
+	add_action_t() : action_t(ADD) {}
+	add_action_t(int argc, char* argv[], int& i) : action_t(ADD)
+	{
+		add_options(argc, argv, i, 3);	// Only once this object is fully constructed can operator+= reach the override
+	}
+
+	/*
+		Check the passwords of the run in parallel, and make room for the new credentials
+	*/
+	void prepare(std::vector<action_t*> run)
+	{
+		application::get_breach_corpus();	// Opened here, before the threads share it
+
+		std::vector<std::string> warnings = scan<std::string, action_t*>(run, [](action_t* const& action, std::string& out)
+		{
+			out = application::get_password_warnings(static_cast<add_action_t*>(action)->password);
+			return true;
+		});
+
+		for (unsigned int i = 0; i < run.size(); i++)
+		{
+			static_cast<add_action_t*>(run.at(i))->warnings = warnings.at(i);
+			static_cast<add_action_t*>(run.at(i))->prepared = true;
+		}
+
+		if (session)
+			session->reserve_credentials(run.size());
+	}
+
+	bool exec()
+	{
+		if (session)
+		{
+			std::cout << (prepared ? warnings : application::get_password_warnings(password));
+			session->add_credentials(name, username, password);
+			std::cout << "Credentials added sucessfully" << std::endl;
+		}
+		else
+			std::cout << "Could not add credentials given no login" << std::endl;
+
+		return session;
+	}
+
+	add_action_t& operator+=(std::string option)
+	{
+		switch (option_num)
+		{
+			case 0:
+				name = option;
+				break;
+			case 1:
+				username = option;
+				break;
+			case 2:
+				password = option;
+		}
+
+		option_num++;
+		return *this;
+	}
+};
+
+class modify_action_t : public action_t
+{
+	std::string name, field, value;
+
+	public:
+	modify_action_t() : action_t(MODIFY) {}
+	modify_action_t(int argc, char* argv[], int& i) : action_t(MODIFY)
+	{
+		add_options(argc, argv, i, 3);
+	}
+
+	bool exec()
+	{
+		bool out = false;
+
+		if (session)
+			out = session->modify_credentials(name, field, value);
+		else
+			std::cout << "Could not modify credentials given no login" << std::endl;
+
+		if (out)
+			std::cout << "Credentials modified sucessfully" << std::endl;
+		else
+			std::cout << "Error modifying credentials" << std::endl;
+
+		return out;
+	}
+
+	modify_action_t& operator+=(std::string option)
+	{
+		switch (option_num)
+		{
+			case 0:
+				name = option;
+				break;
+			case 1:
+				field = option;
+				break;
+			case 2:
+				value = option;
+		}
+
+		option_num++;
+		return *this;
+	}
+};
+
+class seclevel_action_t : public namedlist_action_t
+{
+	public:
+	seclevel_action_t() : namedlist_action_t(SEC_LEVEL) {}
+
+	bool exec()
+	{
+		unsigned int successes = 0;
+
+		if (session)
+			successes = session->set_security_level(name, items);
+		else
+			std::cout << "Could not set security levels given no login" << std::endl;
+
+		if (successes == 0)
+			std::cout << "No security levels set" << std::endl;	// There are two possibilities here; the first is that all of the security-level setting was erronous and the second is that there were no names
+		else if (successes < items.size())
+			std::cout << "Error setting some security levels" << std::endl;
+		else
+			std::cout << "Security levels set successfully" << std::endl;
+
+		return successes == items.size();
+	}
+};
+
+class rotate_action_t : public singleval_action_t
+{
+	public:
+	rotate_action_t(std::string value) : singleval_action_t(ROTATE, value) {}
+
+	bool exec()
+	{
+		int updated = -1;
+
+		if (session)
+			updated = session->rotate_seclevel(value);
+		else
+			std::cout << "Could not rotate security level given no login" << std::endl;
+
+		if (updated >= 0)
+			std::cout << "Updated " << updated << " set" << (updated != 1 ? "s" : "") << " of credentials to the " << value << " password" << std::endl;
+		else if (session)
+			std::cout << "Error rotating security level. It must exist and have a password or a working password generator." << std::endl;
+
+		return updated >= 0;
+	}
+};
+
+class add_questions_action_t : public namedlist_action_t
+{
+	std::vector<std::pair<std::string, std::string>> get_questions()
+	{
+		std::vector<std::pair<std::string, std::string>> out;
+		
+		for (unsigned int i = 0; i + 1 < items.size(); i += 2)	// Iterate in question/answer pairs
+			out.push_back(std::pair<std::string, std::string>(items.at(i), items.at(i + 1)));
+
+		return out;
+	}
+
+	public:
+	add_questions_action_t() : namedlist_action_t(ADD_QUESTION) {}
+
+	bool exec()
+	{
+		bool out = false;
+
+		if (session)
+			out = session->add_questions(name, get_questions());
+		else
+			std::cout << "Could not add secret questions given no login" << std::endl;
+
+		if (out)
+			std::cout << "Secret questions added successfully" << std::endl;
+		else
+			std::cout << "Error adding secret questions" << std::endl;
+
+		return out;
+	}
+};
+
+class delete_questions_action_t : public namedlist_action_t
+{
+	public:
+	delete_questions_action_t() : namedlist_action_t(DEL_QUESTION) {}
+
+	bool exec()
+	{
+		unsigned int successes = 0;
+
+		if (session)
+			successes = session->delete_questions(name, items);
+		else
+			std::cout << "Could not delete secret questions given no login" << std::endl;
+
+		if (successes == 0)
+			std::cout << "No secret questions deleted" << std::endl;
+		else if (successes < items.size())
+			std::cout << "One or more secret questions not deleted" << std::endl;
+		else
+			std::cout << "Secret questions deleted successfully" << std::endl;
+
+		return successes == items.size();
+	}
+};
+
+class add_backups_action_t : public namedlist_action_t
+{
+	public:
+	add_backups_action_t() : namedlist_action_t(ADD_BACKUP) {}
+
+	bool exec()
+	{
+		bool out = false;
+
+		if (session)
+			out = session->add_backups(name, items);
+		else
+			std::cout << "Could not add backup codes given no login" << std::endl;
+
+		if (out)
+			std::cout << "Backup codes added successfully" << std::endl;
+		else
+			std::cout << "Error adding backup codes" << std::endl;
+
+		return out;
+	}
+};
+
+class delete_backups_action_t : public namedlist_action_t
+{
+	public:
+	delete_backups_action_t() : namedlist_action_t(DEL_BACKUP) {}
+
+	bool exec()
+	{
+		unsigned int successes = 0;
+
+		if (session)
+			successes = session->delete_backups(name, items);
+		else
+			std::cout << "Could not delete backup codes given no login" << std::endl;
+
+		if (successes == 0)
+			std::cout << "No backup codes deleted" << std::endl;
+		else if (successes < items.size())
+			std::cout << "One or more backup codes not deleted" << std::endl;
+		else
+			std::cout << "Backup codes deleted successfully" << std::endl;
+
+		return successes == items.size();
+	}
+};
+
+class print_action_t : public action_t
+{
+	public:
+	print_action_t() : action_t(PRINT) {}
+	
+	bool exec()
+	{
+		if (session)
+			session->print_credentials();
+		else
+			std::cout << "Could not print credentials given no login" << std::endl;
+
+		return session;
+	}
+
+	print_action_t& operator+=(std::string option)
+	{
+		option_num++;
+		return *this;
+	}
+};
+
+class search_action_t : public singleval_action_t
+{
+	public:
+	search_action_t(std::string value) : singleval_action_t(SEARCH, value) {}
+	
+	bool exec()
+	{
+		if (session)
+			session->search_credentials(value);
+		else
+			std::cout << "Could not filter credentials given no login" << std::endl;
+
+		return session;
+	}
+};
+
+class fuzzy_search_action_t : public singleval_action_t
+{
+	public:
+	fuzzy_search_action_t(std::string value) : singleval_action_t(FUZZY_SEARCH, value) {}
+
+	bool exec()
+	{
+		if (session)
+			session->fuzzy_search_credentials(value);
+		else
+			std::cout << "Could not filter credentials given no login" << std::endl;
+
+		return session;
+	}
+};
+
+class audit_action_t : public action_t
+{
+	public:
+	audit_action_t() : action_t(AUDIT) {}
+
+	bool exec()
+	{
+		if (session)
+			session->audit_credentials();
+		else
+			std::cout << "Could not audit credentials given no login" << std::endl;
+
+		return session;
+	}
+
+	audit_action_t& operator+=(std::string)
+	{
+		option_num++;
+		return *this;
+	}
+};
+
+class build_bloom_action_t : public action_t
+{
+	public:
+	build_bloom_action_t() : action_t(BUILD_BLOOM) {}
+
+	bool exec()
+	{
+		bool out = breach_corpus_t::build_bloom(breach_filename);
+
+		if (out)
+			std::cout << "Bloom filter built for " << breach_filename << std::endl;
+		else
+			std::cout << "Error building Bloom filter for " << breach_filename << std::endl;
+
+		return out;
+	}
+
+	build_bloom_action_t& operator+=(std::string)
+	{
+		option_num++;
+		return *this;
+	}
+};
+
+class build_dictionary_action_t : public action_t
+{
+	public:
+	build_dictionary_action_t() : action_t(BUILD_DICTIONARY) {}
+
+	bool exec()
+	{
+		bool out = !options.empty() && strength_estimator_t::build_dictionary(options, DEFAULT_DICTIONARY_FILENAME);
+
+		if (out)
+			std::cout << "Dictionary " DEFAULT_DICTIONARY_FILENAME " built from " << options.size() << " word list" << (options.size() != 1 ? "s" : "") << std::endl;
+		else
+			std::cout << "Error building dictionary " DEFAULT_DICTIONARY_FILENAME << std::endl;
+
+		return out;
+	}
+
+	build_dictionary_action_t& operator+=(std::string option)
+	{
+		options.push_back(option);
+		option_num++;
+		return *this;
+	}
+};
+
+class breaches_action_t : public action_t
+{
+	public:
+	breaches_action_t() : action_t(BREACHES) {}
+
+	bool exec()
+	{
+		breach_corpus_t* corpus = application::get_breach_corpus();
+
+		if (!session)
+			std::cout << "Could not check credentials given no login" << std::endl;
+		else if (!corpus)
+			std::cout << "Could not open breach corpus " << breach_filename << std::endl;
+		else
+			session->check_breaches(*corpus);
+
+		return session && corpus;
+	}
+
+	breaches_action_t& operator+=(std::string)
+	{
+		option_num++;
+		return *this;
+	}
+};
+
+class due_action_t : public action_t
+{
+	std::string from, to;
+
+	public:
+	due_action_t() : action_t(DUE) {}
+
+	bool exec()
+	{
+		date_t from_date, to_date;
+		bool out = date_t::parse(from, from_date) && date_t::parse(to, to_date);	// Both dates must be real dates in YYYY/MM/DD format
+
+		if (!session)
+			std::cout << "Could not list security levels given no login" << std::endl;
+		else if (!out)
+			std::cout << "Dates must be in YYYY/MM/DD format" << std::endl;
+		else
+			session->print_due_seclevels(from_date, to_date);
+
+		return session && out;
+	}
+
+	due_action_t& operator+=(std::string option)
+	{
+		switch (option_num)
+		{
+			case 0:
+				from = option;
+				break;
+			case 1:
+				to = option;
+		}
+
+		option_num++;
+		return *this;
+	}
+};
+
+class set_key_action_t : public singleval_action_t
+{
+	public:
+	set_key_action_t(std::string value) : singleval_action_t(SET_KEY, value) {}
+
+	bool exec()
+	{
+		if (session)
+			session->set_key(value);
+		else
+			std::cout << "Could not set program key given no login" << std::endl;
+
+		return session;
+	}
+};
+
+/*
+	Print the memory taken up by each subsystem, after every other action has run
+*/
+class memory_report_action_t : public action_t
+{
+	public:
+	memory_report_action_t() : action_t(MEMORY_REPORT) {}
+
+	bool exec()
+	{
+		if (session)
+			session->print_memory();
+		else
+			std::cout << "Could not report memory given no login" << std::endl;
+
+		return session;
+	}
+
+	memory_report_action_t& operator+=(std::string)
+	{
+		option_num++;
+		return *this;
+	}
+};
+
+action_t::action_t(type_t type)
+{
+	this->type = type;
+}
+
+/*
+	Read in n arguments from the command line and apply them to this action
+*/
+void action_t::add_options(int argc, char* argv[], int& i, int n)
+{
+	for (; n > 0 && i + 1 < argc; n--)
+		*this += argv[++i];
+}
+
+/*
+	Name of the action's type, as profiles report it
+*/
+const char* action_t::get_type_name()
+{
+	static const char* names[] = { "filename", "corpus", "threads", "format", "columns", "metrics", "record", "login", "batch", "delete", "add", "modify", "security level", "rotate",
+		"add questions", "delete questions", "add backups", "delete backups", "print", "search", "fuzzy search", "audit", "build bloom filter",
+		"build dictionary", "breaches", "due", "set key", "memory report" };
+
+	return names[type];
 }
\ No newline at end of file
@@ -1,722 +1,916 @@
-#pragma once
-
-#include "key.h"
-#include "session.h"
-
-#define VERSION "1.0"
-#define DEFAULT_CREDENTIALS_FILENAME "credentials.dat"
-#define DEFAULT_KEYSTORE_FILENAME "key.dat"
-#define DEFAULT_SECLEVEL_FILENAME "seclevel.dat"
-
-session_t* session = nullptr;
-std::string credentials_filename = DEFAULT_CREDENTIALS_FILENAME;	// Where to read/store credentials
-std::string keystore_filename = DEFAULT_KEYSTORE_FILENAME;	// Where to read/store keys
-std::string seclevel_filename = DEFAULT_SECLEVEL_FILENAME;	// Where to read/store security-level information
-
-namespace application
-{
-	void run();
-	void edit_credentials();
-	void edit_seclevels();
-
-	void display_title();
-	void display_main_menu();
-	void display_file_menu();
-	void display_modify_credentials_menu();
-	void display_update_seclevels_menu();
-	void display_modify_seclevel_menu();
-	void display_help();
-
-	void add_credentials();
-	void delete_credentials();
-	void modify_credentials();
-	seclevel_t* get_seclevel();
-
-	void add_seclevel();
-	void delete_seclevels();
-	void modify_seclevels();
-
-	bool login();
-	void save_credentials();
-	void save_seclevels();
-
-	/*
-		Run like a windowed application
-	*/
-	void run()
-	{
-		display_title();
-
-		if (login())
-		{
-			std::string response;
-			bool done = false;
-			do
-			{
-				display_main_menu();
-
-				do
-				{
-					response = get("Enter command: ");
-				} while (response.empty());
-
-				std::string filename_response;
-				switch (std::tolower(response[0]))
-				{
-					case 'o':	// Open file
-						filename_response = get("Enter filename, or press <Enter> to open the default credentials file (" + credentials_filename + "): ");
-						if (!filename_response.empty())
-							credentials_filename = filename_response;
-						edit_credentials();
-						credentials_filename = DEFAULT_CREDENTIALS_FILENAME;
-						break;
-
-					case 'k':	// Set program key
-						if (session && confirm("Would you like to update the program key?"))
-							session->set_key(get("Enter new program key: "));
-						break;
-
-					case 'l':	// Update security levels
-						edit_seclevels();
-						break;
-
-					case 'h':	// Help
-						display_help();
-						break;
-
-					case 'q':
-						done = true;
-				}
-			} while (!done);
-		}
-	}
-
-	/*
-		Module to edit credentials in credentials_filename
-	*/
-	void edit_credentials()
-	{
-		if (session || login())
-		{
-			if (!session->read(credentials_filename))
-			{
-				std::cout << "Incorrect static key. Make sure the key.dat file in this folder is the same as the one you used in the past with this file." << std::endl;
-				return;
-			}
-
-			std::string response;
-			std::vector<credentials_t*> update_credentials = session->get_old_passwords();
-			std::vector<printable_t*> printable_update_credentials;	// Same vector cast to printable objects for UI
-			for (std::vector<credentials_t*>::iterator it = update_credentials.begin(); it < update_credentials.end(); it++)
-				printable_update_credentials.push_back((printable_t*)*it);
-
-			if (!update_credentials.empty() && confirm("One or more passwords set by a security level have since been updated. Would you like to update these credentials?"))
-			{
-				do
-				{
-					print_list(printable_update_credentials, session->get_crypt_key());
-					response = get("Enter the index of the set of credentials you would like to update, or enter \"a\" to update all credentials in this list. Press <Enter> to cancel: ");
-
-					if (response.empty())
-						break;
-
-					if (std::tolower(response[0]) == 'a')
-					{
-						for (std::vector<credentials_t*>::iterator it = update_credentials.begin(); it < update_credentials.end(); it++)
-							session->update_password(*it);
-
-						break;
-					}
-					else if (response[0] >= '0' && response[0] <= '9')
-					{
-						unsigned int index = std::stoi(response) - 1;
-
-						if (index >= 0 && index < update_credentials.size())
-						{
-							session->update_password(update_credentials.at(index));
-
-							update_credentials.erase(update_credentials.begin() + index);
-							printable_update_credentials.erase(printable_update_credentials.begin() + index);
-						}
-						else
-							std::cout << "Invalid index. No credentials updated." << std::endl;
-					}
-				} while (!update_credentials.empty() && confirm("Would you like to update more credentials?"));
-			}
-
-			bool done = false;
-			do
-			{
-				display_file_menu();
-
-				do
-				{
-					response = get("Enter command: ");
-				} while (response.empty());
-
-				switch (std::tolower(response[0]))
-				{
-					case 'a':	// Add credentials
-						add_credentials();
-						break;
-
-					case 'd':	// Delete credentials
-						delete_credentials();
-						break;
-
-					case 'm':	// Modify credentials
-						modify_credentials();
-						break;
-
-					case 'p':	// Print credentials
-						session->print_credentials();
-						break;
-
-					case 'q':
-						save_credentials();
-						done = true;
-				}
-			} while (!done);
-
-			session->unload();
-		}
-	}
-
-	/*
-		View and update security-level information
-	*/
-	void edit_seclevels()
-	{
-		if (session || login())
-		{
-			std::string response;
-			std::vector<std::string> options;
-			bool done = false;
-
-			std::vector<seclevel_t*> update_seclevels = session->get_exp_passwords();	// First check if any passwords are due to be updated
-			std::vector<printable_t*> printable_update_seclevels;	// Same vector cast to printable objects for UI
-			for (std::vector<seclevel_t*>::iterator it = update_seclevels.begin(); it < update_seclevels.end(); it++)
-				printable_update_seclevels.push_back((printable_t*)*it);
-
-			if (!update_seclevels.empty() && confirm("One or more security-level passwords have expired. Would you like to update these security levels?"))
-			{
-				do
-				{
-					print_list(printable_update_seclevels, session->get_crypt_key());
-					response = get("Enter the index of the set of credentials you would like to update, or enter \"a\" to update all credentials in this list. Press <Enter> to cancel: ");
-
-					if (response.empty())
-						break;
-
-					if (std::tolower(response[0]) == 'a')
-					{
-						for (std::vector<seclevel_t*>::iterator it = update_seclevels.begin(); it < update_seclevels.end(); it++)
-							session->update_seclevel(*it, get("Enter new password for " + (*it)->get_code() + ": "));
-
-						break;
-					}
-					else if (response[0] >= '0' && response[0] <= '9')
-					{
-						unsigned int index = std::stoi(response) - 1;
-
-						if (index >= 0 && index < update_seclevels.size())
-						{
-							session->update_seclevel(update_seclevels.at(index), get("Enter new password for " + (update_seclevels.at(index))->get_code() + ": "));
-
-							update_seclevels.erase(update_seclevels.begin() + index);
-							printable_update_seclevels.erase(printable_update_seclevels.begin() + index);
-						}
-						else
-							std::cout << "Invalid index. No security levels updated." << std::endl;
-					}
-				} while (!update_seclevels.empty() && confirm("Would you like to update more security levels?"));
-			}
-
-			do
-			{
-				session->print_seclevels();
-				display_update_seclevels_menu();
-
-				response = get("Enter command: ");
-
-				switch (response[0])
-				{
-					case 'a':	// Add security level
-						add_seclevel();
-						break;
-
-					case 'd':	// Delete security levels
-						delete_seclevels();
-						break;
-
-					case 'm':	// Modify security levels
-						modify_seclevels();
-						break;
-
-					case 'q':
-						save_seclevels();
-						done = true;
-				}
-
-				options.clear();
-			} while (!done);
-		}
-	}
-
-	void display_title()
-	{
-		std::cout
-			<< "| Password Manager" << std::endl
-			<< "| by Justin Elli" << std::endl
-			<< "| " << VERSION << std::endl << std::endl;
-
-		std::cout << "NOTE: DO NOT INPUT SENSITIVE INFORMATION INTO THIS ONLINE APPLICATION." << std::endl
-			<< "This application does not meet cryptographic standards and therefore should only be used for demonstration purposes." << std::endl << std::endl;
-	}
-
-	void display_main_menu()
-	{
-		std::cout
-			<< "Open File (o)" << std::endl
-			<< "Set Program Key (k)" << std::endl
-			<< "Update Security Levels (l)" << std::endl
-			<< "Help (h)" << std::endl
-			<< "Quit (q)" << std::endl << std::endl;
-	}
-
-	void display_file_menu()
-	{
-		std::cout
-			<< "Add Credentials (a)" << std::endl
-			<< "Delete Credentials (d)" << std::endl
-			<< "Modify Credentials (m)" << std::endl
-			<< "Print Credentials (p)" << std::endl
-			<< "Save and Exit (q)" << std::endl << std::endl;
-	}
-
-	void display_modify_credentials_menu()
-	{
-		std::cout
-			<< "Change Name (n)" << std::endl
-			<< "Change Username (u)" << std::endl
-			<< "Change Password (p)" << std::endl
-			<< "Change Security Level (l)" << std::endl
-			<< "Edit Secret Questions (s)" << std::endl
-			<< "Edit Backup Codes (b)" << std::endl
-			<< "Finish (q)" << std::endl << std::endl;
-	}
-
-	void display_update_seclevels_menu()
-	{
-		std::cout
-			<< "Add Security Level (a)" << std::endl
-			<< "Delete Security Levels (d)" << std::endl
-			<< "Modify Security Levels (m)" << std::endl
-			<< "Save and Exit (q)" << std::endl << std::endl;
-	}
-
-	void display_modify_seclevel_menu()
-	{
-		std::cout
-			<< "Change Password (p)" << std::endl
-			<< "Change Update Period (m)" << std::endl
-			<< "Change Update Time (u)" << std::endl
-			<< "Finish (q)" << std::endl << std::endl;
-	}
-
-	void display_help()
-	{
-		std::ifstream readme_file("readme.md");
-
-		if (readme_file.is_open())
-			std::cout << std::endl << readme_file.rdbuf() << std::endl;
-	}
-
-	/*
-		Prompt the user to add a set (or multiple sets) of credentials
-	*/
-	void add_credentials()
-	{
-		if (session)
-		{
-			std::string response;
-			std::vector<std::string> options;
-			seclevel_t* seclevel = nullptr;
-			bool no_seclevel = false;
-
-			do
-			{
-				response = get("Enter site name, or press <Enter> to cancel: ");
-				if (!response.empty())
-					options.push_back(response);
-				else
-					break;
-
-				options.push_back(get("Enter username: "));
-
-				seclevel = get_seclevel();
-				if (!seclevel || !seclevel->has_password())	// Password needed
-				{
-					options.push_back(get("Enter password: "));
-					session->add_credentials(options.at(0), options.at(1), options.at(2), seclevel);
-				}
-				else	// Password determined by security level
-					session->add_credentials(options.at(0), options.at(1), seclevel);
-
-				options.clear();
-			} while (confirm("Would you like to add more credentials?"));
-
-			session->print_credentials();
-		}
-	}
-
-	/*
-		Prompt the user to delete a set (or multiple sets) of credentials
-	*/
-	void delete_credentials()
-	{
-		std::string response;
-
-		do
-		{
-			response = get("Enter site name, or press <Enter> to cancel: ");
-			if (response.empty())
-				return;
-			while (!response.empty() && session->is_end(session->find_credentials(response)))
-				response = get("Site name not found. Please enter a valid site name, or press <Enter> to cancel: ");
-
-			if (confirm_deletion((*(session->find_credentials(response)))->get_name()))	// Not the most efficient implementation, but it'll do
-				session->delete_credentials(response);
-		} while (confirm("Would you like to delete more credentials?"));
-	}
-
-	/*
-		Prompt the user to modify a set (or multiple sets) of credentials
-	*/
-	void modify_credentials()
-	{
-		if (session)
-		{
-			std::string response;
-			std::vector<std::string> options;
-			bool done;
-			std::string name, value;
-			std::vector<credentials_t*>::iterator credentials_ptr;
-			seclevel_t* seclevel;
-			std::vector<std::pair<std::string, std::string>> secret_questions;
-			std::vector<std::string> backup_codes;
-
-			do
-			{
-				name = get("Enter site name, or press <Enter> to cancel: ");
-				if (name.empty())	// Cancel if user pressed <Enter> without entering any characters
-					return;
-				while (session->is_end(credentials_ptr = session->find_credentials(name)))
-					name = get("Credentials not found. Please enter a valid site name: ");
-
-				(*credentials_ptr)->print(std::cout, session->get_crypt_key());	// Print credential information
-
-				done = false;
-				do
-				{
-					display_modify_credentials_menu();
-
-					do
-					{
-						response = get("Enter command: ");
-					} while (response.empty());
-
-					value = std::string();
-
-					std::string filename_response;
-					switch (std::tolower(response[0]))
-					{
-						case 'n':	// Site name
-							value = get("Enter the new site name: ");
-						case 'u':	// Username
-							if (value.empty())	// Ensure value is only queried once
-								value = get("Enter the new username: ");
-						case 'p':	// Password
-							if (value.empty())
-								value = get("Enter the new password: ");
-							session->modify_credentials(name, response, value);	// All of n, u, and p will run this line
-							break;
-						case 'l':	// Security level
-							seclevel = get_seclevel();
-							if (seclevel && confirm("Would you like to set the password to that defined by the security level?"))
-								session->modify_credentials(name, "p", seclevel->get_password(session->get_crypt_key()));
-							session->set_security_level(name, seclevel);
-							break;
-
-						case 's':	// Secret questions
-							session->print_questions(name);
-
-							response = get("Enter the index of the secret question you would like to delete, or enter \"a\" to add secret questions: ");
-							if (std::tolower(response[0]) == 'a')
-							{
-								do
-								{
-									options.push_back(get("Enter question: "));
-									options.push_back(get("Enter answer: "));
-									secret_questions.push_back(std::make_pair(options.at(0), options.at(1)));
-									options.clear();
-								} while (confirm("Would you like to add more secret questions?"));
-
-								session->add_questions(name, secret_questions);
-								secret_questions.clear();
-							}
-							else if (response[0] >= '0' && response[0] <= '9')
-								if (session->delete_question(name, std::stoi(response) - 1))
-									std::cout << "Secret question deleted successfully" << std::endl;
-								else
-									std::cout << "Error deleting secret question" << std::endl;
-
-							break;
-
-						case 'b':	// Backup codes
-							session->print_backups(name);
-
-							response = get("Enter the index of the backup code you would like to delete, or enter \"a\" to add backup codes: ");
-							if (std::tolower(response[0]) == 'a')
-							{
-								do
-								{
-									backup_codes.push_back(get("Enter code: "));
-								} while (confirm("Would you like to add more backup codes?"));
-
-								session->add_backups(name, backup_codes);
-								backup_codes.clear();
-							}
-							else if (response[0] >= '0' && response[0] <= '9')
-								if (session->delete_backup(name, std::stoi(response) - 1))
-									std::cout << "Backup code deleted successfully" << std::endl;
-								else
-									std::cout << "Error deleting backup code" << std::endl;
-
-							break;
-
-						case 'q':
-							done = true;
-					}
-				} while (!done);
-
-				session->print_credentials();
-			} while (confirm("Would you like to modify another set of credentials?"));
-		}
-	}
-
-	/*
-		Prompt the user to input a security level and check against existing security levels
-	*/
-	seclevel_t* get_seclevel()
-	{
-		seclevel_t* out = nullptr;
-		std::string response;
-		bool no_seclevel = false;
-
-		response = get("Enter the security level code, or press <Enter> for no security level: ");
-		if (!response.empty())
-			out = session->find_seclevel(response);
-		else	// Denote no security level if the user pressed <Enter> without entering any characters
-			no_seclevel = true;
-		while (!out && !no_seclevel)	// Repeat until a valid security level code is entered or it is denoted that there should be none
-		{
-			response = get("Security level not found. Enter a valid security level code, or press <Enter> for no security level: ");
-			if (!response.empty())
-				out = session->find_seclevel(response);
-			else	// Denote no security level if the user pressed <Enter> without entering any characters
-				no_seclevel = true;
-		}
-
-		return out;
-	}
-
-	/*
-		Prompt the user to add a security level
-	*/
-	void add_seclevel()
-	{
-		std::string response;
-		std::vector<std::string> options;
-		
-		response = get("Enter the security level code, or press <Enter> to cancel: ");
-		if (!response.empty())
-			options.push_back(response);
-		else	// Cancel if user pressed <Enter> without entering any characters
-			return;
-
-		response = get("Enter the security level password, or press <Enter> for no password: ");
-		if (!response.empty())	// Only set the security level password if the user entered characters before pressing <Enter>
-			options.push_back(response);
-
-		options.push_back(get("Enter the number of months each new password should be valid: "));
-
-		response = get("Enter the year of the next password update: ");
-		while (std::stoi(response) < 2000)	// Ensure that the year entered is a valid year
-		{
-			response = get("Error. Please enter a valid year: ");
-		}
-		options.push_back(response);
-
-		response = get("Enter the month of the next password update: ");
-		while (!(std::stoi(response) > 0 && std::stoi(response) <= 12))	// Ensure that the month entered is a valid month
-		{
-			response = get("Error. Please enter a valid month: ");
-		}
-		options.push_back(response);
-
-		response = get("Enter the day of the month of the next password update: ");
-		while (!(std::stoi(response) > 0 && std::stoi(response) <= 31))	// Ensure that the day entered is a valid day of the month
-		{
-			response = get("Error. Please enter a valid day of the month: ");
-		}
-		options.push_back(response);
-
-		if (options.size() == 6)	// Include password
-			session->add_seclevel(options.at(0), options.at(1), std::stoi(options.at(2)), std::stoi(options.at(3)), std::stoi(options.at(4)), std::stoi(options.at(5)));
-
-		if (options.size() == 5)	// No password
-			session->add_seclevel(options.at(0), std::stoi(options.at(1)), std::stoi(options.at(2)), std::stoi(options.at(3)), std::stoi(options.at(4)));
-	}
-
-	/*
-		Prompt the user to delete a security level (or multiple security levels)
-	*/
-	void delete_seclevels()
-	{
-		std::string response;
-		do
-		{
-			response = get("Enter the security level code, or press <Enter> to cancel: ");
-			if (!response.empty())
-				if (session->delete_seclevel(response))
-					std::cout << "Security level deleted successfully" << std::endl;
-				else
-					std::cout << "Error deleting security level" << std::endl;
-		} while (!response.empty() && confirm("Would you like to delete more security levels?"));
-	}
-
-	/*
-		Prompt the user to modify security-level information
-	*/
-	void modify_seclevels()
-	{
-		std::string response;
-		std::string code;
-		std::vector<std::string> options;
-		seclevel_t* seclevel;
-		bool done;
-
-		do
-		{
-			code = get("Enter security-level code, or press <Enter> to cancel: ");
-			if (code.empty())	// Cancel if user pressed <Enter> without entering any characters
-				return;
-			while (!(seclevel = session->find_seclevel(code)))
-				code = get("Security level not found. Please enter a valid security-level code: ");
-
-			seclevel->print_long(std::cout, session->get_crypt_key());	// Print security-level information
-
-			done = false;
-
-			do
-			{
-				display_modify_seclevel_menu();
-
-				do
-				{
-					response = get("Enter command: ");
-				} while (response.empty());
-
-				switch (std::tolower(response[0]))
-				{
-					case 'p':	// Change password
-						response = get("Enter the new password for " + code + ", or press <Enter> to clear the password: ");
-						if (response.empty())	// No password
-							session->clear_seclevel_password(code);
-						else	// New password
-							session->set_seclevel_password(code, response);
-						break;
-
-					case 'm':	// Change update period
-						seclevel->set_months_valid(std::stoi(get("Enter the number of months each password for the " + code + " security level should be valid: ")));
-						break;
-
-					case 'u':	// Change update time
-						response = get("Enter the year of the next password update: ");
-						while (std::stoi(response) < 2000)	// Ensure that the year entered is a valid year
-						{
-							response = get("Error. Please enter a valid year: ");
-						}
-						options.push_back(response);
-
-						response = get("Enter the month of the next password update: ");
-						while (!(std::stoi(response) > 0 && std::stoi(response) <= 12))	// Ensure that the month entered is a valid month
-						{
-							response = get("Error. Please enter a valid month: ");
-						}
-						options.push_back(response);
-
-						response = get("Enter the day of the month of the next password update: ");
-						while (!(std::stoi(response) > 0 && std::stoi(response) <= 31))	// Ensure that the day entered is a valid day of the month
-						{
-							response = get("Error. Please enter a valid day of the month: ");
-						}
-						options.push_back(response);
-
-						seclevel->set_update_time(std::stoi(options.at(0)), std::stoi(options.at(1)), std::stoi(options.at(2)));
-						break;
-
-					case 'q':
-						done = true;
-
-				}
-
-				options.clear();
-			} while (!done);
-		} while (confirm("Would you like to modify more security levels?"));
-	}
-
-	/*
-		Prompt the user to log in
-	*/
-	bool login()
-	{
-		std::string key = get("Enter current program key: ");
-
-		if (session && !session->is_logged_in())	// Run this first so that the user has a chance to log in if the session is logged out
-		{
-			delete session;
-			session = nullptr;
-		}
-
-		if (!session)
-			session = new session_t(key, keystore_filename, seclevel_filename);	// No credentials filename specified here so it can be modified before opening
-
-		if (session->is_logged_in())
-		{
-			std::cout << "Logged in successfully" << std::endl;
-			return true;
-		}
-		else
-		{
-			std::cout << "Login attempt unsuccessful" << std::endl;
-			if (confirm("Would you like to try again?"))
-				return login();
-			else
-				return false;
-		}
-	}
-
-	void save_credentials()
-	{
-		if (session && session->are_credentials_loaded())
-			session->store_credentials(credentials_filename);
-	}
-
-	void save_seclevels()
-	{
-		if (session)
-			session->store_seclevels();
-	}
+#pragma once
+
+#include "key.h"
+#include "session.h"
+
+#define VERSION "1.0"
+#define DEFAULT_CREDENTIALS_FILENAME "credentials.dat"
+#define DEFAULT_KEYSTORE_FILENAME "key.dat"
+#define DEFAULT_SECLEVEL_FILENAME "seclevel.dat"
+#define DEFAULT_BREACH_FILENAME "breaches.txt"
+#define SUGGESTION_COUNT 3	// Number of site names suggested when a site name is not found
+#define COMPLETION_COUNT 10	// Number of matches listed when a completion is ambiguous
+
+session_t* session = nullptr;
+std::string credentials_filename = DEFAULT_CREDENTIALS_FILENAME;	// Where to read/store credentials
+std::string keystore_filename = DEFAULT_KEYSTORE_FILENAME;	// Where to read/store keys
+std::string seclevel_filename = DEFAULT_SECLEVEL_FILENAME;	// Where to read/store security-level information
+std::string breach_filename = DEFAULT_BREACH_FILENAME;	// Where to look up breached passwords, if the file exists
+
+namespace application
+{
+	void run();
+	void edit_credentials();
+	void edit_seclevels();
+
+	void display_title();
+	void display_main_menu();
+	void display_file_menu();
+	void display_modify_credentials_menu();
+	void display_update_seclevels_menu();
+	void display_modify_seclevel_menu();
+	void display_help();
+
+	void add_credentials();
+	void delete_credentials();
+	void modify_credentials();
+	seclevel_t* get_seclevel();
+	std::string get_suggestions(std::string);
+	std::string get_completed(std::string, radix_trie_t&);
+	std::string get_prefix_matches(std::string, radix_trie_t&);
+
+	void add_seclevel();
+	void delete_seclevels();
+	void modify_seclevels();
+	std::string get_seclevel_password(seclevel_t*);
+	generator_t* get_generator();
+
+	breach_corpus_t* get_breach_corpus();
+	std::string get_password_warnings(std::string);
+
+	bool login();
+	void save_credentials();
+	void save_seclevels();
+
+	/*
+		Run like a windowed application
+	*/
+	void run()
+	{
+		display_title();
+
+		if (login())
+		{
+			std::string response;
+			bool done = false;
+			do
+			{
+				display_main_menu();
+
+				do
+				{
+					response = get("Enter command: ");
+				} while (response.empty());
+
+				std::string filename_response;
+				switch (std::tolower(response[0]))
+				{
+					case 'o':	// Open file
+						filename_response = get("Enter filename, or press <Enter> to open the default credentials file (" + credentials_filename + "): ");
+						if (!filename_response.empty())
+							credentials_filename = filename_response;
+						edit_credentials();
+						credentials_filename = DEFAULT_CREDENTIALS_FILENAME;
+						break;
+
+					case 'k':	// Set program key
+						if (session && confirm("Would you like to update the program key?"))
+							session->set_key(get("Enter new program key: "));
+						break;
+
+					case 'l':	// Update security levels
+						edit_seclevels();
+						break;
+
+					case 'h':	// Help
+						display_help();
+						break;
+
+					case 'q':
+						done = true;
+				}
+			} while (!done);
+		}
+	}
+
+	/*
+		Module to edit credentials in credentials_filename
+	*/
+	void edit_credentials()
+	{
+		if (session || login())
+		{
+			if (!session->read(credentials_filename))
+			{
+				std::cout << "Incorrect static key. Make sure the key.dat file in this folder is the same as the one you used in the past with this file." << std::endl;
+				return;
+			}
+
+			std::string response;
+			std::vector<credentials_t*> update_credentials = session->get_old_passwords();
+			std::vector<printable_t*> printable_update_credentials;	// Same vector cast to printable objects for UI
+			for (std::vector<credentials_t*>::iterator it = update_credentials.begin(); it < update_credentials.end(); it++)
+				printable_update_credentials.push_back((printable_t*)*it);
+
+			if (!update_credentials.empty() && confirm("One or more passwords set by a security level have since been updated. Would you like to update these credentials?"))
+			{
+				do
+				{
+					print_list(printable_update_credentials, session->get_crypt_key());
+					response = get("Enter the index of the set of credentials you would like to update, or enter \"a\" to update all credentials in this list. Press <Enter> to cancel: ");
+
+					if (response.empty())
+						break;
+
+					if (std::tolower(response[0]) == 'a')
+					{
+						for (std::vector<credentials_t*>::iterator it = update_credentials.begin(); it < update_credentials.end(); it++)
+							session->update_password(*it);
+
+						break;
+					}
+					else if (response[0] >= '0' && response[0] <= '9')
+					{
+						unsigned int index = std::stoi(response) - 1;
+
+						if (index >= 0 && index < update_credentials.size())
+						{
+							session->update_password(update_credentials.at(index));
+
+							update_credentials.erase(update_credentials.begin() + index);
+							printable_update_credentials.erase(printable_update_credentials.begin() + index);
+						}
+						else
+							std::cout << "Invalid index. No credentials updated." << std::endl;
+					}
+				} while (!update_credentials.empty() && confirm("Would you like to update more credentials?"));
+			}
+
+			bool done = false;
+			do
+			{
+				display_file_menu();
+
+				do
+				{
+					response = get("Enter command: ");
+				} while (response.empty());
+
+				switch (std::tolower(response[0]))
+				{
+					case 'a':	// Add credentials
+						add_credentials();
+						break;
+
+					case 'd':	// Delete credentials
+						delete_credentials();
+						break;
+
+					case 'm':	// Modify credentials
+						modify_credentials();
+						break;
+
+					case 'p':	// Print credentials
+						session->print_credentials();
+						break;
+
+					case 'q':
+						save_credentials();
+						done = true;
+				}
+			} while (!done);
+
+			session->unload();
+		}
+	}
+
+	/*
+		View and update security-level information
+	*/
+	void edit_seclevels()
+	{
+		if (session || login())
+		{
+			std::string response;
+			std::vector<std::string> options;
+			bool done = false;
+
+			std::vector<seclevel_t*> update_seclevels = session->get_exp_passwords();	// First check if any passwords are due to be updated
+			std::vector<printable_t*> printable_update_seclevels;	// Same vector cast to printable objects for UI
+			for (std::vector<seclevel_t*>::iterator it = update_seclevels.begin(); it < update_seclevels.end(); it++)
+				printable_update_seclevels.push_back((printable_t*)*it);
+
+			if (!update_seclevels.empty() && confirm("One or more security-level passwords have expired. Would you like to update these security levels?"))
+			{
+				do
+				{
+					print_list(printable_update_seclevels, session->get_crypt_key());
+					response = get("Enter the index of the set of credentials you would like to update, or enter \"a\" to update all credentials in this list. Press <Enter> to cancel: ");
+
+					if (response.empty())
+						break;
+
+					if (std::tolower(response[0]) == 'a')
+					{
+						for (std::vector<seclevel_t*>::iterator it = update_seclevels.begin(); it < update_seclevels.end(); it++)
+							session->update_seclevel(*it, get_seclevel_password(*it));
+
+						break;
+					}
+					else if (response[0] >= '0' && response[0] <= '9')
+					{
+						unsigned int index = std::stoi(response) - 1;
+
+						if (index >= 0 && index < update_seclevels.size())
+						{
+							session->update_seclevel(update_seclevels.at(index), get_seclevel_password(update_seclevels.at(index)));
+
+							update_seclevels.erase(update_seclevels.begin() + index);
+							printable_update_seclevels.erase(printable_update_seclevels.begin() + index);
+						}
+						else
+							std::cout << "Invalid index. No security levels updated." << std::endl;
+					}
+				} while (!update_seclevels.empty() && confirm("Would you like to update more security levels?"));
+			}
+
+			do
+			{
+				session->print_seclevels();
+				display_update_seclevels_menu();
+
+				response = get("Enter command: ");
+
+				switch (response[0])
+				{
+					case 'a':	// Add security level
+						add_seclevel();
+						break;
+
+					case 'd':	// Delete security levels
+						delete_seclevels();
+						break;
+
+					case 'm':	// Modify security levels
+						modify_seclevels();
+						break;
+
+					case 'q':
+						save_seclevels();
+						done = true;
+				}
+
+				options.clear();
+			} while (!done);
+		}
+	}
+
+	void display_title()
+	{
+		std::cout
+			<< "| Password Manager" << std::endl
+			<< "| by Justin Elli" << std::endl
+			<< "| " << VERSION << std::endl << std::endl;
+
+		std::cout << "NOTE: DO NOT INPUT SENSITIVE INFORMATION INTO THIS ONLINE APPLICATION." << std::endl
+			<< "This application does not meet cryptographic standards and therefore should only be used for demonstration purposes." << std::endl << std::endl;
+	}
+
+	void display_main_menu()
+	{
+		std::cout
+			<< "Open File (o)" << std::endl
+			<< "Set Program Key (k)" << std::endl
+			<< "Update Security Levels (l)" << std::endl
+			<< "Help (h)" << std::endl
+			<< "Quit (q)" << std::endl << std::endl;
+	}
+
+	void display_file_menu()
+	{
+		std::cout
+			<< "Add Credentials (a)" << std::endl
+			<< "Delete Credentials (d)" << std::endl
+			<< "Modify Credentials (m)" << std::endl
+			<< "Print Credentials (p)" << std::endl
+			<< "Save and Exit (q)" << std::endl << std::endl;
+	}
+
+	void display_modify_credentials_menu()
+	{
+		std::cout
+			<< "Change Name (n)" << std::endl
+			<< "Change Username (u)" << std::endl
+			<< "Change Password (p)" << std::endl
+			<< "Change Security Level (l)" << std::endl
+			<< "Edit Secret Questions (s)" << std::endl
+			<< "Edit Backup Codes (b)" << std::endl
+			<< "Finish (q)" << std::endl << std::endl;
+	}
+
+	void display_update_seclevels_menu()
+	{
+		std::cout
+			<< "Add Security Level (a)" << std::endl
+			<< "Delete Security Levels (d)" << std::endl
+			<< "Modify Security Levels (m)" << std::endl
+			<< "Save and Exit (q)" << std::endl << std::endl;
+	}
+
+	void display_modify_seclevel_menu()
+	{
+		std::cout
+			<< "Change Password (p)" << std::endl
+			<< "Change Update Period (m)" << std::endl
+			<< "Change Update Time (u)" << std::endl
+			<< "Change Password History (h)" << std::endl
+			<< "Change Password Generator (g)" << std::endl
+			<< "Finish (q)" << std::endl << std::endl;
+	}
+
+	void display_help()
+	{
+		std::ifstream readme_file("readme.md");
+
+		if (readme_file.is_open())
+			std::cout << std::endl << readme_file.rdbuf() << std::endl;
+	}
+
+	/*
+		Prompt the user to add a set (or multiple sets) of credentials
+	*/
+	void add_credentials()
+	{
+		if (session)
+		{
+			std::string response;
+			std::vector<std::string> options;
+			seclevel_t* seclevel = nullptr;
+			bool no_seclevel = false;
+
+			do
+			{
+				response = get("Enter site name, or press <Enter> to cancel: ");
+				if (!response.empty())
+					options.push_back(response);
+				else
+					break;
+
+				options.push_back(get("Enter username: "));
+
+				seclevel = get_seclevel();
+				if (!seclevel || !seclevel->has_password())	// Password needed
+				{
+					options.push_back(get("Enter password: "));
+					std::cout << get_password_warnings(options.at(2));
+					session->add_credentials(options.at(0), options.at(1), options.at(2), seclevel);
+				}
+				else	// Password determined by security level
+					session->add_credentials(options.at(0), options.at(1), seclevel);
+
+				options.clear();
+			} while (confirm("Would you like to add more credentials?"));
+
+			session->print_credentials();
+		}
+	}
+
+	/*
+		Prompt the user to delete a set (or multiple sets) of credentials
+	*/
+	void delete_credentials()
+	{
+		std::string response;
+
+		do
+		{
+			response = get_completed("Enter site name, or press <Enter> to cancel: ", session->get_name_trie());
+			if (response.empty())
+				return;
+			while (!response.empty() && !session->has_credentials(response))
+				response = get_completed("Site name not found. " + get_prefix_matches(response, session->get_name_trie()) + get_suggestions(response) + "Please enter a valid site name, or press <Enter> to cancel: ", session->get_name_trie());
+			if (response.empty())
+				return;
+
+			if (confirm_deletion((*(session->find_credentials(response)))->get_name()))	// Not the most efficient implementation, but it'll do
+				session->delete_credentials(response);
+		} while (confirm("Would you like to delete more credentials?"));
+	}
+
+	/*
+		Prompt the user to modify a set (or multiple sets) of credentials
+	*/
+	void modify_credentials()
+	{
+		if (session)
+		{
+			std::string response;
+			std::vector<std::string> options;
+			bool done;
+			std::string name, value;
+			std::vector<credentials_t*>::iterator credentials_ptr;
+			seclevel_t* seclevel;
+			std::vector<std::pair<std::string, std::string>> secret_questions;
+			std::vector<std::string> backup_codes;
+
+			do
+			{
+				name = get_completed("Enter site name, or press <Enter> to cancel: ", session->get_name_trie());
+				if (name.empty())	// Cancel if user pressed <Enter> without entering any characters
+					return;
+				while (!session->has_credentials(name))
+					name = get_completed("Credentials not found. " + get_prefix_matches(name, session->get_name_trie()) + get_suggestions(name) + "Please enter a valid site name: ", session->get_name_trie());
+				credentials_ptr = session->find_credentials(name);
+
+				(*credentials_ptr)->print(std::cout, session->get_crypt_key());	// Print credential information
+
+				done = false;
+				do
+				{
+					display_modify_credentials_menu();
+
+					do
+					{
+						response = get("Enter command: ");
+					} while (response.empty());
+
+					value = std::string();
+
+					std::string filename_response;
+					switch (std::tolower(response[0]))
+					{
+						case 'n':	// Site name
+							value = get("Enter the new site name: ");
+						case 'u':	// Username
+							if (value.empty())	// Ensure value is only queried once
+								value = get("Enter the new username: ");
+						case 'p':	// Password
+							if (value.empty())
+								value = get("Enter the new password: ");
+							session->modify_credentials(name, response, value);	// All of n, u, and p will run this line
+							break;
+						case 'l':	// Security level
+							seclevel = get_seclevel();
+							if (seclevel && confirm("Would you like to set the password to that defined by the security level?"))
+								session->modify_credentials(name, "p", seclevel->get_password(session->get_crypt_key()));
+							session->set_security_level(name, seclevel);
+							break;
+
+						case 's':	// Secret questions
+							session->print_questions(name);
+
+							response = get("Enter the index of the secret question you would like to delete, or enter \"a\" to add secret questions: ");
+							if (std::tolower(response[0]) == 'a')
+							{
+								do
+								{
+									options.push_back(get("Enter question: "));
+									options.push_back(get("Enter answer: "));
+									secret_questions.push_back(std::make_pair(options.at(0), options.at(1)));
+									options.clear();
+								} while (confirm("Would you like to add more secret questions?"));
+
+								session->add_questions(name, secret_questions);
+								secret_questions.clear();
+							}
+							else if (response[0] >= '0' && response[0] <= '9')
+								if (session->delete_question(name, std::stoi(response) - 1))
+									std::cout << "Secret question deleted successfully" << std::endl;
+								else
+									std::cout << "Error deleting secret question" << std::endl;
+
+							break;
+
+						case 'b':	// Backup codes
+							session->print_backups(name);
+
+							response = get("Enter the index of the backup code you would like to delete, or enter \"a\" to add backup codes: ");
+							if (std::tolower(response[0]) == 'a')
+							{
+								do
+								{
+									backup_codes.push_back(get("Enter code: "));
+								} while (confirm("Would you like to add more backup codes?"));
+
+								session->add_backups(name, backup_codes);
+								backup_codes.clear();
+							}
+							else if (response[0] >= '0' && response[0] <= '9')
+								if (session->delete_backup(name, std::stoi(response) - 1))
+									std::cout << "Backup code deleted successfully" << std::endl;
+								else
+									std::cout << "Error deleting backup code" << std::endl;
+
+							break;
+
+						case 'q':
+							done = true;
+					}
+				} while (!done);
+
+				session->print_credentials();
+			} while (confirm("Would you like to modify another set of credentials?"));
+		}
+	}
+
+	/*
+		Prompt the user to input a security level and check against existing security levels
+	*/
+	seclevel_t* get_seclevel()
+	{
+		seclevel_t* out = nullptr;
+		std::string response;
+		bool no_seclevel = false;
+
+		response = get_completed("Enter the security level code, or press <Enter> for no security level: ", session->get_seclevel_trie());
+		if (!response.empty())
+			out = session->find_seclevel(response);
+		else	// Denote no security level if the user pressed <Enter> without entering any characters
+			no_seclevel = true;
+		while (!out && !no_seclevel)	// Repeat until a valid security level code is entered or it is denoted that there should be none
+		{
+			response = get_completed("Security level not found. " + get_prefix_matches(response, session->get_seclevel_trie()) + "Enter a valid security level code, or press <Enter> for no security level: ", session->get_seclevel_trie());
+			if (!response.empty())
+				out = session->find_seclevel(response);
+			else	// Denote no security level if the user pressed <Enter> without entering any characters
+				no_seclevel = true;
+		}
+
+		return out;
+	}
+
+	/*
+		Suggest site names resembling a name that was not found, formatted to lead a prompt
+	*/
+	std::string get_suggestions(std::string name)
+	{
+		std::vector<std::string> names = session->suggest_names(name, SUGGESTION_COUNT);
+		std::string out;
+
+		for (unsigned int i = 0; i < names.size(); i++)
+		{
+			if (i > 0)
+				out += i + 1 < names.size() ? ", " : " or ";
+			out += "\"" + names.at(i) + "\"";
+		}
+
+		return out.empty() ? out : "Did you mean " + out + "? ";
+	}
+
+	/*
+		Prompt for a site name or security-level code. A response ending in <Tab> is completed from the trie; if it could be completed more than one way, the matches are listed and the prompt is repeated.
+	*/
+	std::string get_completed(std::string prompt, radix_trie_t& trie)
+	{
+		std::string response = get(prompt);
+
+		while (!response.empty() && response.back() == '\t')
+		{
+			std::string prefix = trie.extend(response.substr(0, response.find_last_not_of('\t') + 1));
+			size_t count = trie.count_prefix(prefix);
+
+			if (count == 1)	// Extending a unique prefix reaches the full name
+			{
+				std::cout << prefix << std::endl;
+				return prefix;
+			}
+
+			std::cout << count << " match" << (count != 1 ? "es" : "") << " for \"" << prefix << "\"" << std::endl;
+
+			std::vector<std::string> matches = trie.complete(prefix, COMPLETION_COUNT);
+			for (unsigned int i = 0; i < matches.size(); i++)
+				std::cout << "\t" << matches.at(i) << std::endl;
+			if (count > matches.size())
+				std::cout << "\t..." << std::endl;
+
+			response = get(prompt);
+		}
+
+		return response;
+	}
+
+	/*
+		Count the names starting with a response that was not found, formatted to lead a prompt
+	*/
+	std::string get_prefix_matches(std::string prefix, radix_trie_t& trie)
+	{
+		size_t count = trie.count_prefix(prefix);
+
+		if (count == 0)
+			return std::string();
+
+		return std::to_string(count) + " name" + (count != 1 ? "s start" : " starts") + " with \"" + prefix + "\" (end with <Tab> to list). ";
+	}
+
+	/*
+		Prompt the user to add a security level
+	*/
+	void add_seclevel()
+	{
+		std::string response;
+		std::vector<std::string> options;
+		
+		response = get("Enter the security level code, or press <Enter> to cancel: ");
+		if (!response.empty())
+			options.push_back(response);
+		else	// Cancel if user pressed <Enter> without entering any characters
+			return;
+
+		response = get("Enter the security level password, or press <Enter> for no password: ");
+		if (!response.empty())	// Only set the security level password if the user entered characters before pressing <Enter>
+			options.push_back(response);
+
+		options.push_back(get("Enter the number of months each new password should be valid: "));
+
+		response = get("Enter the year of the next password update: ");
+		while (std::stoi(response) < 2000)	// Ensure that the year entered is a valid year
+		{
+			response = get("Error. Please enter a valid year: ");
+		}
+		options.push_back(response);
+
+		response = get("Enter the month of the next password update: ");
+		while (!(std::stoi(response) > 0 && std::stoi(response) <= 12))	// Ensure that the month entered is a valid month
+		{
+			response = get("Error. Please enter a valid month: ");
+		}
+		options.push_back(response);
+
+		response = get("Enter the day of the month of the next password update: ");
+		while (!(std::stoi(response) > 0 && std::stoi(response) <= 31))	// Ensure that the day entered is a valid day of the month
+		{
+			response = get("Error. Please enter a valid day of the month: ");
+		}
+		options.push_back(response);
+
+		if (options.size() == 6)	// Include password
+			session->add_seclevel(options.at(0), options.at(1), std::stoi(options.at(2)), std::stoi(options.at(3)), std::stoi(options.at(4)), std::stoi(options.at(5)));
+
+		if (options.size() == 5)	// No password
+			session->add_seclevel(options.at(0), std::stoi(options.at(1)), std::stoi(options.at(2)), std::stoi(options.at(3)), std::stoi(options.at(4)));
+	}
+
+	/*
+		Prompt the user to delete a security level (or multiple security levels)
+	*/
+	void delete_seclevels()
+	{
+		std::string response;
+		do
+		{
+			response = get("Enter the security level code, or press <Enter> to cancel: ");
+			if (!response.empty())
+				if (session->delete_seclevel(response))
+					std::cout << "Security level deleted successfully" << std::endl;
+				else
+					std::cout << "Error deleting security level" << std::endl;
+		} while (!response.empty() && confirm("Would you like to delete more security levels?"));
+	}
+
+	/*
+		Prompt the user to modify security-level information
+	*/
+	void modify_seclevels()
+	{
+		std::string response;
+		std::string code;
+		std::vector<std::string> options;
+		seclevel_t* seclevel;
+		bool done;
+
+		do
+		{
+			code = get("Enter security-level code, or press <Enter> to cancel: ");
+			if (code.empty())	// Cancel if user pressed <Enter> without entering any characters
+				return;
+			while (!(seclevel = session->find_seclevel(code)))
+				code = get("Security level not found. Please enter a valid security-level code: ");
+
+			seclevel->print_long(std::cout, session->get_crypt_key());	// Print security-level information
+
+			done = false;
+
+			do
+			{
+				display_modify_seclevel_menu();
+
+				do
+				{
+					response = get("Enter command: ");
+				} while (response.empty());
+
+				switch (std::tolower(response[0]))
+				{
+					case 'p':	// Change password
+						response = get("Enter the new password for " + code + ", or press <Enter> to clear the password: ");
+						if (response.empty())	// No password
+							session->clear_seclevel_password(code);
+						else	// New password
+							session->set_seclevel_password(code, response);
+						break;
+
+					case 'm':	// Change update period
+						seclevel->set_months_valid(std::stoi(get("Enter the number of months each password for the " + code + " security level should be valid: ")));
+						break;
+
+					case 'u':	// Change update time
+						response = get("Enter the year of the next password update: ");
+						while (std::stoi(response) < 2000)	// Ensure that the year entered is a valid year
+						{
+							response = get("Error. Please enter a valid year: ");
+						}
+						options.push_back(response);
+
+						response = get("Enter the month of the next password update: ");
+						while (!(std::stoi(response) > 0 && std::stoi(response) <= 12))	// Ensure that the month entered is a valid month
+						{
+							response = get("Error. Please enter a valid month: ");
+						}
+						options.push_back(response);
+
+						response = get("Enter the day of the month of the next password update: ");
+						while (!(std::stoi(response) > 0 && std::stoi(response) <= 31))	// Ensure that the day entered is a valid day of the month
+						{
+							response = get("Error. Please enter a valid day of the month: ");
+						}
+						options.push_back(response);
+
+						session->set_seclevel_update_time(code, std::stoi(options.at(0)), std::stoi(options.at(1)), std::stoi(options.at(2)));
+						break;
+
+					case 'h':	// Change password history
+						response = get("Enter the number of previous passwords to remember for " + code + ": ");
+						while (std::stoi(response) < 0)	// Ensure that the depth entered is not negative
+						{
+							response = get("Error. Please enter a number that is not negative: ");
+						}
+						options.push_back(response);
+
+						response = get("Enter the number of months to remember each previous password, or 0 to remember them until they are replaced: ");
+						while (std::stoi(response) < 0)
+						{
+							response = get("Error. Please enter a number that is not negative: ");
+						}
+						options.push_back(response);
+
+						session->set_seclevel_history(code, std::stoi(options.at(0)), std::stoi(options.at(1)));
+						break;
+
+					case 'g':	// Change password generator
+						session->set_seclevel_generator(code, get_generator());
+						break;
+
+					case 'q':
+						done = true;
+
+				}
+
+				options.clear();
+			} while (!done);
+		} while (confirm("Would you like to modify more security levels?"));
+	}
+
+	/*
+		Prompt the user for a new security-level password, offering to generate one if the security level has a generator
+	*/
+	std::string get_seclevel_password(seclevel_t* seclevel)
+	{
+		if (!seclevel->get_generator())
+			return get("Enter new password for " + seclevel->get_code() + ": ");
+
+		std::string response = get("Enter new password for " + seclevel->get_code() + ", or press <Enter> to generate one: ");
+		while (response.empty())
+		{
+			response = seclevel->generate_password();
+			if (response.empty())
+				response = get("The password generator for " + seclevel->get_code() + " could not make a password. Please enter a password: ");
+			else
+				std::cout << "Generated password: " << response << std::endl;
+		}
+
+		return response;
+	}
+
+	/*
+		Prompt the user for a password generation policy. Returns nullptr if the user chooses to have no generator.
+	*/
+	generator_t* get_generator()
+	{
+		std::string response = get("Enter the kind of password to generate: random (r), pronounceable (p), or diceware words (w). Press <Enter> for no generator: ");
+		if (response.empty())
+			return nullptr;
+
+		generator_t::mode_t mode = std::tolower(response[0]) == 'p' ? generator_t::PRONOUNCEABLE : std::tolower(response[0]) == 'w' ? generator_t::DICEWARE : generator_t::RANDOM;
+
+		response = get(std::string("Enter the number of ") + (mode == generator_t::DICEWARE ? "words" : "characters") + ", or press <Enter> for the default: ");
+		int length = response.empty() ? (mode == generator_t::DICEWARE ? 6 : DEFAULT_GENERATOR_LENGTH) : std::stoi(response);
+
+		int classes = generator_t::LOWER | generator_t::UPPER | generator_t::DIGITS | generator_t::SYMBOLS;
+		std::string exclusions;
+
+		if (mode != generator_t::DICEWARE)
+		{
+			response = get("Enter the character classes to use as letters: lowercase (l), uppercase (u), digits (d), symbols (s). Press <Enter> for all: ");
+			if (!response.empty())
+				classes = generator_t::parse_classes(response);
+		}
+
+		if (mode == generator_t::RANDOM)
+			exclusions = get("Enter any characters never to use, such as look-alikes, or press <Enter> for none: ");
+
+		generator_t* out = new generator_t(mode, length, classes, exclusions);
+		if (!out->is_valid())
+			std::cout << "Warning: this generator cannot make passwords" << (mode == generator_t::DICEWARE ? " (is " DEFAULT_WORDLIST_FILENAME " present?)" : "") << std::endl;
+
+		return out;
+	}
+
+	/*
+		Open the breach corpus the first time it is needed. Returns nullptr if there is no usable corpus, since the check is optional.
+	*/
+	breach_corpus_t* get_breach_corpus()
+	{
+		static breach_corpus_t corpus;
+		static std::string opened_filename;
+
+		if (opened_filename != breach_filename)
+		{
+			corpus.open(breach_filename);
+			opened_filename = breach_filename;
+		}
+
+		return corpus.is_open() ? &corpus : nullptr;
+	}
+
+	/*
+		Warning lines for a password that has been seen in breaches or is weak, or an empty string. Safe to call from several threads once the breach corpus is open.
+	*/
+	std::string get_password_warnings(std::string password)
+	{
+		std::string out;
+		breach_corpus_t* corpus = get_breach_corpus();
+		unsigned int count = corpus ? corpus->count(password) : 0;
+
+		if (count > 0)
+			out += "Warning: this password has been seen " + std::to_string(count) + " time" + (count != 1 ? "s" : "") + " in breaches\n";
+
+		strength_t strength = get_strength_estimator().estimate(password);
+		if (strength.is_weak())
+			out += "Warning: this password is weak (" + strength.describe() + ")\n";
+
+		return out;
+	}
+
+	/*
+		Prompt the user to log in
+	*/
+	bool login()
+	{
+		std::string key = get("Enter current program key: ");
+
+		if (session && !session->is_logged_in())	// Run this first so that the user has a chance to log in if the session is logged out
+		{
+			delete session;
+			session = nullptr;
+		}
+
+		if (!session)
+			session = new session_t(key, keystore_filename, seclevel_filename);	// No credentials filename specified here so it can be modified before opening
+
+		if (session->is_logged_in())
+		{
+			std::cout << "Logged in successfully" << std::endl;
+			return true;
+		}
+		else
+		{
+			std::cout << "Login attempt unsuccessful" << std::endl;
+			if (confirm("Would you like to try again?"))
+				return login();
+			else
+				return false;
+		}
+	}
+
+	void save_credentials()
+	{
+		if (session && session->are_credentials_loaded())
+			session->store_credentials(credentials_filename);
+	}
+
+	void save_seclevels()
+	{
+		if (session)
+			session->store_seclevels();
+	}
 }
\ No newline at end of file
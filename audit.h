@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "credentials.h"
+#include "strength.h"
+
+#define AUDIT_MAX_AGE_DAYS 365	// Age past which passwords without a security level are flagged
+#define FINGERPRINT_KEY_LENGTH 16
+
+uint64_t fingerprint(const std::string&, const uint8_t[FINGERPRINT_KEY_LENGTH]);
+
+/*
+	The findings of a password audit for a single set of credentials
+*/
+struct audit_entry_t
+{
+	credentials_t* credentials;
+	strength_t strength;
+	uint64_t fingerprint;	// Keyed hash of the password, equal for equal passwords
+	unsigned int reuse_count;	// Number of sets of credentials sharing the password, filled in after the scan
+	bool old_password;	// Matches a previous password of the security level
+	int age;	// Days since the password was set, or -1 if unknown
+	bool over_age;
+	bool no_backups;
+
+	bool is_weak() const;
+	bool is_flagged() const;
+	std::string describe() const;
+};
+
+inline uint64_t rotate_left(uint64_t x, int b)
+{
+	return (x << b) | (x >> (64 - b));
+}
+
+/*
+	SipHash-2-4 of a password under a secret key. Equal passwords get equal fingerprints, but without the key a fingerprint can't be checked against guesses.
+*/
+uint64_t fingerprint(const std::string& data, const uint8_t key[FINGERPRINT_KEY_LENGTH])
+{
+	uint64_t k0 = 0, k1 = 0;
+	for (int i = 7; i >= 0; i--)
+	{
+		k0 = k0 << 8 | key[i];
+		k1 = k1 << 8 | key[i + 8];
+	}
+
+	uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+	uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+	uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+	uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+
+	auto round = [&]()
+	{
+		v0 += v1; v1 = rotate_left(v1, 13); v1 ^= v0; v0 = rotate_left(v0, 32);
+		v2 += v3; v3 = rotate_left(v3, 16); v3 ^= v2;
+		v0 += v3; v3 = rotate_left(v3, 21); v3 ^= v0;
+		v2 += v1; v1 = rotate_left(v1, 17); v1 ^= v2; v2 = rotate_left(v2, 32);
+	};
+
+	size_t n = data.length();
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+	size_t i = 0;
+
+	for (; i + 8 <= n; i += 8)	// Whole 8-byte words
+	{
+		uint64_t m = 0;
+		for (int j = 7; j >= 0; j--)
+			m = m << 8 | bytes[i + j];
+
+		v3 ^= m;
+		round();
+		round();
+		v0 ^= m;
+	}
+
+	uint64_t m = uint64_t(n) << 56;	// Last word holds the leftover bytes and the length
+	for (size_t j = 0; i + j < n; j++)
+		m |= uint64_t(bytes[i + j]) << (8 * j);
+
+	v3 ^= m;
+	round();
+	round();
+	v0 ^= m;
+
+	v2 ^= 0xff;
+	for (int j = 0; j < 4; j++)
+		round();
+
+	return v0 ^ v1 ^ v2 ^ v3;
+}
+
+bool audit_entry_t::is_weak() const
+{
+	return strength.is_weak();
+}
+
+bool audit_entry_t::is_flagged() const
+{
+	return is_weak() || reuse_count > 1 || old_password || over_age || no_backups;
+}
+
+/*
+	List the problems found, such as "weak (score 1, about 10^4 guesses, a keyboard pattern), shared by 3 sets of credentials, no backup codes"
+*/
+std::string audit_entry_t::describe() const
+{
+	std::string out;
+
+	auto add = [&](std::string finding)
+	{
+		out += (out.empty() ? "" : ", ") + finding;
+	};
+
+	if (is_weak())
+		add("weak (" + strength.describe() + ")");
+	else if (strength.score == WEAK_SCORE + 1)
+		add("fair (" + strength.describe() + ")");
+	if (reuse_count > 1)
+		add("shared by " + std::to_string(reuse_count) + " sets of credentials");
+	if (old_password)
+		add("old security-level password");
+	if (over_age)
+		add(std::to_string(age) + " days old");
+	if (no_backups)
+		add("no backup codes");
+
+	return out;
+}
\ No newline at end of file
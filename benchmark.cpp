@@ -0,0 +1,697 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include "session.h"
+
+#define BENCHMARK_KEY "Benchmark-Key"
+#define BENCHMARK_CREDENTIALS_FILENAME "benchmark_credentials.dat"
+#define BENCHMARK_KEYSTORE_FILENAME "benchmark_key.dat"
+#define BENCHMARK_SECLEVEL_FILENAME "benchmark_seclevel.dat"
+#define BENCHMARK_LOOKUPS 10000	// Lookups timed by find_credentials
+#define BENCHMARK_DEFAULT_THRESHOLD 0.10	// Slowdown against the baseline, as a fraction, that counts as a regression
+#define BENCHMARK_LONG_HAYSTACKS 64	// Distinct long strings searched by lowercase_contains_long, cycled through
+#define BENCHMARK_LONG_HAYSTACK_LENGTH 1024
+#define BENCHMARK_DICEWARE_WORDS 6
+#define BENCHMARK_WORDLIST_SIZE 7776	// Words in a standard diceware list, written when there's no word list to use
+
+/*
+	The size and makeup of a synthetic vault. The same shape and seed always give the same vault.
+*/
+struct vault_shape_t
+{
+	size_t credentials = 1000;
+	unsigned int questions = 1;
+	unsigned int backups = 2;
+	unsigned int seclevels = 8;
+	unsigned int history_depth = 4;
+	unsigned long seed = 1;
+};
+
+struct benchmark_result_t
+{
+	std::string operation;
+	size_t records;
+	unsigned long iterations;
+	double seconds;
+};
+
+/*
+	Latencies of one type of replayed operation, or of every operation under "all"
+*/
+struct replay_result_t
+{
+	std::string operation;
+	size_t records;
+	std::vector<double> latencies;	// Microseconds, in the order the operations ran
+	double seconds = 0;	// Time spent in the operations, or the wall time of the whole replay for "all"
+};
+
+/*
+	Discards everything written to it, so printing is timed without the terminal
+*/
+class null_buffer_t : public std::streambuf
+{
+	protected:
+	std::streamsize xsputn(const char*, std::streamsize n) { return n; }
+	int overflow(int c) { return c; }
+};
+
+std::string get_site_name(size_t);
+std::string get_random_string(std::mt19937_64&, unsigned int);
+void generate_vault(vault_shape_t);
+std::vector<benchmark_result_t> run_benchmarks(vault_shape_t);
+std::vector<benchmark_result_t> run_kernel_benchmarks(vault_shape_t);
+std::vector<replay_result_t> replay_workload(vault_shape_t, const std::vector<workload_operation_t>&);
+void write_results(std::vector<benchmark_result_t>, bool, std::ostream&);
+void write_replay_results(std::vector<replay_result_t>, bool, std::ostream&);
+std::map<std::pair<std::string, size_t>, double> read_baseline(std::string);
+int compare_results(std::vector<benchmark_result_t>, std::map<std::pair<std::string, size_t>, double>, double);
+
+/*
+	Usage: benchmark [--sizes 1000,10000,100000,1000000] [--questions N] [--backups N] [--seclevels N] [--history N] [--seed N]
+		[--format csv|json] [--output FILE] [--baseline FILE] [--threshold FRACTION] [--replay FILE] [--threads N]
+*/
+int main(int argc, char* argv[])
+{
+	vault_shape_t shape;
+	std::vector<size_t> sizes = { 1000, 10000, 100000, 1000000 };
+	bool json = false;
+	std::string output_filename;
+	std::string baseline_filename;
+	std::string replay_filename;
+	double threshold = BENCHMARK_DEFAULT_THRESHOLD;
+
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (!strcmp(argv[i], "--sizes"))
+		{
+			sizes.clear();
+			std::stringstream list(argv[++i]);
+			std::string size;
+			while (std::getline(list, size, ','))
+				sizes.push_back(std::stoul(size));
+		}
+		else if (!strcmp(argv[i], "--questions"))
+			shape.questions = std::stoul(argv[++i]);
+		else if (!strcmp(argv[i], "--backups"))
+			shape.backups = std::stoul(argv[++i]);
+		else if (!strcmp(argv[i], "--seclevels"))
+			shape.seclevels = std::max(1ul, std::stoul(argv[++i]));
+		else if (!strcmp(argv[i], "--history"))
+			shape.history_depth = std::max(1ul, std::stoul(argv[++i]));
+		else if (!strcmp(argv[i], "--seed"))
+			shape.seed = std::stoul(argv[++i]);
+		else if (!strcmp(argv[i], "--format"))
+			json = !strcmp(argv[++i], "json");
+		else if (!strcmp(argv[i], "--output"))
+			output_filename = argv[++i];
+		else if (!strcmp(argv[i], "--baseline"))
+			baseline_filename = argv[++i];
+		else if (!strcmp(argv[i], "--threshold"))
+			threshold = std::stod(argv[++i]);
+		else if (!strcmp(argv[i], "--replay"))
+			replay_filename = argv[++i];
+		else if (!strcmp(argv[i], "--threads"))	// Threads for parallel scans, as with -t; the pool is sized once, so compare counts across runs
+			scan_threads = std::stoul(argv[++i]);
+	}
+
+	std::vector<workload_operation_t> workload;
+	if (!replay_filename.empty())
+	{
+		workload = read_workload(replay_filename);
+		if (workload.empty())
+		{
+			std::cerr << "No operations to replay in " << replay_filename << std::endl;
+			return 1;
+		}
+	}
+
+	null_buffer_t null_buffer;
+	std::streambuf* console = std::cout.rdbuf(&null_buffer);	// The session's own messages and listings go nowhere
+	std::ostream results(console);
+	std::vector<benchmark_result_t> all;
+	std::vector<replay_result_t> replayed;
+
+	for (unsigned int i = 0; i < sizes.size(); i++)
+	{
+		shape.credentials = sizes.at(i);
+		std::cerr << (workload.empty() ? "Benchmarking " : "Replaying against ") << shape.credentials << " records" << std::endl;
+
+		generate_vault(shape);
+		if (workload.empty())
+		{
+			std::vector<benchmark_result_t> sized = run_benchmarks(shape);
+			all.insert(all.end(), sized.begin(), sized.end());
+
+			sized = run_kernel_benchmarks(shape);
+			all.insert(all.end(), sized.begin(), sized.end());
+		}
+		else
+		{
+			std::vector<replay_result_t> sized = replay_workload(shape, workload);
+			replayed.insert(replayed.end(), sized.begin(), sized.end());
+		}
+	}
+
+	std::remove(BENCHMARK_CREDENTIALS_FILENAME);
+	std::remove(BENCHMARK_KEYSTORE_FILENAME);
+	std::remove(BENCHMARK_SECLEVEL_FILENAME);
+
+	std::cout.rdbuf(console);
+
+	std::ofstream file;
+	if (!output_filename.empty())
+		file.open(output_filename, std::ios::trunc);
+	std::ostream& output = output_filename.empty() ? results : file;
+
+	if (!workload.empty())
+	{
+		write_replay_results(replayed, json, output);
+		return 0;
+	}
+
+	write_results(all, json, output);
+
+	if (!baseline_filename.empty())
+		return compare_results(all, read_baseline(baseline_filename), threshold);
+
+	return 0;
+}
+
+std::string get_site_name(size_t i)
+{
+	return "site" + std::to_string(i) + ".example" + std::to_string(i % 97) + ".com";
+}
+
+std::string get_random_string(std::mt19937_64& random, unsigned int length)
+{
+	const char* characters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789!#$%&*+-=?@^_";
+	std::string out;
+
+	for (unsigned int i = 0; i < length; i++)
+		out += characters[random() % std::strlen(characters)];
+
+	return out;
+}
+
+/*
+	Write a vault of the given shape from scratch. Security levels get a full password history, and a quarter of the members of each level still use one of its old passwords, so that get_old_passwords has work to do.
+*/
+void generate_vault(vault_shape_t shape)
+{
+	std::mt19937_64 random(shape.seed);
+	std::vector<std::vector<std::string>> histories(shape.seclevels);
+
+	std::remove(BENCHMARK_CREDENTIALS_FILENAME);
+	std::remove(BENCHMARK_KEYSTORE_FILENAME);
+	std::remove(BENCHMARK_SECLEVEL_FILENAME);
+
+	session_t session(BENCHMARK_KEY, BENCHMARK_KEYSTORE_FILENAME, BENCHMARK_SECLEVEL_FILENAME);
+	std::string key = session.get_crypt_key();
+
+	for (unsigned int i = 0; i < shape.seclevels; i++)
+	{
+		std::string code = "L" + std::to_string(i);
+
+		session.add_seclevel(code, get_random_string(random, 16), 6, 2030, 1, 1);
+		session.set_seclevel_history(code, shape.history_depth, 0);
+
+		for (unsigned int j = 0; j < shape.history_depth; j++)
+		{
+			histories.at(i).push_back(get_random_string(random, 16));
+			session.set_seclevel_password(code, histories.at(i).back());
+		}
+	}
+	session.store_seclevels();
+
+	std::ofstream file(BENCHMARK_CREDENTIALS_FILENAME, std::ios::trunc | std::ios::binary);
+	storage::store_gs('K', file);
+	key_t(key).store(file);
+	storage::store_gs('C', file);
+
+	for (size_t i = 0; i < shape.credentials; i++)
+	{
+		unsigned int level = random() % (shape.seclevels + 1);	// One more than there are levels, for credentials without one
+		std::string password = get_random_string(random, 16);
+
+		if (level < shape.seclevels && shape.history_depth > 1 && random() % 4 == 0)
+			password = histories.at(level).at(random() % (shape.history_depth - 1));	// Any but the current password
+
+		credentials_t credentials(get_site_name(i), get_random_string(random, 10) + "@example.com", password,
+			level < shape.seclevels ? "L" + std::to_string(level) : NO_SECURITY_LEVEL, key);
+
+		std::vector<std::pair<std::string, std::string>> questions;
+		for (unsigned int j = 0; j < shape.questions; j++)
+			questions.push_back(std::make_pair("Question " + std::to_string(j) + "?", get_random_string(random, 12)));
+		credentials.add_questions(questions, key);
+
+		std::vector<std::string> backups;
+		for (unsigned int j = 0; j < shape.backups; j++)
+			backups.push_back(get_random_string(random, 8));
+		credentials.add_backups(backups, key);
+
+		credentials.store(file);
+	}
+
+	storage::store_rs(file);
+}
+
+/*
+	Time each operation once over the whole vault, or BENCHMARK_LOOKUPS times for single lookups
+*/
+std::vector<benchmark_result_t> run_benchmarks(vault_shape_t shape)
+{
+	std::vector<benchmark_result_t> out;
+	std::mt19937_64 random(shape.seed + 1);
+	std::chrono::steady_clock::time_point start;
+
+	std::function<void(std::string, unsigned long)> record = [&](std::string operation, unsigned long iterations)
+	{
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		out.push_back(benchmark_result_t{ operation, shape.credentials, iterations, seconds });
+	};
+
+	session_t session(BENCHMARK_KEY, BENCHMARK_KEYSTORE_FILENAME, BENCHMARK_SECLEVEL_FILENAME);
+	std::string key = session.get_crypt_key();
+
+	start = std::chrono::steady_clock::now();
+	session.read(BENCHMARK_CREDENTIALS_FILENAME);
+	record("read", 1);
+
+	std::vector<std::string> names;
+	for (unsigned int i = 0; i < BENCHMARK_LOOKUPS; i++)
+		names.push_back(get_site_name(random() % shape.credentials));
+
+	start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < names.size(); i++)
+		session.find_credentials(names.at(i));
+	record("find_credentials", names.size());
+
+	start = std::chrono::steady_clock::now();
+	session.search_credentials("example42 level:L1 has:backups");
+	record("search_credentials", 1);
+
+	start = std::chrono::steady_clock::now();
+	session.print_credentials();
+	record("print_credentials", 1);
+
+	start = std::chrono::steady_clock::now();
+	session.get_old_passwords();
+	record("get_old_passwords", 1);
+
+	std::vector<credentials_t*> records;
+	for (size_t i = 0; i < shape.credentials; i++)
+		records.push_back(session.get_credentials(get_site_name(i)));
+
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < records.size(); i++)
+		records.at(i)->set_key(BENCHMARK_KEY "-new", key);
+	record("set_key", records.size());
+
+	for (size_t i = 0; i < records.size(); i++)	// Back to the session's key, so the vault stays readable
+		records.at(i)->set_key(key, BENCHMARK_KEY "-new");
+
+	start = std::chrono::steady_clock::now();
+	session.store(BENCHMARK_CREDENTIALS_FILENAME);
+	record("store", 1);
+
+	commit_sync = false;	// The same save without waiting on the disk, to show what durability costs
+	start = std::chrono::steady_clock::now();
+	session.store(BENCHMARK_CREDENTIALS_FILENAME);
+	record("store_without_sync", 1);
+	commit_sync = true;
+
+	return out;
+}
+
+/*
+	Time the kernels under the session's operations on their own, with as many iterations as the vault has records
+*/
+std::vector<benchmark_result_t> run_kernel_benchmarks(vault_shape_t shape)
+{
+	std::vector<benchmark_result_t> out;
+	std::mt19937_64 random(shape.seed + 2);
+	std::chrono::steady_clock::time_point start;
+	volatile size_t matches = 0;	// Keeps searches whose results are otherwise unused from being optimized away
+
+	std::function<void(std::string, unsigned long)> record = [&](std::string operation, unsigned long iterations)
+	{
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		out.push_back(benchmark_result_t{ operation, shape.credentials, iterations, seconds });
+	};
+
+	std::vector<std::string> haystacks;
+	for (size_t i = 0; i < shape.credentials; i++)
+		haystacks.push_back(get_site_name(i));
+
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < haystacks.size(); i++)
+		matches = matches + lowercase_contains(haystacks.at(i), "EXAMPLE96.NET");	// Never found, so every position is tried
+	record("lowercase_contains_short", haystacks.size());
+
+	haystacks.clear();
+	for (unsigned int i = 0; i < BENCHMARK_LONG_HAYSTACKS; i++)
+		haystacks.push_back(get_random_string(random, BENCHMARK_LONG_HAYSTACK_LENGTH));
+
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < shape.credentials; i++)
+		matches = matches + lowercase_contains(haystacks.at(i % haystacks.size()), "Example~Site");	// Random strings never hold a tilde
+	record("lowercase_contains_long", shape.credentials);
+
+	bool wordlist_written = false;
+	if (!std::ifstream(DEFAULT_WORDLIST_FILENAME).is_open())
+	{
+		std::ofstream wordlist(DEFAULT_WORDLIST_FILENAME, std::ios::trunc);
+		for (unsigned int i = 0; i < BENCHMARK_WORDLIST_SIZE; i++)
+			wordlist << get_random_string(random, 3 + random() % 6) << std::endl;
+		wordlist_written = true;
+	}
+
+	generator_t generators[] = { generator_t(generator_t::RANDOM), generator_t(generator_t::PRONOUNCEABLE), generator_t(generator_t::DICEWARE, BENCHMARK_DICEWARE_WORDS) };
+	const char* names[] = { "generate_random", "generate_pronounceable", "generate_diceware" };
+
+	for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+	{
+		generators[i].is_valid();	// Loads the word list, so it isn't timed
+		start = std::chrono::steady_clock::now();
+		std::vector<std::string> passwords = generators[i].generate(shape.credentials);
+		if (!passwords.empty())	// Nothing is generated if the word list couldn't be read
+			record(names[i], passwords.size());
+	}
+
+	if (wordlist_written)
+		std::remove(DEFAULT_WORDLIST_FILENAME);
+
+	return out;
+}
+
+/*
+	Run a recorded workload at full speed against the generated vault, timing every operation. Site-name aliases first seen in an add or a rename stand for new credentials and keep their alias as a name; the others are mapped to credentials already in the vault. Security-level aliases are mapped onto the generated levels, and redacted text is replaced by random text of the same length.
+*/
+std::vector<replay_result_t> replay_workload(vault_shape_t shape, const std::vector<workload_operation_t>& workload)
+{
+	std::mt19937_64 random(shape.seed + 2);
+	std::map<std::string, std::string> names;
+	std::map<std::string, unsigned int> types;	// Index of each operation type's result
+	std::vector<replay_result_t> out(1, replay_result_t{ "all", shape.credentials, {} });
+
+	std::function<std::string(const std::string&, bool)> name = [&](const std::string& alias, bool created)
+	{
+		std::map<std::string, std::string>::iterator it = names.find(alias);
+		if (it == names.end())
+			it = names.emplace(alias, created ? alias : get_site_name(random() % shape.credentials)).first;
+
+		return it->second;
+	};
+
+	std::function<std::string(const std::string&)> level = [&](const std::string& alias)
+	{
+		if (alias.compare(0, 5, "level") != 0 || alias.length() == 5)
+			return alias;
+
+		return "L" + std::to_string((std::stoul(alias.substr(5)) - 1) % shape.seclevels);
+	};
+
+	std::function<std::string(const std::string&)> text = [&](const std::string& redacted)
+	{
+		if (redacted.empty() || redacted[0] != WORKLOAD_SECRET)
+			return redacted;
+
+		return get_random_string(random, std::stoul(redacted.substr(1)));
+	};
+
+	std::function<std::string(const std::string&)> query = [&](const std::string& recorded)
+	{
+		std::vector<std::string> words = tokenize(recorded);
+		std::string out;
+
+		for (unsigned int i = 0; i < words.size(); i++)
+		{
+			size_t colon = words.at(i).find(':');
+			std::string field = colon == std::string::npos ? std::string() : words.at(i).substr(0, colon + 1);
+			std::string value = colon == std::string::npos ? words.at(i) : words.at(i).substr(colon + 1);
+
+			out += (i ? " " : "") + field + (field == "level:" ? level(value) : text(value));
+		}
+
+		return out;
+	};
+
+	session_t session(BENCHMARK_KEY, BENCHMARK_KEYSTORE_FILENAME, BENCHMARK_SECLEVEL_FILENAME);
+	session.read(BENCHMARK_CREDENTIALS_FILENAME);
+
+	std::chrono::steady_clock::time_point replay_start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < workload.size(); i++)
+	{
+		const std::string& operation = workload.at(i).operation;
+		const std::vector<std::string>& arguments = workload.at(i).arguments;
+		std::vector<std::string> values;
+
+		for (unsigned int j = 1; j < arguments.size(); j++)	// Everything after the first argument, as redacted text
+			values.push_back(text(arguments.at(j)));
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		if (operation == "add_credentials" && arguments.size() >= 3)
+			session.add_credentials(name(arguments.at(0), true), values.at(0), values.at(1), arguments.size() > 3 ? session.find_seclevel(level(arguments.at(3))) : nullptr);
+		else if (operation == "modify_credentials" && arguments.size() == 3)
+		{
+			std::string value = arguments.at(1) == "n" ? name(arguments.at(2), true) : arguments.at(1) == "l" ? level(arguments.at(2)) : values.at(1);
+			session.modify_credentials(name(arguments.at(0), false), arguments.at(1), value);
+		}
+		else if (operation == "set_security_level" && !arguments.empty())
+		{
+			std::vector<std::string> members;
+			for (unsigned int j = 1; j < arguments.size(); j++)
+				members.push_back(name(arguments.at(j), false));
+
+			session.set_security_level(level(arguments.at(0)), members);
+		}
+		else if (operation == "add_questions" && !arguments.empty())
+		{
+			std::vector<std::pair<std::string, std::string>> questions;
+			for (unsigned int j = 0; j + 1 < values.size(); j += 2)
+				questions.push_back(std::make_pair(values.at(j), values.at(j + 1)));
+
+			session.add_questions(name(arguments.at(0), false), questions);
+		}
+		else if (operation == "delete_questions" && !arguments.empty())
+			session.delete_questions(name(arguments.at(0), false), values);
+		else if (operation == "add_backups" && !arguments.empty())
+			session.add_backups(name(arguments.at(0), false), values);
+		else if (operation == "delete_backups" && !arguments.empty())
+			session.delete_backups(name(arguments.at(0), false), values);
+		else if (operation == "delete_question" && arguments.size() == 2)
+			session.delete_question(name(arguments.at(0), false), std::stoi(arguments.at(1)));
+		else if (operation == "delete_backup" && arguments.size() == 2)
+			session.delete_backup(name(arguments.at(0), false), std::stoi(arguments.at(1)));
+		else if (operation == "delete_credentials" && arguments.size() == 1)
+			session.delete_credentials(name(arguments.at(0), false));
+		else if (operation == "delete_credentials")
+		{
+			std::vector<std::string> doomed;
+			for (unsigned int j = 0; j < arguments.size(); j++)
+				doomed.push_back(name(arguments.at(j), false));
+
+			session.delete_credentials(doomed);
+		}
+		else if (operation == "set_key" && arguments.size() == 1)
+			session.set_key(text(arguments.at(0)));
+		else if (operation == "rotate_seclevel" && arguments.size() == 1)
+			session.rotate_seclevel(level(arguments.at(0)));
+		else if (operation == "print_credentials")
+			session.print_credentials();
+		else if (operation == "print_questions" && arguments.size() == 1)
+			session.print_questions(name(arguments.at(0), false));
+		else if (operation == "print_backups" && arguments.size() == 1)
+			session.print_backups(name(arguments.at(0), false));
+		else if (operation == "print_seclevels")
+			session.print_seclevels();
+		else if (operation == "search_credentials" && arguments.size() == 1)
+			session.search_credentials(query(arguments.at(0)));
+		else if (operation == "fuzzy_search_credentials" && arguments.size() == 1)
+			session.fuzzy_search_credentials(text(arguments.at(0)));
+		else if (operation == "audit_credentials")
+			session.audit_credentials();
+		else if (operation == "store")
+			session.store(BENCHMARK_CREDENTIALS_FILENAME);
+		else
+		{
+			std::cerr << "Skipping unknown operation " << operation << std::endl;
+			continue;
+		}
+
+		double latency = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+		std::map<std::string, unsigned int>::iterator type = types.find(operation);
+		if (type == types.end())
+		{
+			type = types.emplace(operation, out.size()).first;
+			out.push_back(replay_result_t{ operation, shape.credentials, {} });
+		}
+
+		out.front().latencies.push_back(latency);
+		out.at(type->second).latencies.push_back(latency);
+	}
+
+	out.front().seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replay_start).count();
+	for (unsigned int i = 1; i < out.size(); i++)
+		out.at(i).seconds = std::accumulate(out.at(i).latencies.begin(), out.at(i).latencies.end(), 0.0) / 1e6;
+
+	return out;
+}
+
+/*
+	Write results as CSV, with a header row, or as a JSON array
+*/
+void write_results(std::vector<benchmark_result_t> results, bool json, std::ostream& output)
+{
+	std::string buffer;
+
+	if (json)
+	{
+		json_writer_t writer(buffer, &output);
+
+		writer.begin_array();
+		for (unsigned int i = 0; i < results.size(); i++)
+		{
+			writer.begin_object();
+			writer.key("operation").value(results.at(i).operation);
+			writer.key("records").value(static_cast<long long>(results.at(i).records));
+			writer.key("iterations").value(static_cast<long long>(results.at(i).iterations));
+			writer.key("microseconds").value(results.at(i).seconds * 1e6);
+			writer.key("microseconds_per_iteration").value(results.at(i).seconds * 1e6 / results.at(i).iterations);
+			writer.end_object();
+		}
+		writer.end_array();
+		writer.end_line();
+		return;
+	}
+
+	output << "operation,records,iterations,seconds,microseconds_per_iteration\n";
+	for (unsigned int i = 0; i < results.size(); i++)
+	{
+		char line[256];
+		std::snprintf(line, sizeof(line), "%s,%zu,%lu,%.6f,%.3f\n", results.at(i).operation.c_str(), results.at(i).records, results.at(i).iterations,
+			results.at(i).seconds, results.at(i).seconds * 1e6 / results.at(i).iterations);
+		output << line;
+	}
+	output.flush();
+}
+
+/*
+	Write the count, throughput, and latency percentiles of each type of replayed operation, as CSV with a header row or as a JSON array. The row for all operations gives the rate the whole workload ran at, and the other rows the rate of their type alone.
+*/
+void write_replay_results(std::vector<replay_result_t> results, bool json, std::ostream& output)
+{
+	std::string buffer;
+	json_writer_t writer(buffer, &output);
+
+	if (json)
+		writer.begin_array();
+	else
+		output << "operation,records,count,seconds,operations_per_second,p50_us,p90_us,p99_us,max_us\n";
+
+	for (unsigned int i = 0; i < results.size(); i++)
+	{
+		std::vector<double>& latencies = results.at(i).latencies;
+		std::sort(latencies.begin(), latencies.end());
+
+		std::function<double(double)> percentile = [&](double fraction)
+		{
+			size_t rank = static_cast<size_t>(std::ceil(fraction * latencies.size()));	// Nearest rank
+			return latencies.empty() ? 0 : latencies.at(rank > 0 ? rank - 1 : 0);
+		};
+		double rate = results.at(i).seconds > 0 ? latencies.size() / results.at(i).seconds : 0;
+
+		if (json)
+		{
+			writer.begin_object();
+			writer.key("operation").value(results.at(i).operation);
+			writer.key("records").value(static_cast<long long>(results.at(i).records));
+			writer.key("count").value(static_cast<long long>(latencies.size()));
+			writer.key("seconds").value(results.at(i).seconds);
+			writer.key("operations_per_second").value(rate);
+			writer.key("p50_microseconds").value(percentile(0.50));
+			writer.key("p90_microseconds").value(percentile(0.90));
+			writer.key("p99_microseconds").value(percentile(0.99));
+			writer.key("max_microseconds").value(latencies.empty() ? 0 : latencies.back());
+			writer.end_object();
+			continue;
+		}
+
+		char line[512];
+		std::snprintf(line, sizeof(line), "%s,%zu,%zu,%.6f,%.1f,%.3f,%.3f,%.3f,%.3f\n", results.at(i).operation.c_str(), results.at(i).records, latencies.size(),
+			results.at(i).seconds, rate, percentile(0.50), percentile(0.90), percentile(0.99), latencies.empty() ? 0 : latencies.back());
+		output << line;
+	}
+
+	if (json)
+	{
+		writer.end_array();
+		writer.end_line();
+	}
+	output.flush();
+}
+
+/*
+	Read microseconds per iteration by operation and record count from a CSV written by an earlier run
+*/
+std::map<std::pair<std::string, size_t>, double> read_baseline(std::string filename)
+{
+	std::map<std::pair<std::string, size_t>, double> out;
+	std::ifstream file(filename);
+	std::string line;
+
+	std::getline(file, line);	// Header
+	while (std::getline(file, line))
+	{
+		std::vector<std::string> fields;
+		std::stringstream row(line);
+		std::string field;
+
+		while (std::getline(row, field, ','))
+			fields.push_back(field);
+
+		if (fields.size() == 5)
+			out[std::make_pair(fields.at(0), std::stoul(fields.at(1)))] = std::stod(fields.at(4));
+	}
+
+	return out;
+}
+
+/*
+	Report each result against the baseline on standard error and return 1 if any is slower by more than the threshold
+*/
+int compare_results(std::vector<benchmark_result_t> results, std::map<std::pair<std::string, size_t>, double> baseline, double threshold)
+{
+	int out = 0;
+
+	for (unsigned int i = 0; i < results.size(); i++)
+	{
+		std::map<std::pair<std::string, size_t>, double>::iterator it = baseline.find(std::make_pair(results.at(i).operation, results.at(i).records));
+		if (it == baseline.end() || it->second <= 0)
+			continue;
+
+		double current = results.at(i).seconds * 1e6 / results.at(i).iterations;
+		double change = current / it->second - 1;
+		bool regressed = change > threshold;
+		char line[256];
+
+		std::snprintf(line, sizeof(line), "%-20s %9zu %12.3f us %12.3f us %+7.1f%%%s\n", results.at(i).operation.c_str(), results.at(i).records,
+			it->second, current, change * 100, regressed ? "  REGRESSION" : "");
+		std::cerr << line;
+
+		if (regressed)
+			out = 1;
+	}
+
+	return out;
+}
\ No newline at end of file
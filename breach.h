@@ -0,0 +1,335 @@
+#pragma once
+
+#include <fstream>
+#include <vector>
+#include "mapped.h"
+#include "digest.h"
+
+#define BREACH_SCAN_WINDOW 4096	// Bytes of corpus below which the search reads lines one by one
+#define BLOOM_EXTENSION ".bloom"
+#define BLOOM_MAGIC "PMBLOOM1"
+#define BLOOM_HEADER_LENGTH 24	// Magic, number of bits, number of hashes, and padding
+#define BLOOM_BITS_PER_HASH 10	// About a 1% false-positive rate
+#define BLOOM_HASH_COUNT 7
+
+/*
+	A sorted corpus of breached password hashes in the downloadable Have I Been Pwned format, with one "HASH:COUNT" line per password. SHA-1 and NTLM corpora are both accepted and told apart by the length of their hashes.
+*/
+class breach_corpus_t
+{
+	mapped_file_t corpus;
+	mapped_file_t bloom;	// Optional filter next to the corpus, which rules out most passwords without touching it
+	size_t hash_length;	// Hex digits per hash
+	uint64_t bloom_bits;
+	uint32_t bloom_hashes;
+
+	size_t line_start(size_t);
+	size_t next_line(size_t);
+	int compare(size_t, const std::string&);
+	uint64_t get_key(const char*);
+	unsigned int get_count(size_t);
+	bool bloom_contains(const std::string&);
+
+	static int hex_value(char);
+	static void get_bloom_indexes(const char*, uint64_t, uint32_t, uint64_t[]);
+
+	public:
+	bool open(std::string);
+	bool is_open();
+	bool has_bloom();
+	size_t get_size();
+
+	std::string hash(std::string);
+	unsigned int count(std::string);
+	unsigned int count_hash(const std::string&);
+
+	static bool build_bloom(std::string);
+};
+
+/*
+	Offset of the first line that starts at or after an offset
+*/
+size_t breach_corpus_t::line_start(size_t offset)
+{
+	const char* data = corpus.get_data();
+	size_t size = corpus.get_size();
+
+	if (offset == 0 || offset >= size || data[offset - 1] == '\n')
+		return std::min(offset, size);
+
+	const char* newline = static_cast<const char*>(std::memchr(data + offset, '\n', size - offset));
+	return newline ? newline - data + 1 : size;
+}
+
+/*
+	Offset of the line after the line starting at an offset
+*/
+size_t breach_corpus_t::next_line(size_t offset)
+{
+	return line_start(offset + 1);
+}
+
+/*
+	Compare the hash on a line with a hash, ignoring case
+*/
+int breach_corpus_t::compare(size_t line, const std::string& hash)
+{
+	const char* data = corpus.get_data() + line;
+	size_t available = corpus.get_size() - line;
+
+	for (size_t i = 0; i < hash_length; i++)
+	{
+		if (i >= available)
+			return -1;
+
+		char c = std::toupper((unsigned char)data[i]);
+		if (c != hash[i])
+			return c < hash[i] ? -1 : 1;
+	}
+
+	return 0;
+}
+
+/*
+	The first 16 hex digits of a hash as a number, for estimating where in the corpus it lies
+*/
+uint64_t breach_corpus_t::get_key(const char* hex)
+{
+	uint64_t out = 0;
+
+	for (int i = 0; i < 16; i++)
+		out = out << 4 | hex_value(hex[i]);
+
+	return out;
+}
+
+unsigned int breach_corpus_t::get_count(size_t line)
+{
+	const char* data = corpus.get_data();
+	size_t i = line + hash_length;
+
+	if (i >= corpus.get_size() || data[i] != ':')	// Corpora without counts count each hash once
+		return 1;
+
+	unsigned int out = 0;
+	for (i++; i < corpus.get_size() && data[i] >= '0' && data[i] <= '9'; i++)
+		out = out * 10 + (data[i] - '0');
+
+	return out;
+}
+
+bool breach_corpus_t::bloom_contains(const std::string& hash)
+{
+	const uint8_t* bits = reinterpret_cast<const uint8_t*>(bloom.get_data()) + BLOOM_HEADER_LENGTH;
+	uint64_t indexes[BLOOM_HASH_COUNT];
+
+	get_bloom_indexes(hash.c_str(), bloom_bits, bloom_hashes, indexes);
+
+	for (uint32_t i = 0; i < bloom_hashes; i++)
+		if (!(bits[indexes[i] / 8] & (1 << indexes[i] % 8)))
+			return false;
+
+	return true;
+}
+
+int breach_corpus_t::hex_value(char c)
+{
+	return c >= '0' && c <= '9' ? c - '0' : c >= 'A' && c <= 'F' ? c - 'A' + 10 : c >= 'a' && c <= 'f' ? c - 'a' + 10 : 0;
+}
+
+/*
+	Bit positions for a hash, derived from its first 32 hex digits by double hashing. The hashes are already uniformly distributed, so no further mixing is needed.
+*/
+void breach_corpus_t::get_bloom_indexes(const char* hex, uint64_t bits, uint32_t hashes, uint64_t out[])
+{
+	uint64_t h1 = 0, h2 = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		h1 = h1 << 4 | hex_value(hex[i]);
+		h2 = h2 << 4 | hex_value(hex[i + 16]);
+	}
+
+	h2 |= 1;	// Odd steps visit distinct positions
+	for (uint32_t i = 0; i < hashes; i++)
+		out[i] = (h1 + i * h2) % bits;
+}
+
+/*
+	Map a corpus, and its Bloom filter if one has been built
+*/
+bool breach_corpus_t::open(std::string filename)
+{
+	bloom.close();
+	if (!corpus.open(filename, true))
+		return false;
+
+	const char* data = corpus.get_data();
+	for (hash_length = 0; hash_length < corpus.get_size() && std::isxdigit((unsigned char)data[hash_length]); hash_length++) {}
+
+	if (hash_length != SHA1_LENGTH * 2 && hash_length != NTLM_LENGTH * 2)
+	{
+		corpus.close();
+		return false;
+	}
+
+	if (bloom.open(filename + BLOOM_EXTENSION, true))
+	{
+		const char* header = bloom.get_data();
+		bloom_bits = 0;
+		bloom_hashes = 0;
+
+		if (bloom.get_size() >= BLOOM_HEADER_LENGTH)
+		{
+			std::memcpy(&bloom_bits, header + 8, sizeof(bloom_bits));
+			std::memcpy(&bloom_hashes, header + 16, sizeof(bloom_hashes));
+		}
+
+		if (bloom.get_size() < BLOOM_HEADER_LENGTH || std::memcmp(header, BLOOM_MAGIC, 8) || bloom_bits == 0 || bloom_hashes > BLOOM_HASH_COUNT || bloom.get_size() < BLOOM_HEADER_LENGTH + (bloom_bits + 7) / 8)
+			bloom.close();	// Not a usable filter, so go without
+	}
+
+	return true;
+}
+
+bool breach_corpus_t::is_open()
+{
+	return corpus.is_open();
+}
+
+bool breach_corpus_t::has_bloom()
+{
+	return bloom.is_open();
+}
+
+size_t breach_corpus_t::get_size()
+{
+	return corpus.get_size();
+}
+
+/*
+	Hash a password the way the corpus does
+*/
+std::string breach_corpus_t::hash(std::string password)
+{
+	return hash_length == NTLM_LENGTH * 2 ? ntlm_hex(password) : sha1_hex(password);
+}
+
+/*
+	Return how many times a password appears in breaches, or 0 if it doesn't
+*/
+unsigned int breach_corpus_t::count(std::string password)
+{
+	return is_open() ? count_hash(hash(password)) : 0;
+}
+
+/*
+	Look up an uppercase hash. Hashes are uniformly distributed, so the search interpolates on the value of the hash to land within a page or two of its line, falling back to halving whenever a guess doesn't at least halve the range.
+*/
+unsigned int breach_corpus_t::count_hash(const std::string& hash)
+{
+	if (has_bloom() && !bloom_contains(hash))
+		return 0;
+
+	size_t lo = 0, hi = corpus.get_size();	// The line with the hash, if any, starts in [lo, hi), and lo is always a line start
+	uint64_t lo_key = 0, hi_key = UINT64_MAX;
+	uint64_t target = get_key(hash.c_str());
+	bool bisect = false;
+
+	while (hi - lo > BREACH_SCAN_WINDOW)
+	{
+		size_t probe = lo + (hi - lo) / 2;
+		if (!bisect && hi_key > lo_key)
+			probe = lo + (size_t)((double)(target - lo_key) / (double)(hi_key - lo_key) * (hi - lo));
+
+		size_t line = line_start(std::min(probe, hi - 1));
+		if (line >= hi)	// The guess landed on the last line of the range
+		{
+			if (bisect)
+				break;
+
+			bisect = true;
+			continue;
+		}
+
+		size_t range = hi - lo;
+		int order = compare(line, hash);
+
+		if (order == 0)
+			return get_count(line);
+		if (order < 0)
+		{
+			lo = next_line(line);
+			lo_key = get_key(corpus.get_data() + line);
+		}
+		else
+		{
+			hi = line;
+			hi_key = get_key(corpus.get_data() + line);
+		}
+
+		bisect = !bisect && hi - lo > range / 2;
+	}
+
+	for (size_t line = lo; line < hi; line = next_line(line))
+	{
+		int order = compare(line, hash);
+
+		if (order == 0)
+			return get_count(line);
+		if (order > 0)
+			break;
+	}
+
+	return 0;
+}
+
+/*
+	Build a Bloom filter for a corpus and save it next to the corpus
+*/
+bool breach_corpus_t::build_bloom(std::string filename)
+{
+	breach_corpus_t source;
+	if (!source.open(filename))
+		return false;
+
+	const char* data = source.corpus.get_data();
+	size_t size = source.corpus.get_size();
+
+	uint64_t lines = 0;
+	for (size_t line = 0; line < size; line = source.next_line(line))
+		lines++;
+
+	uint64_t bits = std::max<uint64_t>(64, lines * BLOOM_BITS_PER_HASH);
+	std::vector<uint8_t> filter((bits + 7) / 8);
+	uint64_t indexes[BLOOM_HASH_COUNT];
+	std::string hash;
+
+	for (size_t line = 0; line < size; line = source.next_line(line))
+	{
+		if (size - line < source.hash_length)
+			break;
+
+		hash.assign(data + line, source.hash_length);
+		for (size_t i = 0; i < hash.length(); i++)
+			hash[i] = std::toupper((unsigned char)hash[i]);
+		hash.resize(32, '0');	// NTLM hashes are exactly 32 digits and SHA-1 hashes are longer
+
+		get_bloom_indexes(hash.c_str(), bits, BLOOM_HASH_COUNT, indexes);
+		for (uint32_t i = 0; i < BLOOM_HASH_COUNT; i++)
+			filter[indexes[i] / 8] |= 1 << indexes[i] % 8;
+	}
+
+	std::ofstream file(filename + BLOOM_EXTENSION, std::ios::trunc | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	uint32_t hashes = BLOOM_HASH_COUNT, padding = 0;
+	file.write(BLOOM_MAGIC, 8);
+	file.write(reinterpret_cast<const char*>(&bits), sizeof(bits));
+	file.write(reinterpret_cast<const char*>(&hashes), sizeof(hashes));
+	file.write(reinterpret_cast<const char*>(&padding), sizeof(padding));
+	file.write(reinterpret_cast<const char*>(filter.data()), filter.size());
+
+	return file.good();
+}
\ No newline at end of file
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "storage.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX	// Keep windows.h from defining min and max macros
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define TEMPORARY_EXTENSION ".tmp"	// Added to a file's name while its next version is written
+#define COMMIT_BUFFER_SIZE (1 << 20)	// Bytes of output buffered per file, so a vault is written in large blocks
+#define GENERATION 'E'	// Group code of the trailer that ends every committed file, holding the generation of the commit that wrote it. Readers stop at it, since the generation's bytes could pass for a group separator and code.
+#define GENERATION_TRAILER_SIZE (2 + sizeof(int))	// Group separator, group code, and generation
+
+bool commit_sync = true;	// Whether commits wait for their files to reach the disk; only turned off to measure what that costs
+
+/*
+	Replaces a set of files as one change. Each file is written under a temporary name with a trailer holding the commit's generation, and every temporary is synced before any is renamed over its file. If the program stops partway through the renames, recover_commit() finishes them the next time the files are opened, because temporaries whose generation already appears on a renamed file are known to be complete.
+*/
+class commit_t
+{
+	struct staged_t
+	{
+		std::string filename;
+		std::ofstream file;
+		std::unique_ptr<char[]> buffer;
+	};
+
+	std::vector<std::unique_ptr<staged_t>> staged;
+	int generation;
+	bool done = false;
+
+	public:
+	commit_t();
+	commit_t(const commit_t&) = delete;
+	commit_t& operator=(const commit_t&) = delete;
+	~commit_t();
+
+	std::ofstream& stage(std::string);
+	bool commit();
+	void abort();
+
+	int get_generation();
+};
+
+int& get_last_generation();
+int read_generation(std::string);
+std::string get_directory(std::string);
+bool sync_file(std::string);
+bool sync_directory(std::string);
+bool replace_file(std::string, std::string);
+bool recover_commit(std::vector<std::string>);
+
+/*
+	Generation of the newest commit read or written, which the next commit goes one past
+*/
+int& get_last_generation()
+{
+	static int generation = 0;
+	return generation;
+}
+
+/*
+	Read the generation from the trailer at the end of a file, or return -1 if the file is missing or was written before generations existed
+*/
+int read_generation(std::string filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open())
+		return -1;
+
+	file.seekg(0, std::ios::end);
+	if (file.tellg() < static_cast<std::streamoff>(GENERATION_TRAILER_SIZE))
+		return -1;
+
+	char separator, code;
+	int generation;
+
+	file.seekg(-static_cast<std::streamoff>(GENERATION_TRAILER_SIZE), std::ios::end);
+	storage::read(separator, file);
+	storage::read(code, file);
+	storage::read(generation, file);
+
+	return file && separator == GROUP_SEPARATOR && code == GENERATION ? generation : -1;
+}
+
+/*
+	Flush a file's data from the system's cache to the disk
+*/
+bool sync_file(std::string filename)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	bool out = FlushFileBuffers(file);
+	CloseHandle(file);
+	return out;
+#else
+	int file = ::open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	bool out = fsync(file) == 0;
+	::close(file);
+	return out;
+#endif
+}
+
+/*
+	Directory holding a file
+*/
+std::string get_directory(std::string filename)
+{
+	size_t slash = filename.find_last_of("/\\");
+
+	if (slash == std::string::npos)
+		return ".";
+	return slash == 0 ? filename.substr(0, 1) : filename.substr(0, slash);
+}
+
+/*
+	Flush a directory, so that renames within it survive a crash. Windows writes renames through to the disk itself.
+*/
+bool sync_directory(std::string directory)
+{
+#ifdef _WIN32
+	return true;
+#else
+	int file = ::open(directory.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	bool out = fsync(file) == 0;
+	::close(file);
+	return out;
+#endif
+}
+
+/*
+	Rename a file over another in one step
+*/
+bool replace_file(std::string from, std::string to)
+{
+#ifdef _WIN32
+	return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+	return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+/*
+	Finish what an interrupted commit left behind among a set of files that are committed together. A temporary is renamed into place if another file in the set already carries its generation, since that file was only renamed after every temporary was synced. A temporary no newer than its own file is stale and deleted. Any other temporary is left alone, as it may still be being written, or belong to a commit whose other files are not in the set. The newest generation found is remembered for the next commit. Returns whether any file was replaced.
+*/
+bool recover_commit(std::vector<std::string> filenames)
+{
+	bool out = false;
+	std::vector<int> generations;
+	int newest = -1;
+
+	for (unsigned int i = 0; i < filenames.size(); i++)
+	{
+		generations.push_back(read_generation(filenames.at(i)));
+		newest = std::max(newest, generations.back());
+	}
+
+	for (unsigned int i = 0; i < filenames.size(); i++)
+	{
+		std::string temporary = filenames.at(i) + TEMPORARY_EXTENSION;
+		int generation = read_generation(temporary);
+
+		if (generation >= 0 && generation == newest && generation != generations.at(i))
+		{
+			if (replace_file(temporary, filenames.at(i)))
+			{
+				if (commit_sync)
+					sync_directory(get_directory(filenames.at(i)));
+				out = true;
+			}
+		}
+		else if (generation >= 0 && generation <= generations.at(i))
+			std::remove(temporary.c_str());
+	}
+
+	get_last_generation() = std::max(get_last_generation(), newest);
+	return out;
+}
+
+commit_t::commit_t()
+{
+	generation = get_last_generation() + 1;
+}
+
+/*
+	Discard the temporaries of a commit that was never made
+*/
+commit_t::~commit_t()
+{
+	if (!done)
+		abort();
+}
+
+/*
+	Open a temporary to write the next version of a file to
+*/
+std::ofstream& commit_t::stage(std::string filename)
+{
+	staged.push_back(std::unique_ptr<staged_t>(new staged_t()));
+	staged_t& entry = *staged.back();
+
+	entry.filename = filename;
+	entry.buffer.reset(new char[COMMIT_BUFFER_SIZE]);
+	entry.file.rdbuf()->pubsetbuf(entry.buffer.get(), COMMIT_BUFFER_SIZE);	// Has to come before the file is opened to take effect
+	entry.file.open(filename + TEMPORARY_EXTENSION, std::ios::trunc | std::ios::binary);
+
+	return entry.file;
+}
+
+/*
+	Finish every staged file with the generation trailer, sync them all, then rename each over its file and sync the directories. Nothing is renamed unless every file was written and synced, so a failure leaves the old files as they were.
+*/
+bool commit_t::commit()
+{
+	done = true;
+
+	for (unsigned int i = 0; i < staged.size(); i++)
+	{
+		std::ofstream& file = staged.at(i)->file;
+
+		storage::store_gs(GENERATION, file);
+		storage::store(generation, file);
+		file.close();
+
+		if (file.fail() || (commit_sync && !sync_file(staged.at(i)->filename + TEMPORARY_EXTENSION)))
+		{
+			abort();
+			return false;
+		}
+	}
+
+	bool out = true;
+	std::vector<std::string> directories;
+
+	for (unsigned int i = 0; i < staged.size(); i++)
+	{
+		out = replace_file(staged.at(i)->filename + TEMPORARY_EXTENSION, staged.at(i)->filename) && out;
+
+		std::string directory = get_directory(staged.at(i)->filename);
+		if (std::find(directories.begin(), directories.end(), directory) == directories.end())
+			directories.push_back(directory);
+	}
+
+	for (unsigned int i = 0; commit_sync && i < directories.size(); i++)
+		out = sync_directory(directories.at(i)) && out;
+
+	if (out)
+		get_last_generation() = generation;
+
+	return out;
+}
+
+/*
+	Close and delete every temporary
+*/
+void commit_t::abort()
+{
+	done = true;
+
+	for (unsigned int i = 0; i < staged.size(); i++)
+	{
+		if (staged.at(i)->file.is_open())
+			staged.at(i)->file.close();
+		std::remove((staged.at(i)->filename + TEMPORARY_EXTENSION).c_str());
+	}
+}
+
+int commit_t::get_generation()
+{
+	return generation;
+}
\ No newline at end of file
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include "storage.h"
+#include "print.h"
+
+/*
+	A calendar date stored as the number of days since 1970/01/01
+*/
+class date_t
+{
+	enum unit_code
+	{
+		TIME = 'T',	// YYYY/MM/DD string, as written by older versions. Dates they stamped themselves hold the raw std::tm fields: years since 1900 and months from 0.
+		DAYS = 'D'
+	};
+
+	int32_t days = 0;
+
+	constexpr explicit date_t(int32_t days) : days(days) {}
+
+	static bool parse_fields(const std::string&, int&, int&, int&);
+
+	public:
+	struct civil_t
+	{
+		int year;
+		int month;	// 1 to 12
+		int day;	// 1 to 31
+	};
+
+	constexpr date_t() {}
+	constexpr date_t(int, int, int);
+	date_t(std::string);
+	date_t(std::ifstream&);
+
+	static bool parse(std::string, date_t&);
+	static date_t from_legacy(std::string);
+	static date_t today();
+	static constexpr int days_in_month(int, int);
+
+	constexpr civil_t to_civil() const;
+	constexpr int32_t get_days() const { return days; }
+	constexpr date_t add_months(int) const;
+	constexpr int months_since(date_t) const;
+
+	constexpr bool operator==(date_t other) const { return days == other.days; }
+	constexpr bool operator!=(date_t other) const { return days != other.days; }
+	constexpr bool operator<(date_t other) const { return days < other.days; }
+	constexpr bool operator<=(date_t other) const { return days <= other.days; }
+	constexpr bool operator>(date_t other) const { return days > other.days; }
+	constexpr bool operator>=(date_t other) const { return days >= other.days; }
+
+	std::string to_string() const;
+	void print(std::ostream&, bool = true);
+	void store(std::ofstream&);
+};
+
+/*
+	Days since 1970/01/01 of a proleptic Gregorian date, counting years in 400-year eras that start on March 1 so that leap days fall at the end of each year
+*/
+constexpr date_t::date_t(int year, int month, int day)
+{
+	year -= month <= 2;
+	int era = (year >= 0 ? year : year - 399) / 400;
+	int year_of_era = year - era * 400;	// 0 to 399
+	int day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;	// 0 to 365, from March 1
+	int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;	// 0 to 146096
+
+	days = era * 146097 + day_of_era - 719468;
+}
+
+/*
+	Convert a YYYY/MM/DD-formatted string to a date, leaving it at 1970/01/01 if the string isn't a valid date
+*/
+date_t::date_t(std::string str)
+{
+	parse(str, *this);
+}
+
+/*
+	Read the year, month, and day digits of a YYYY/MM/DD string, which may also be separated by dashes, without checking their ranges
+*/
+bool date_t::parse_fields(const std::string& str, int& year, int& month, int& day)
+{
+	if (str.length() != 10 || (str[4] != '/' && str[4] != '-') || str[7] != str[4])
+		return false;
+
+	for (unsigned int i = 0; i < str.length(); i++)
+		if (i != 4 && i != 7 && !std::isdigit(static_cast<unsigned char>(str[i])))
+			return false;
+
+	year = std::stoi(str.substr(0, 4));
+	month = std::stoi(str.substr(5, 2));
+	day = std::stoi(str.substr(8, 2));
+	return true;
+}
+
+/*
+	Convert a YYYY/MM/DD-formatted string to a date, returning false without touching out if it isn't a real calendar date
+*/
+bool date_t::parse(std::string str, date_t& out)
+{
+	int year, month, day;
+
+	if (!parse_fields(str, year, month, day) || month < 1 || month > 12 || day < 1 || day > days_in_month(year, month))
+		return false;
+
+	out = date_t(year, month, day);
+	return true;
+}
+
+date_t::date_t(std::ifstream& input)
+{
+	if (input.is_open())
+	{
+		char unit_code;
+		while (!storage::is_eor(input) && storage::read_unit(unit_code, input))	// Read next unit code
+		{
+			std::string str_time;
+			int n;
+			switch (unit_code)
+			{
+				case TIME:
+					storage::read(str_time, input);
+					*this = from_legacy(str_time);
+					break;
+				case DAYS:
+					storage::read(n, input);
+					days = n;
+			}
+		}
+
+		storage::consume_rs(input);
+	}
+}
+
+/*
+	Convert a date written by an older version. Those versions stamped password changes with today's std::tm fields unconverted, so a year below 1900 counts from 1900 and its month from 0, as in 0126/00/15 for 2026/01/15. Dates entered by the user were stored as given.
+*/
+date_t date_t::from_legacy(std::string str)
+{
+	int year, month, day;
+
+	if (!parse_fields(str, year, month, day))
+		return date_t();
+	if (year < 1900)
+		return date_t(year + 1900, month + 1, day);
+
+	return date_t(year, month, day);	// Not range-checked, as older versions stored whatever was entered
+}
+
+/*
+	Today's local date. Read this once per operation and pass it along rather than reading the clock for every comparison.
+*/
+date_t date_t::today()
+{
+	std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	std::tm timeinfo;
+
+#ifdef _WIN32
+	localtime_s(&timeinfo, &now);
+#else
+	localtime_r(&now, &timeinfo);
+#endif
+
+	return date_t(timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday);
+}
+
+constexpr int date_t::days_in_month(int year, int month)
+{
+	if (month == 2)
+		return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+
+	return (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+}
+
+/*
+	Convert back to year, month, and day, reversing the constructor's arithmetic
+*/
+constexpr date_t::civil_t date_t::to_civil() const
+{
+	int32_t z = days + 719468;
+	int era = (z >= 0 ? z : z - 146096) / 146097;
+	int day_of_era = z - era * 146097;
+	int year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+	int day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+	int month_index = (5 * day_of_year + 2) / 153;	// 0 is March
+	int month = month_index < 10 ? month_index + 3 : month_index - 9;
+
+	return { year_of_era + era * 400 + (month <= 2), month, day_of_year - (153 * month_index + 2) / 5 + 1 };
+}
+
+/*
+	The same day of the month some number of months later, or the last day of that month if it is shorter
+*/
+constexpr date_t date_t::add_months(int months) const
+{
+	civil_t civil = to_civil();
+	int month_count = civil.year * 12 + (civil.month - 1) + months;
+	int year = (month_count >= 0 ? month_count : month_count - 11) / 12;
+	int month = month_count - year * 12 + 1;
+	int day = civil.day < days_in_month(year, month) ? civil.day : days_in_month(year, month);
+
+	return date_t(year, month, day);
+}
+
+/*
+	Number of calendar months from another date's month to this date's month
+*/
+constexpr int date_t::months_since(date_t other) const
+{
+	civil_t a = to_civil(), b = other.to_civil();
+	return (a.year - b.year) * 12 + (a.month - b.month);
+}
+
+/*
+	Convert to YYYY/MM/DD format
+*/
+std::string date_t::to_string() const
+{
+	civil_t civil = to_civil();
+	char out[32];
+
+	std::snprintf(out, sizeof(out), "%04d/%02d/%02d", civil.year, civil.month, civil.day);
+	return out;
+}
+
+void date_t::print(std::ostream& output, bool newline)
+{
+	set_print(output);
+	output << to_string();
+	if (newline)
+		output << std::endl;
+}
+
+void date_t::store(std::ofstream& output)
+{
+	storage::store(DAYS, days, output);
+	storage::store_rs(output);
+}
\ No newline at end of file
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include "mapped.h"
+
+#define DAWG_MAGIC "PMDAWG01"
+#define DAWG_HEADER_LENGTH 16	// Magic, number of edges, and index of the root's first edge
+#define DAWG_MAX_TIER 31	// Words are ranked in tiers of doubling size, so tier t holds ranks 2^t to 2^(t + 1) - 1
+
+/*
+	A directed acyclic word graph: a trie whose identical subtrees are stored once. It is kept in a file as a flat array of edges and used straight from a memory mapping, so opening it costs nothing no matter how many words it holds.
+
+	Each node is a run of consecutive edges, the last of which is flagged. Edges that complete a word carry the rank tier of that word, so that common words can be guessed sooner than rare ones.
+*/
+class dawg_t
+{
+	public:
+	struct edge_t
+	{
+		uint32_t child;	// Index of the first edge of the node this edge leads to, or 0 if it leads to a node with no edges
+		uint8_t letter;
+		uint8_t tier;	// Rank tier plus 1 of the word ending with this edge, or 0 if no word ends here
+		uint8_t last;	// Whether this is the last edge of its node
+		uint8_t padding;
+	};
+
+	private:
+	mapped_file_t file;
+	std::vector<edge_t> memory;	// Edges compiled in memory rather than mapped from a file
+	const edge_t* edges = nullptr;
+	uint32_t edge_count = 0;
+	uint32_t root = 0;
+
+	public:
+	bool open(std::string);
+	void load(std::vector<std::pair<std::string, uint32_t>>);
+	bool is_open();
+	uint32_t get_edge_count();
+
+	template <typename F>
+	void find_prefixes(const char*, size_t, F);
+
+	static uint32_t compile(std::vector<std::pair<std::string, uint32_t>>, std::vector<edge_t>&);
+	static bool build(std::vector<std::pair<std::string, uint32_t>>, std::string);
+};
+
+bool dawg_t::open(std::string filename)
+{
+	edges = nullptr;
+	edge_count = 0;
+	std::vector<edge_t>().swap(memory);
+	if (!file.open(filename, true) || file.get_size() < DAWG_HEADER_LENGTH || std::memcmp(file.get_data(), DAWG_MAGIC, 8))
+	{
+		file.close();
+		return false;
+	}
+
+	std::memcpy(&edge_count, file.get_data() + 8, sizeof(edge_count));
+	std::memcpy(&root, file.get_data() + 12, sizeof(root));
+
+	if (file.get_size() < DAWG_HEADER_LENGTH + (size_t)edge_count * sizeof(edge_t) || root >= edge_count)
+	{
+		file.close();
+		return false;
+	}
+
+	edges = reinterpret_cast<const edge_t*>(file.get_data() + DAWG_HEADER_LENGTH);
+	return true;
+}
+
+/*
+	Compile words and their ranks straight into memory, for lists small enough to build every run
+*/
+void dawg_t::load(std::vector<std::pair<std::string, uint32_t>> words)
+{
+	file.close();
+	root = compile(words, memory);
+	edges = memory.data();
+	edge_count = memory.size();
+}
+
+bool dawg_t::is_open()
+{
+	return edges;
+}
+
+uint32_t dawg_t::get_edge_count()
+{
+	return edge_count;
+}
+
+/*
+	Call found(length, tier) for every word in the graph that is a prefix of the text, shortest first. Edge indexes from the file are checked against the number of edges, so a corrupt file ends the walk instead of reading past the mapping.
+*/
+template <typename F>
+void dawg_t::find_prefixes(const char* text, size_t n, F found)
+{
+	if (!edges)
+		return;
+
+	uint32_t node = root;
+
+	for (size_t i = 0; i < n && node; i++)
+	{
+		if (node >= edge_count)
+			return;
+
+		const edge_t* edge = edges + node;
+		const edge_t* end = edges + edge_count;
+		while (edge->letter != (uint8_t)text[i] && !edge->last && edge + 1 < end)
+			edge++;
+
+		if (edge->letter != (uint8_t)text[i])
+			return;
+
+		if (edge->tier)
+			found(i + 1, edge->tier - 1);
+
+		node = edge->child;
+	}
+}
+
+/*
+	Compile words and their ranks, 1 being the most common, into the edges of a graph, returning the index of the root's first edge. Identical subtrees are found by giving each node a signature of its edges, working up from the leaves.
+*/
+uint32_t dawg_t::compile(std::vector<std::pair<std::string, uint32_t>> words, std::vector<edge_t>& edges)
+{
+	typedef std::vector<std::pair<uint8_t, uint32_t>> children_t;	// Sorted by letter, so that equal nodes have equal signatures
+
+	std::vector<children_t> children(1);
+	std::vector<uint8_t> tiers(1, 0);
+
+	for (unsigned int i = 0; i < words.size(); i++)
+	{
+		uint32_t node = 0;
+		for (unsigned int j = 0; j < words.at(i).first.length(); j++)
+		{
+			uint8_t letter = words.at(i).first[j];
+			children_t::iterator it = std::lower_bound(children[node].begin(), children[node].end(), std::make_pair(letter, (uint32_t)0));
+
+			if (it == children[node].end() || it->first != letter)
+			{
+				uint32_t child = children.size();
+				children[node].insert(it, { letter, child });
+				children.emplace_back();
+				tiers.push_back(0);
+				node = child;
+			}
+			else
+				node = it->second;
+		}
+
+		uint8_t tier = 1;
+		for (uint32_t rank = std::max<uint32_t>(words.at(i).second, 1); rank > 1 && tier < DAWG_MAX_TIER + 1; rank >>= 1)
+			tier++;
+
+		if (node && (!tiers[node] || tier < tiers[node]))	// Words listed more than once keep their best rank
+			tiers[node] = tier;
+	}
+
+	edges.assign(1, edge_t());	// Edge 0 is never used, so that a child of 0 can mean a node without edges
+	std::vector<uint32_t> offsets(children.size(), 0);	// First edge of each minimized node
+	std::unordered_map<std::string, uint32_t> registry;	// Minimized nodes by signature
+
+	std::vector<std::pair<uint32_t, bool>> stack = { { 0, false } };	// Children are visited before their parents
+	while (!stack.empty())
+	{
+		uint32_t node = stack.back().first;
+		bool expanded = stack.back().second;
+		stack.pop_back();
+
+		if (!expanded)
+		{
+			stack.push_back({ node, true });
+			for (unsigned int i = 0; i < children[node].size(); i++)
+				stack.push_back({ children[node][i].second, false });
+			continue;
+		}
+
+		if (children[node].empty())
+			continue;
+
+		std::string signature;
+		for (unsigned int i = 0; i < children[node].size(); i++)
+		{
+			uint32_t child = children[node][i].second;
+			signature += (char)children[node][i].first;
+			signature += (char)tiers[child];
+			signature.append(reinterpret_cast<const char*>(&offsets[child]), sizeof(uint32_t));
+		}
+
+		std::unordered_map<std::string, uint32_t>::iterator existing = registry.find(signature);
+		if (existing != registry.end())
+		{
+			offsets[node] = existing->second;
+			children_t().swap(children[node]);
+			continue;
+		}
+
+		offsets[node] = edges.size();
+		registry[signature] = edges.size();
+
+		for (unsigned int i = 0; i < children[node].size(); i++)
+		{
+			edge_t edge = {};
+			edge.child = offsets[children[node][i].second];
+			edge.letter = children[node][i].first;
+			edge.tier = tiers[children[node][i].second];
+			edges.push_back(edge);
+		}
+
+		edges.back().last = 1;
+	}
+
+	if (!offsets[0])	// The root needs at least one edge to be found
+	{
+		edge_t edge = {};
+		edge.last = 1;
+		offsets[0] = edges.size();
+		edges.push_back(edge);
+	}
+
+	return offsets[0];
+}
+
+/*
+	Compile words and their ranks into a graph file
+*/
+bool dawg_t::build(std::vector<std::pair<std::string, uint32_t>> words, std::string filename)
+{
+	std::vector<edge_t> edges;
+	uint32_t root = compile(words, edges);
+
+	std::ofstream file(filename, std::ios::trunc | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	uint32_t edge_count = edges.size();
+	file.write(DAWG_MAGIC, 8);
+	file.write(reinterpret_cast<const char*>(&edge_count), sizeof(edge_count));
+	file.write(reinterpret_cast<const char*>(&root), sizeof(root));
+	file.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(edge_t));
+
+	return file.good();
+}
\ No newline at end of file
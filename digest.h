@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#define SHA1_LENGTH 20
+#define NTLM_LENGTH 16
+
+std::string to_hex(const uint8_t[], size_t);
+std::string sha1_hex(std::string);
+std::string ntlm_hex(std::string);
+
+inline uint32_t rotate_left(uint32_t x, int b)
+{
+	return (x << b) | (x >> (32 - b));
+}
+
+/*
+	Uppercase hexadecimal, as used by breach corpora
+*/
+std::string to_hex(const uint8_t bytes[], size_t n)
+{
+	const char* digits = "0123456789ABCDEF";
+	std::string out(n * 2, '0');
+
+	for (size_t i = 0; i < n; i++)
+	{
+		out[i * 2] = digits[bytes[i] >> 4];
+		out[i * 2 + 1] = digits[bytes[i] & 15];
+	}
+
+	return out;
+}
+
+/*
+	Pad a message into 64-byte blocks the way SHA-1 and MD4 both do, with the bit length at the end in the given byte order
+*/
+std::string pad_message(std::string message, bool big_endian)
+{
+	uint64_t bits = uint64_t(message.length()) * 8;
+
+	message += (char)0x80;
+	while (message.length() % 64 != 56)
+		message += (char)0;
+
+	for (int i = 0; i < 8; i++)
+		message += (char)(bits >> (big_endian ? 56 - 8 * i : 8 * i));
+
+	return message;
+}
+
+std::string sha1_hex(std::string message)
+{
+	uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+	std::string padded = pad_message(message, true);
+
+	for (size_t block = 0; block < padded.length(); block += 64)
+	{
+		uint32_t w[80];
+		for (int i = 0; i < 16; i++)
+			w[i] = uint32_t((uint8_t)padded[block + i * 4]) << 24 | uint32_t((uint8_t)padded[block + i * 4 + 1]) << 16 | uint32_t((uint8_t)padded[block + i * 4 + 2]) << 8 | (uint8_t)padded[block + i * 4 + 3];
+		for (int i = 16; i < 80; i++)
+			w[i] = rotate_left(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+		uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+		for (int i = 0; i < 80; i++)
+		{
+			uint32_t f, k;
+			if (i < 20)
+				f = (b & c) | (~b & d), k = 0x5A827999;
+			else if (i < 40)
+				f = b ^ c ^ d, k = 0x6ED9EBA1;
+			else if (i < 60)
+				f = (b & c) | (b & d) | (c & d), k = 0x8F1BBCDC;
+			else
+				f = b ^ c ^ d, k = 0xCA62C1D6;
+
+			uint32_t temp = rotate_left(a, 5) + f + e + k + w[i];
+			e = d;
+			d = c;
+			c = rotate_left(b, 30);
+			b = a;
+			a = temp;
+		}
+
+		h[0] += a;
+		h[1] += b;
+		h[2] += c;
+		h[3] += d;
+		h[4] += e;
+	}
+
+	uint8_t digest[SHA1_LENGTH];
+	for (int i = 0; i < 5; i++)
+		for (int j = 0; j < 4; j++)
+			digest[i * 4 + j] = (uint8_t)(h[i] >> (24 - 8 * j));
+
+	return to_hex(digest, SHA1_LENGTH);
+}
+
+/*
+	MD4 of the password in UTF-16LE, read as UTF-8
+*/
+std::string ntlm_hex(std::string password)
+{
+	std::string utf16;
+	for (size_t i = 0; i < password.length();)
+	{
+		uint8_t c = password[i];
+		int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+		uint32_t code_point = extra ? c & (0x3F >> extra) : c;
+
+		for (int j = 1; j <= extra && i + j < password.length(); j++)
+			code_point = code_point << 6 | ((uint8_t)password[i + j] & 0x3F);
+		i += extra + 1;
+
+		if (code_point >= 0x10000)	// Outside the basic plane, so it takes a surrogate pair
+		{
+			code_point -= 0x10000;
+			utf16 += (char)((0xD800 | code_point >> 10) & 0xFF);
+			utf16 += (char)((0xD800 | code_point >> 10) >> 8);
+			code_point = 0xDC00 | (code_point & 0x3FF);
+		}
+
+		utf16 += (char)(code_point & 0xFF);
+		utf16 += (char)(code_point >> 8);
+	}
+
+	uint32_t h[4] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476 };
+	std::string padded = pad_message(utf16, false);
+
+	for (size_t block = 0; block < padded.length(); block += 64)
+	{
+		uint32_t x[16];
+		for (int i = 0; i < 16; i++)
+			x[i] = (uint8_t)padded[block + i * 4] | uint32_t((uint8_t)padded[block + i * 4 + 1]) << 8 | uint32_t((uint8_t)padded[block + i * 4 + 2]) << 16 | uint32_t((uint8_t)padded[block + i * 4 + 3]) << 24;
+
+		uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+		const int shifts[3][4] = { { 3, 7, 11, 19 }, { 3, 5, 9, 13 }, { 3, 9, 11, 15 } };
+		const int order[3][16] = {
+			{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+			{ 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15 },
+			{ 0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15 }
+		};
+
+		for (int round = 0; round < 3; round++)
+		{
+			for (int i = 0; i < 16; i++)
+			{
+				uint32_t f = round == 0 ? (b & c) | (~b & d) : round == 1 ? (b & c) | (b & d) | (c & d) : b ^ c ^ d;
+				uint32_t k = round == 0 ? 0 : round == 1 ? 0x5A827999 : 0x6ED9EBA1;
+				uint32_t temp = rotate_left(a + f + x[order[round][i]] + k, shifts[round][i % 4]);
+
+				a = d;
+				d = c;
+				c = b;
+				b = temp;
+			}
+		}
+
+		h[0] += a;
+		h[1] += b;
+		h[2] += c;
+		h[3] += d;
+	}
+
+	uint8_t digest[NTLM_LENGTH];
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			digest[i * 4 + j] = (uint8_t)(h[i] >> (8 * j));
+
+	return to_hex(digest, NTLM_LENGTH);
+}
\ No newline at end of file
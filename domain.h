@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <cctype>
+#include <string>
+#include <string_view>
+#include "search.h"
+
+/*
+	Suffixes under which anyone can register a domain, taken from the most common entries of the Public Suffix List (https://publicsuffix.org/list/). A host whose top-level domain is not listed is treated as a top-level registration, as the list's default rule does.
+*/
+constexpr std::string_view public_suffixes[] =
+{
+	"com", "org", "net", "edu", "gov", "mil", "int", "info", "biz", "name", "pro", "mobi",
+	"io", "co", "me", "tv", "cc", "ai", "app", "dev", "xyz", "online", "site", "tech", "store", "cloud",
+	"uk", "co.uk", "org.uk", "me.uk", "ltd.uk", "plc.uk", "net.uk", "ac.uk", "gov.uk", "nhs.uk",
+	"au", "com.au", "net.au", "org.au", "edu.au", "gov.au", "id.au",
+	"nz", "co.nz", "net.nz", "org.nz", "govt.nz", "ac.nz",
+	"jp", "co.jp", "ne.jp", "or.jp", "ac.jp", "go.jp",
+	"kr", "co.kr", "or.kr", "go.kr",
+	"cn", "com.cn", "net.cn", "org.cn", "gov.cn", "edu.cn",
+	"hk", "com.hk", "tw", "com.tw", "sg", "com.sg", "my", "com.my",
+	"in", "co.in", "net.in", "org.in", "gov.in", "ac.in",
+	"br", "com.br", "net.br", "org.br", "gov.br",
+	"mx", "com.mx", "ar", "com.ar", "co.za", "za",
+	"ca", "us", "de", "fr", "it", "es", "nl", "be", "ch", "at", "se", "no", "dk", "fi", "pl", "pt", "ie", "eu", "ru", "ua", "tr", "com.tr", "il", "co.il",
+	"github.io", "gitlab.io", "herokuapp.com", "blogspot.com", "appspot.com", "cloudfront.net", "azurewebsites.net", "netlify.app", "vercel.app", "pages.dev", "workers.dev"
+};
+
+/*
+	One label of a public suffix, read from right to left. Children of a node are kept as a linked list of siblings.
+*/
+struct suffix_node_t
+{
+	std::string_view label;
+	int child = -1;
+	int sibling = -1;
+	bool is_suffix = false;	// Whether the labels from the root to this node form a public suffix
+};
+
+/*
+	Count the labels in every public suffix, which bounds the number of trie nodes
+*/
+constexpr size_t count_suffix_labels()
+{
+	size_t out = 1;	// Root
+
+	for (std::string_view suffix : public_suffixes)
+	{
+		out++;
+		for (char c : suffix)
+			if (c == '.')
+				out++;
+	}
+
+	return out;
+}
+
+/*
+	A trie of public suffixes, keyed by label from the top-level domain down and built entirely at compile time
+*/
+struct suffix_trie_t
+{
+	std::array<suffix_node_t, count_suffix_labels()> nodes{};
+	int size = 1;
+
+	constexpr int find_child(int node, std::string_view label) const
+	{
+		for (int child = nodes[node].child; child != -1; child = nodes[child].sibling)
+			if (nodes[child].label == label)
+				return child;
+
+		return -1;
+	}
+
+	constexpr void insert(std::string_view suffix)
+	{
+		int node = 0;
+
+		while (!suffix.empty())	// Consume labels from the right
+		{
+			size_t dot = suffix.rfind('.');
+			std::string_view label = dot == std::string_view::npos ? suffix : suffix.substr(dot + 1);
+			suffix = dot == std::string_view::npos ? std::string_view() : suffix.substr(0, dot);
+
+			int child = find_child(node, label);
+			if (child == -1)
+			{
+				child = size++;
+				nodes[child].label = label;
+				nodes[child].sibling = nodes[node].child;
+				nodes[node].child = child;
+			}
+
+			node = child;
+		}
+
+		nodes[node].is_suffix = true;
+	}
+};
+
+constexpr suffix_trie_t build_suffix_trie()
+{
+	suffix_trie_t out;
+
+	for (std::string_view suffix : public_suffixes)
+		out.insert(suffix);
+
+	return out;
+}
+
+constexpr suffix_trie_t suffix_trie = build_suffix_trie();
+
+/*
+	Reduce a URL to its lowercase host name, dropping the scheme, user information, port, path, and trailing dot. Return an empty string if the text cannot be a host name.
+*/
+std::string get_host(std::string_view url)
+{
+	size_t scheme = url.find("://");
+	if (scheme != std::string_view::npos)
+		url = url.substr(scheme + 3);
+
+	url = url.substr(0, url.find_first_of("/?#"));
+
+	size_t at = url.rfind('@');
+	if (at != std::string_view::npos)
+		url = url.substr(at + 1);
+
+	url = url.substr(0, url.find(':'));
+	while (!url.empty() && url.back() == '.')
+		url.remove_suffix(1);
+
+	std::string out;
+	out.reserve(url.length());
+
+	for (char c : url)
+	{
+		unsigned char folded = fold_case(c);
+		if (!(std::isalnum(folded) || folded == '-' || folded == '.' || folded >= 0x80))	// Free-text site names are not hosts
+			return std::string();
+
+		out += static_cast<char>(folded);
+	}
+
+	if (out.find('.') == std::string::npos || out.front() == '.' || out.find("..") != std::string::npos)	// Hosts need at least two non-empty labels
+		return std::string();
+
+	return out;
+}
+
+/*
+	Reduce a URL or host name to the domain its owner registered, such as login.github.com to github.com or www.bbc.co.uk to bbc.co.uk. Return an empty string if there is none.
+*/
+std::string registrable_domain(std::string_view url)
+{
+	std::string host = get_host(url);
+	std::string_view rest = host;
+
+	if (host.empty() || std::isdigit(static_cast<unsigned char>(host.back())))	// IP addresses are their own domain
+		return host;
+
+	size_t suffix_start = std::string_view::npos;	// Where the longest public suffix found so far starts
+	int node = 0;
+
+	while (!rest.empty())
+	{
+		size_t dot = rest.rfind('.');
+		std::string_view label = dot == std::string_view::npos ? rest : rest.substr(dot + 1);
+
+		node = suffix_trie.find_child(node, label);
+		if (node == -1)
+			break;
+
+		if (dot == std::string_view::npos)	// The whole host is a public suffix
+			return std::string();
+
+		rest = rest.substr(0, dot);
+		if (suffix_trie.nodes[node].is_suffix)
+			suffix_start = dot + 1;
+	}
+
+	if (suffix_start == std::string_view::npos)
+		suffix_start = host.rfind('.') + 1;	// Unlisted top-level domain
+
+	size_t domain_start = host.rfind('.', suffix_start - 2);
+	return host.substr(domain_start == std::string::npos ? 0 : domain_start + 1);
+}
\ No newline at end of file
@@ -0,0 +1,512 @@
+#pragma once
+
+#include <random>
+#include "crypt.h"
+
+#define RANDOM_BUFFER_BLOCKS 64	// Keystream blocks generated at a time
+#define DEFAULT_GENERATOR_LENGTH 20
+#define DEFAULT_WORDLIST_FILENAME "wordlist.txt"
+#define DICEWARE_SEPARATOR '-'
+
+/*
+	A cryptographically secure source of random bytes. Bytes are read out of a buffer of Salsa20 keystream, and each refill takes the cipher's next key from the keystream itself so that earlier output cannot be recovered from the current state.
+*/
+class random_t
+{
+	ucstk::Salsa20 salsa20;
+	uint8_t buffer[RANDOM_BUFFER_BLOCKS * ucstk::Salsa20::BLOCK_SIZE];
+	size_t position;
+
+	void refill();
+
+	public:
+	random_t();
+	~random_t();
+
+	uint8_t next();
+	uint32_t uniform(uint32_t);
+	void fill(uint8_t[], size_t);
+};
+
+/*
+	A policy for generating passwords, and the means to generate them
+*/
+class generator_t
+{
+	public:
+	enum mode_t
+	{
+		RANDOM = 'R',	// Characters drawn from the selected classes
+		PRONOUNCEABLE = 'P',	// Alternating consonants and vowels
+		DICEWARE = 'W'	// Words drawn from a word list
+	};
+
+	enum class_t
+	{
+		LOWER = 1,
+		UPPER = 2,
+		DIGITS = 4,
+		SYMBOLS = 8
+	};
+
+	private:
+	enum unit_code
+	{
+		MODE = 'M',
+		LENGTH = 'L',
+		CLASSES = 'C',
+		EXCLUDE = 'X'
+	};
+
+	mode_t mode;
+	int length;	// Characters, or words for diceware
+	int classes;	// Bitwise OR of class_t values
+	std::string exclusions;	// Characters never to use, such as look-alikes
+
+	std::string alphabet;
+	int available;	// Classes that still have characters after exclusions
+	char map[256];	// Character for each random byte, or 0 for the bytes rejected to keep the choice unbiased
+
+	void build_alphabet();
+	bool has_classes(const std::string&);
+	std::string generate_random(random_t&);
+	std::string generate_pronounceable(random_t&);
+	std::string generate_diceware(random_t&);
+
+	static int get_class(char);
+	static const std::vector<std::string>& get_wordlist();
+
+	public:
+	generator_t(mode_t = RANDOM, int = DEFAULT_GENERATOR_LENGTH, int = LOWER | UPPER | DIGITS | SYMBOLS, std::string = "");
+	generator_t(std::ifstream&);
+
+	static int parse_classes(std::string);
+	static std::string format_classes(int);
+
+	bool is_valid();
+	std::string describe();
+	std::string generate();
+	std::vector<std::string> generate(unsigned int);
+
+	void store(std::ofstream&);
+};
+
+random_t& get_random();
+
+/*
+	Generate the next buffer of keystream, keeping its first block as the next key
+*/
+void random_t::refill()
+{
+	for (size_t i = 0; i < RANDOM_BUFFER_BLOCKS; i++)
+		salsa20.generateKeyStream(buffer + i * ucstk::Salsa20::BLOCK_SIZE);
+
+	salsa20.setKey(buffer);
+	std::memset(buffer, 0, ucstk::Salsa20::KEY_SIZE);	// The key is never handed out as random bytes
+	position = ucstk::Salsa20::KEY_SIZE;
+}
+
+/*
+	Seed the generator from the operating system's entropy source
+*/
+random_t::random_t()
+{
+	std::random_device device;
+	uint8_t key[ucstk::Salsa20::KEY_SIZE];
+	uint8_t iv[ucstk::Salsa20::IV_SIZE] = {};
+
+	for (size_t i = 0; i < ucstk::Salsa20::KEY_SIZE; i += 4)
+	{
+		uint32_t word = device();
+		std::memcpy(key + i, &word, 4);
+	}
+
+	salsa20.setKey(key);
+	salsa20.setIv(iv);
+	std::memset(key, 0, sizeof(key));
+	refill();
+}
+
+random_t::~random_t()
+{
+	std::memset(buffer, 0, sizeof(buffer));
+}
+
+uint8_t random_t::next()
+{
+	if (position == sizeof(buffer))
+		refill();
+
+	return buffer[position++];
+}
+
+/*
+	Return a number from 0 to n - 1, each equally likely. Draws that would favor the low numbers are rejected rather than wrapped around.
+*/
+uint32_t random_t::uniform(uint32_t n)
+{
+	if (n <= 1)
+		return 0;
+
+	if (n <= 256)
+	{
+		uint32_t limit = 256 - 256 % n;
+		uint32_t byte;
+		do
+			byte = next();
+		while (byte >= limit);
+
+		return byte % n;
+	}
+
+	uint64_t limit = (uint64_t(1) << 32) - (uint64_t(1) << 32) % n;
+	uint64_t word;
+	do
+		word = uint32_t(next()) | uint32_t(next()) << 8 | uint32_t(next()) << 16 | uint32_t(next()) << 24;
+	while (word >= limit);
+
+	return uint32_t(word % n);
+}
+
+void random_t::fill(uint8_t out[], size_t n)
+{
+	while (n > 0)
+	{
+		if (position == sizeof(buffer))
+			refill();
+
+		size_t count = std::min(n, sizeof(buffer) - position);
+		std::memcpy(out, buffer + position, count);
+		std::memset(buffer + position, 0, count);	// Handed-out bytes don't stay in memory
+		position += count;
+		out += count;
+		n -= count;
+	}
+}
+
+/*
+	The random source for the calling thread
+*/
+random_t& get_random()
+{
+	static thread_local random_t random;
+	return random;
+}
+
+/*
+	Build the alphabet for the selected character classes and the table that maps random bytes onto it
+*/
+void generator_t::build_alphabet()
+{
+	const char* sets[] = { "abcdefghijklmnopqrstuvwxyz", "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "0123456789", "!#$%&()*+,-./:;<=>?@[]^_{|}~" };
+
+	alphabet = "";
+	for (unsigned int i = 0; i < 4; i++)
+		if (classes & (1 << i))
+			for (const char* c = sets[i]; *c; c++)
+				if (exclusions.find(*c) == std::string::npos)
+					alphabet += *c;
+
+	available = 0;
+	for (unsigned int i = 0; i < alphabet.length(); i++)
+		available |= get_class(alphabet[i]);
+
+	size_t n = alphabet.length();
+	size_t limit = n ? 256 - 256 % n : 0;
+	for (size_t i = 0; i < 256; i++)
+		map[i] = i < limit ? alphabet[i % n] : 0;
+}
+
+int generator_t::get_class(char c)
+{
+	return c >= 'a' && c <= 'z' ? LOWER : c >= 'A' && c <= 'Z' ? UPPER : c >= '0' && c <= '9' ? DIGITS : SYMBOLS;
+}
+
+/*
+	Whether a password has a character from each selected class that still has characters after exclusions
+*/
+bool generator_t::has_classes(const std::string& password)
+{
+	int found = 0;
+
+	for (unsigned int i = 0; i < password.length(); i++)
+		found |= get_class(password[i]);
+
+	return found == available;
+}
+
+/*
+	Map random bytes through the table in bulk, skipping rejected bytes, and start over if a selected class is missing
+*/
+std::string generator_t::generate_random(random_t& random)
+{
+	uint8_t bytes[MAX_BLOCK_LENGTH * 2];
+	std::string out;
+	out.reserve(length);
+
+	do
+	{
+		out.clear();
+		while (out.length() < (size_t)length)
+		{
+			size_t remaining = length - out.length();
+			size_t count = std::min(sizeof(bytes), remaining + remaining / 2 + 1);	// Enough that one pass usually finishes, without wasting keystream
+			random.fill(bytes, count);
+
+			for (size_t i = 0; i < count && out.length() < (size_t)length; i++)
+				if (map[bytes[i]])
+					out += map[bytes[i]];
+		}
+	} while (length >= 4 && !has_classes(out));	// Short passwords can't always fit every class
+
+	std::memset(bytes, 0, sizeof(bytes));
+	return out;
+}
+
+/*
+	Alternate consonants and vowels, then work in the other selected classes at random positions
+*/
+std::string generator_t::generate_pronounceable(random_t& random)
+{
+	const std::string consonants = "bcdfghjklmnprstvwz";
+	const std::string vowels = "aeiou";
+	std::string out;
+
+	for (int i = 0; i < length; i++)
+		out += i % 2 ? vowels[random.uniform(vowels.length())] : consonants[random.uniform(consonants.length())];
+
+	if ((classes & UPPER) && length > 0)
+	{
+		size_t i = random.uniform(length);
+		out[i] = std::toupper((unsigned char)out[i]);
+	}
+
+	if ((classes & DIGITS) && length > 2)	// Digits and symbols go at the end so the rest stays pronounceable
+		out[length - 1] = '0' + random.uniform(10);
+
+	if ((classes & SYMBOLS) && length > 3)
+		out[length - 2] = "!#$%&*+-=?@_~"[random.uniform(13)];
+
+	return out;
+}
+
+std::string generator_t::generate_diceware(random_t& random)
+{
+	const std::vector<std::string>& words = get_wordlist();
+	std::string out;
+
+	for (int i = 0; i < length && !words.empty(); i++)
+	{
+		if (i > 0)
+			out += DICEWARE_SEPARATOR;
+
+		out += words.at(random.uniform(words.size()));
+	}
+
+	return out;
+}
+
+/*
+	Read the word list once. Lines may be plain words or diceware entries such as "11111	abacus", so the last word on each line is used.
+*/
+const std::vector<std::string>& generator_t::get_wordlist()
+{
+	static std::vector<std::string> words;
+	static bool loaded = false;
+
+	if (!loaded)
+	{
+		std::ifstream file(DEFAULT_WORDLIST_FILENAME);
+		std::string line;
+
+		while (std::getline(file, line))
+		{
+			size_t end = line.find_last_not_of(" \t\r");
+			if (end == std::string::npos)
+				continue;
+
+			size_t begin = line.find_last_of(" \t", end);
+			words.push_back(line.substr(begin == std::string::npos ? 0 : begin + 1, end - (begin == std::string::npos ? 0 : begin + 1) + 1));
+		}
+
+		loaded = true;
+	}
+
+	return words;
+}
+
+generator_t::generator_t(mode_t mode, int length, int classes, std::string exclusions)
+{
+	this->mode = mode;
+	this->length = length;
+	this->classes = classes;
+	this->exclusions = exclusions;
+	build_alphabet();
+}
+
+generator_t::generator_t(std::ifstream& input)
+{
+	mode = RANDOM;
+	length = DEFAULT_GENERATOR_LENGTH;
+	classes = LOWER | UPPER | DIGITS | SYMBOLS;
+
+	if (input.is_open())
+	{
+		char unit_code;
+		int value;
+		while (!storage::is_eog(input) && !storage::is_eor(input) && storage::read_unit(unit_code, input))	// Read next unit code
+		{
+			switch (unit_code)
+			{
+				case MODE:
+					storage::read(value, input);
+					mode = (mode_t)value;
+					break;
+				case LENGTH:
+					storage::read(length, input);
+					break;
+				case CLASSES:
+					storage::read(classes, input);
+					break;
+				case EXCLUDE:
+					storage::read(exclusions, input);
+			}
+		}
+	}
+
+	build_alphabet();
+}
+
+/*
+	Parse character classes written as letters, such as "luds" for lowercase, uppercase, digits, and symbols
+*/
+int generator_t::parse_classes(std::string letters)
+{
+	int out = 0;
+
+	for (unsigned int i = 0; i < letters.length(); i++)
+	{
+		switch (std::tolower((unsigned char)letters[i]))
+		{
+			case 'l':
+				out |= LOWER;
+				break;
+			case 'u':
+				out |= UPPER;
+				break;
+			case 'd':
+				out |= DIGITS;
+				break;
+			case 's':
+				out |= SYMBOLS;
+		}
+	}
+
+	return out;
+}
+
+std::string generator_t::format_classes(int classes)
+{
+	std::string out;
+
+	if (classes & LOWER)
+		out += 'l';
+	if (classes & UPPER)
+		out += 'u';
+	if (classes & DIGITS)
+		out += 'd';
+	if (classes & SYMBOLS)
+		out += 's';
+
+	return out;
+}
+
+/*
+	Whether the policy can produce passwords that fit in a secret
+*/
+bool generator_t::is_valid()
+{
+	switch (mode)
+	{
+		case RANDOM:
+			return length > 0 && length <= MAX_BLOCK_LENGTH && !alphabet.empty();
+		case PRONOUNCEABLE:
+			return length > 0 && length <= MAX_BLOCK_LENGTH;
+		case DICEWARE:
+		{
+			const std::vector<std::string>& words = get_wordlist();
+			size_t longest = 0;
+			for (unsigned int i = 0; i < words.size(); i++)
+				longest = std::max(longest, words.at(i).length());
+
+			return length > 0 && !words.empty() && length * (longest + 1) - 1 <= MAX_BLOCK_LENGTH;	// Checked against the longest word so no draw has to be thrown away
+		}
+	}
+
+	return false;
+}
+
+std::string generator_t::describe()
+{
+	switch (mode)
+	{
+		case RANDOM:
+			return "Generate " + std::to_string(length) + " random characters (" + format_classes(classes) + (exclusions.empty() ? "" : ", not " + exclusions) + ")";
+		case PRONOUNCEABLE:
+			return "Generate " + std::to_string(length) + " pronounceable characters (" + format_classes(classes) + ")";
+		case DICEWARE:
+			return "Generate " + std::to_string(length) + " words from " + DEFAULT_WORDLIST_FILENAME;
+	}
+
+	return std::string();
+}
+
+/*
+	Generate a password, or return an empty string if the policy can't be met
+*/
+std::string generator_t::generate()
+{
+	if (!is_valid())
+		return std::string();
+
+	random_t& random = get_random();
+
+	switch (mode)
+	{
+		case RANDOM:
+			return generate_random(random);
+		case PRONOUNCEABLE:
+			return generate_pronounceable(random);
+		case DICEWARE:
+			return generate_diceware(random);
+	}
+
+	return std::string();
+}
+
+/*
+	Generate n passwords at once, checking the policy a single time
+*/
+std::vector<std::string> generator_t::generate(unsigned int n)
+{
+	std::vector<std::string> out;
+
+	if (!is_valid())
+		return out;
+
+	random_t& random = get_random();
+	out.reserve(n);
+
+	for (unsigned int i = 0; i < n; i++)
+		out.push_back(mode == RANDOM ? generate_random(random) : mode == PRONOUNCEABLE ? generate_pronounceable(random) : generate_diceware(random));
+
+	return out;
+}
+
+void generator_t::store(std::ofstream& output)
+{
+	storage::store(MODE, (int)mode, output);
+	storage::store(LENGTH, length, output);
+	storage::store(CLASSES, classes, output);
+	storage::store(EXCLUDE, exclusions, output);
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX	// Keep windows.h from defining min and max macros
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+	A read-only file mapped into memory, so that only the pages actually read are loaded from disk
+*/
+class mapped_file_t
+{
+	const char* data = nullptr;
+	size_t size = 0;
+
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int file = -1;
+#endif
+
+	public:
+	mapped_file_t() {}
+	mapped_file_t(const mapped_file_t&) = delete;
+	mapped_file_t& operator=(const mapped_file_t&) = delete;
+	~mapped_file_t();
+
+	bool open(std::string, bool = false);
+	void close();
+
+	bool is_open();
+	const char* get_data();
+	size_t get_size();
+};
+
+mapped_file_t::~mapped_file_t()
+{
+	close();
+}
+
+/*
+	Map a file, hinting to the system that it will be read at random rather than in order if random_access is set
+*/
+bool mapped_file_t::open(std::string filename, bool random_access)
+{
+	close();
+
+#ifdef _WIN32
+	file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, random_access ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)	// Empty files can't be mapped
+	{
+		close();
+		return false;
+	}
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping)
+		data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+	size = (size_t)file_size.QuadPart;
+#else
+	file = ::open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		close();
+		return false;
+	}
+
+	void* address = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	if (address != MAP_FAILED)
+	{
+		data = static_cast<const char*>(address);
+		madvise(address, (size_t)status.st_size, random_access ? MADV_RANDOM : MADV_SEQUENTIAL);
+	}
+
+	size = (size_t)status.st_size;
+#endif
+
+	if (!data)
+		close();
+
+	return data;
+}
+
+void mapped_file_t::close()
+{
+#ifdef _WIN32
+	if (data)
+		UnmapViewOfFile(data);
+	if (mapping)
+		CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE)
+		CloseHandle(file);
+
+	mapping = nullptr;
+	file = INVALID_HANDLE_VALUE;
+#else
+	if (data)
+		munmap(const_cast<char*>(data), size);
+	if (file >= 0)
+		::close(file);
+
+	file = -1;
+#endif
+
+	data = nullptr;
+	size = 0;
+}
+
+bool mapped_file_t::is_open()
+{
+	return data;
+}
+
+const char* mapped_file_t::get_data()
+{
+	return data;
+}
+
+size_t mapped_file_t::get_size()
+{
+	return size;
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "output.h"
+
+#if defined(_WIN32)
+#include <malloc.h>
+#define MEMORY_BLOCK_SIZE(pointer) _msize(pointer)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define MEMORY_BLOCK_SIZE(pointer) malloc_size(pointer)
+#else
+#include <malloc.h>
+#define MEMORY_BLOCK_SIZE(pointer) malloc_usable_size(pointer)
+#endif
+
+#define HASH_NODE_OVERHEAD (2 * sizeof(void*))	// Next pointer and cached hash of a node in a hash table
+#define TREE_NODE_OVERHEAD (4 * sizeof(void*))	// Color, parent, and child pointers of a node in a red-black tree
+
+enum memory_subsystem_t
+{
+	RECORDS_MEMORY,	// Credentials objects, their names and usernames, and the credentials list
+	SECRETS_MEMORY,	// Encrypted passwords, security levels, questions, and backup codes
+	SECLEVELS_MEMORY,	// Security-level objects, password histories, and generators
+	INDEXES_MEMORY,	// Lookup tables and tries over credentials and security levels
+	CACHES_MEMORY,	// Data derived from other data to save recomputing it
+	MEMORY_SUBSYSTEM_COUNT
+};
+
+bool memory_tracking = false;	// Set by --mem-report before anything is loaded
+std::atomic<long long> heap_bytes{0};	// Bytes in heap blocks allocated and not freed since tracking started
+std::atomic<long long> heap_blocks{0};
+std::atomic<long long> heap_peak_bytes{0};
+
+struct memory_usage_t
+{
+	unsigned long long objects = 0;
+	unsigned long long bytes = 0;
+};
+
+/*
+	Bytes held by each subsystem, counted by walking its data structures. Heap bytes are the sizes requested of the allocator, so they leave out its rounding and headers, which show up as the difference from the heap total.
+*/
+class memory_report_t
+{
+	memory_usage_t usage[MEMORY_SUBSYSTEM_COUNT];
+
+	public:
+	void add(memory_subsystem_t, unsigned long long, unsigned long long);
+
+	memory_usage_t get(memory_subsystem_t);
+	void print(std::ostream&);
+};
+
+void track_allocation(void*);
+void track_free(void*);
+size_t heap_bytes_of(const std::string&);
+
+/*
+	Count a block just allocated. The live total is kept with relaxed atomics since only the totals matter, and the peak is raised with a compare-and-swap loop that only runs while the heap is growing past it.
+*/
+void track_allocation(void* pointer)
+{
+	if (!memory_tracking || !pointer)
+		return;
+
+	long long size = static_cast<long long>(MEMORY_BLOCK_SIZE(pointer));
+	long long total = heap_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+	long long peak = heap_peak_bytes.load(std::memory_order_relaxed);
+
+	heap_blocks.fetch_add(1, std::memory_order_relaxed);
+	while (total > peak && !heap_peak_bytes.compare_exchange_weak(peak, total, std::memory_order_relaxed));
+}
+
+/*
+	Count a block about to be freed. Blocks allocated before tracking started are counted too, so the totals can run slightly low.
+*/
+void track_free(void* pointer)
+{
+	if (!memory_tracking || !pointer)
+		return;
+
+	heap_bytes.fetch_sub(static_cast<long long>(MEMORY_BLOCK_SIZE(pointer)), std::memory_order_relaxed);
+	heap_blocks.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/*
+	Bytes a string holds on the heap, which is nothing while it fits in the string object itself
+*/
+size_t heap_bytes_of(const std::string& text)
+{
+	static const size_t inline_capacity = std::string().capacity();
+	return text.capacity() > inline_capacity ? text.capacity() + 1 : 0;
+}
+
+template <typename T>
+size_t heap_bytes_of(const std::vector<T>& items)
+{
+	return items.capacity() * sizeof(T);
+}
+
+template <typename K, typename V>
+size_t heap_bytes_of(const std::unordered_map<K, V>& table)
+{
+	return table.bucket_count() * sizeof(void*) + table.size() * (sizeof(typename std::unordered_map<K, V>::value_type) + HASH_NODE_OVERHEAD);
+}
+
+template <typename T>
+size_t heap_bytes_of(const std::unordered_multiset<T>& table)
+{
+	return table.bucket_count() * sizeof(void*) + table.size() * (sizeof(T) + HASH_NODE_OVERHEAD);
+}
+
+template <typename T>
+size_t heap_bytes_of(const std::set<T>& tree)
+{
+	return tree.size() * (sizeof(T) + TREE_NODE_OVERHEAD);
+}
+
+void memory_report_t::add(memory_subsystem_t subsystem, unsigned long long objects, unsigned long long bytes)
+{
+	usage[subsystem].objects += objects;
+	usage[subsystem].bytes += bytes;
+}
+
+memory_usage_t memory_report_t::get(memory_subsystem_t subsystem)
+{
+	return usage[subsystem];
+}
+
+/*
+	Print the objects, bytes, and average object size of each subsystem, then the total and what the allocator has handed out, as a table or, in the JSON formats, as one object
+*/
+void memory_report_t::print(std::ostream& output)
+{
+	const char* names[MEMORY_SUBSYSTEM_COUNT] = { "records", "secrets", "seclevels", "indexes", "caches" };
+	memory_usage_t total;
+	std::string buffer;
+
+	for (unsigned int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++)
+	{
+		total.objects += usage[i].objects;
+		total.bytes += usage[i].bytes;
+	}
+
+	if (output_format != TABLE)
+	{
+		json_writer_t writer(buffer, &output);
+
+		writer.begin_object();
+		writer.key("subsystems").begin_array();
+		for (unsigned int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++)
+		{
+			writer.begin_object();
+			writer.key("name").value(names[i]);
+			writer.key("objects").value(static_cast<long long>(usage[i].objects));
+			writer.key("bytes").value(static_cast<long long>(usage[i].bytes));
+			writer.end_object();
+		}
+		writer.end_array();
+
+		writer.key("accounted_bytes").value(static_cast<long long>(total.bytes));
+		if (memory_tracking)
+		{
+			writer.key("heap_bytes").value(heap_bytes.load());
+			writer.key("heap_blocks").value(heap_blocks.load());
+			writer.key("heap_peak_bytes").value(heap_peak_bytes.load());
+		}
+		writer.end_object();
+		writer.end_line();
+		return;
+	}
+
+	table_writer_t table(buffer, &output);
+
+	table.cell("Subsystem").cell("Objects").cell("Bytes").cell("Average");
+	table.end_row();
+	for (unsigned int i = 0; i <= MEMORY_SUBSYSTEM_COUNT; i++)
+	{
+		memory_usage_t& row = i < MEMORY_SUBSYSTEM_COUNT ? usage[i] : total;
+		char average[32];
+		std::snprintf(average, sizeof(average), "%.1f", row.objects ? static_cast<double>(row.bytes) / row.objects : 0.0);
+
+		table.cell(i < MEMORY_SUBSYSTEM_COUNT ? names[i] : "total").cell(std::to_string(row.objects)).cell(std::to_string(row.bytes)).cell(average);
+		table.end_row();
+	}
+
+	if (memory_tracking)
+	{
+		table.end_row();
+		table.cell("heap_bytes").cell(std::to_string(heap_bytes.load()));
+		table.end_row();
+		table.cell("heap_blocks").cell(std::to_string(heap_blocks.load()));
+		table.end_row();
+		table.cell("heap_peak_bytes").cell(std::to_string(heap_peak_bytes.load()));
+		table.end_row();
+	}
+}
\ No newline at end of file
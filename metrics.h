@@ -0,0 +1,211 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "commit.h"
+
+#define METRICS_SHARDS 16	// Counter shards, so that threads bumping the same counter rarely share a cache line
+#define METRICS_MAX_OPERATIONS 32	// Operation types with their own counters and histograms
+#define METRICS_BUCKET_COUNT 16
+
+const double metrics_buckets[METRICS_BUCKET_COUNT] = { 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10 };	// Upper bounds in seconds
+
+std::string metrics_filename;	// Where the metrics are written in the Prometheus text format, if anywhere
+
+/*
+	A counter split into shards, one picked per thread, and summed when read
+*/
+class counter_t
+{
+	struct alignas(64) shard_t
+	{
+		std::atomic<uint64_t> value{0};
+	};
+
+	shard_t shards[METRICS_SHARDS];
+
+	public:
+	void add(uint64_t = 1);
+	uint64_t get() const;
+};
+
+/*
+	A latency histogram with fixed buckets. Each observation is a few relaxed atomic additions, so threads never wait on each other.
+*/
+class histogram_t
+{
+	std::atomic<uint64_t> buckets[METRICS_BUCKET_COUNT + 1] = {};	// The last bucket holds observations above every bound
+	std::atomic<uint64_t> count{0};
+	std::atomic<uint64_t> sum{0};	// Nanoseconds
+
+	public:
+	void observe(std::chrono::steady_clock::duration);
+	void write(std::ostream&, std::string, std::string) const;
+};
+
+/*
+	Every metric the program keeps
+*/
+struct metrics_t
+{
+	const char* operation_names[METRICS_MAX_OPERATIONS] = {};
+	counter_t operations[METRICS_MAX_OPERATIONS];
+	histogram_t operation_durations[METRICS_MAX_OPERATIONS];
+
+	counter_t name_index_hits;
+	counter_t name_index_misses;
+
+	std::atomic<uint64_t> vault_bytes{0};
+	std::atomic<uint64_t> credentials_count{0};
+	std::atomic<uint64_t> last_save_nanoseconds{0};
+	std::atomic<uint64_t> saves{0};
+};
+
+/*
+	Times an operation from construction to destruction and records it under its type
+*/
+class operation_timer_t
+{
+	unsigned int type;
+	const char* name;
+	std::chrono::steady_clock::time_point start;
+
+	public:
+	operation_timer_t(unsigned int, const char*);
+	~operation_timer_t();
+};
+
+metrics_t& get_metrics();
+unsigned int get_metrics_shard();
+bool write_metrics(std::string);
+
+metrics_t& get_metrics()
+{
+	static metrics_t metrics;
+	return metrics;
+}
+
+/*
+	The calling thread's shard, handed out round-robin as threads first count something
+*/
+unsigned int get_metrics_shard()
+{
+	static std::atomic<unsigned int> next_shard{0};
+	thread_local unsigned int shard = next_shard.fetch_add(1, std::memory_order_relaxed) % METRICS_SHARDS;
+	return shard;
+}
+
+void counter_t::add(uint64_t n)
+{
+	shards[get_metrics_shard()].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+uint64_t counter_t::get() const
+{
+	uint64_t out = 0;
+	for (unsigned int i = 0; i < METRICS_SHARDS; i++)
+		out += shards[i].value.load(std::memory_order_relaxed);
+
+	return out;
+}
+
+void histogram_t::observe(std::chrono::steady_clock::duration elapsed)
+{
+	double seconds = std::chrono::duration<double>(elapsed).count();
+	unsigned int bucket = 0;
+
+	while (bucket < METRICS_BUCKET_COUNT && seconds > metrics_buckets[bucket])
+		bucket++;
+
+	buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	count.fetch_add(1, std::memory_order_relaxed);
+	sum.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+}
+
+/*
+	Write the cumulative buckets, sum and count of a histogram, with a label set such as type="add"
+*/
+void histogram_t::write(std::ostream& output, std::string name, std::string labels) const
+{
+	uint64_t cumulative = 0;
+	char line[256];
+
+	for (unsigned int i = 0; i <= METRICS_BUCKET_COUNT; i++)
+	{
+		cumulative += buckets[i].load(std::memory_order_relaxed);
+
+		if (i < METRICS_BUCKET_COUNT)
+			std::snprintf(line, sizeof(line), "%s_bucket{%s,le=\"%g\"} %llu\n", name.c_str(), labels.c_str(), metrics_buckets[i], static_cast<unsigned long long>(cumulative));
+		else
+			std::snprintf(line, sizeof(line), "%s_bucket{%s,le=\"+Inf\"} %llu\n", name.c_str(), labels.c_str(), static_cast<unsigned long long>(cumulative));
+		output << line;
+	}
+
+	std::snprintf(line, sizeof(line), "%s_sum{%s} %.9f\n%s_count{%s} %llu\n", name.c_str(), labels.c_str(), sum.load(std::memory_order_relaxed) / 1e9,
+		name.c_str(), labels.c_str(), static_cast<unsigned long long>(count.load(std::memory_order_relaxed)));
+	output << line;
+}
+
+operation_timer_t::operation_timer_t(unsigned int type, const char* name)
+{
+	this->type = type;
+	this->name = name;
+	start = std::chrono::steady_clock::now();
+}
+
+operation_timer_t::~operation_timer_t()
+{
+	if (type >= METRICS_MAX_OPERATIONS)
+		return;
+
+	metrics_t& metrics = get_metrics();
+	metrics.operation_names[type] = name;
+	metrics.operations[type].add();
+	metrics.operation_durations[type].observe(std::chrono::steady_clock::now() - start);
+}
+
+/*
+	Write every metric in the Prometheus text format. The file is written under a temporary name and renamed into place, so a scraper or the node exporter's textfile collector never reads half of it.
+*/
+bool write_metrics(std::string filename)
+{
+	metrics_t& metrics = get_metrics();
+	std::string temporary = filename + ".tmp";
+	std::ofstream file(temporary, std::ios::trunc | std::ios::binary);
+
+	if (!file.is_open())
+		return false;
+
+	file << "# HELP passmngr_operations_total Operations run, by type.\n# TYPE passmngr_operations_total counter\n";
+	for (unsigned int i = 0; i < METRICS_MAX_OPERATIONS; i++)
+		if (metrics.operation_names[i])
+			file << "passmngr_operations_total{type=\"" << metrics.operation_names[i] << "\"} " << metrics.operations[i].get() << '\n';
+
+	file << "# HELP passmngr_operation_duration_seconds Time taken by operations, by type.\n# TYPE passmngr_operation_duration_seconds histogram\n";
+	for (unsigned int i = 0; i < METRICS_MAX_OPERATIONS; i++)
+		if (metrics.operation_names[i])
+			metrics.operation_durations[i].write(file, "passmngr_operation_duration_seconds", std::string("type=\"") + metrics.operation_names[i] + "\"");
+
+	file << "# HELP passmngr_name_index_lookups_total Lookups of credentials by site name, by whether the name index answered them.\n# TYPE passmngr_name_index_lookups_total counter\n";
+	file << "passmngr_name_index_lookups_total{result=\"hit\"} " << metrics.name_index_hits.get() << '\n';
+	file << "passmngr_name_index_lookups_total{result=\"miss\"} " << metrics.name_index_misses.get() << '\n';
+
+	file << "# HELP passmngr_vault_bytes Size of the credentials file when it was last saved.\n# TYPE passmngr_vault_bytes gauge\n";
+	file << "passmngr_vault_bytes " << metrics.vault_bytes.load() << '\n';
+	file << "# HELP passmngr_credentials Sets of credentials in the vault when it was last saved.\n# TYPE passmngr_credentials gauge\n";
+	file << "passmngr_credentials " << metrics.credentials_count.load() << '\n';
+	file << "# HELP passmngr_saves_total Saves of the vault.\n# TYPE passmngr_saves_total counter\n";
+	file << "passmngr_saves_total " << metrics.saves.load() << '\n';
+
+	char line[128];
+	std::snprintf(line, sizeof(line), "%.9f", metrics.last_save_nanoseconds.load() / 1e9);
+	file << "# HELP passmngr_last_save_duration_seconds Time taken by the last save.\n# TYPE passmngr_last_save_duration_seconds gauge\n";
+	file << "passmngr_last_save_duration_seconds " << line << '\n';
+
+	file.close();
+	return !file.fail() && replace_file(temporary, filename);	// Plain rename fails on Windows when the file is already there
+}
\ No newline at end of file
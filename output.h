@@ -0,0 +1,321 @@
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "scan.h"
+#include "print.h"
+
+#define JSON_MAX_DEPTH 32
+#define JSON_FLUSH_SIZE (1 << 20)	// Bytes a writer with a stream holds before writing them out
+
+enum output_format_t
+{
+	TABLE,
+	JSON,	// One array per listing
+	NDJSON	// One object per line
+};
+
+output_format_t output_format = TABLE;
+
+std::ostream& get_output();
+bool set_output_format(std::string);
+
+/*
+	A streaming JSON writer that appends to a buffer, putting in commas between values by itself. Strings are escaped straight into the buffer, a run of plain characters at a time, so that writing allocates nothing once the buffer has grown.
+*/
+class json_writer_t
+{
+	std::string& buffer;
+	std::ostream* output;	// Where a full buffer is written out, or nullptr to keep everything in the buffer
+	bool has_value[JSON_MAX_DEPTH] = {};	// Whether the object or array at each depth has a value yet, so the next one needs a comma
+	bool after_key = false;
+	unsigned int depth = 0;
+
+	void separate();
+	void open(char);
+	void close(char);
+
+	public:
+	json_writer_t(std::string&, std::ostream* = nullptr);
+	~json_writer_t();
+
+	json_writer_t& begin_object();
+	json_writer_t& end_object();
+	json_writer_t& begin_array();
+	json_writer_t& end_array();
+	json_writer_t& key(const char*);
+	json_writer_t& value(const std::string&);
+	json_writer_t& value(const char*);
+	json_writer_t& value(const char*, size_t);
+	json_writer_t& value(long long);
+	json_writer_t& value(double);
+	json_writer_t& value(bool);
+	json_writer_t& null();
+	void end_line();
+	void flush();
+};
+
+json_writer_t::json_writer_t(std::string& buffer, std::ostream* output) : buffer(buffer), output(output) {}
+
+json_writer_t::~json_writer_t()
+{
+	flush();
+}
+
+/*
+	Put a comma before any value but the first of its object or array
+*/
+void json_writer_t::separate()
+{
+	if (after_key)
+		after_key = false;
+	else if (depth > 0 && has_value[depth - 1])
+		buffer += ',';
+
+	if (depth > 0)
+		has_value[depth - 1] = true;
+}
+
+void json_writer_t::open(char bracket)
+{
+	separate();
+	buffer += bracket;
+
+	if (depth < JSON_MAX_DEPTH)
+		has_value[depth] = false;
+	depth++;
+}
+
+void json_writer_t::close(char bracket)
+{
+	buffer += bracket;
+	if (depth > 0)
+		depth--;
+}
+
+json_writer_t& json_writer_t::begin_object()
+{
+	open('{');
+	return *this;
+}
+
+json_writer_t& json_writer_t::end_object()
+{
+	close('}');
+	return *this;
+}
+
+json_writer_t& json_writer_t::begin_array()
+{
+	open('[');
+	return *this;
+}
+
+json_writer_t& json_writer_t::end_array()
+{
+	close(']');
+	return *this;
+}
+
+/*
+	Start a member of an object. Keys are names in the source, so they are not escaped.
+*/
+json_writer_t& json_writer_t::key(const char* name)
+{
+	separate();
+	buffer += '"';
+	buffer += name;
+	buffer += "\":";
+	after_key = true;
+	return *this;
+}
+
+json_writer_t& json_writer_t::value(const std::string& text)
+{
+	return value(text.data(), text.length());
+}
+
+/*
+	Write a C string, which would otherwise be taken as a boolean
+*/
+json_writer_t& json_writer_t::value(const char* text)
+{
+	return value(text, std::strlen(text));
+}
+
+json_writer_t& json_writer_t::value(const char* text, size_t n)
+{
+	separate();
+	buffer += '"';
+
+	size_t run = 0;	// Start of the characters not yet copied
+	for (size_t i = 0; i < n; i++)
+	{
+		unsigned char c = text[i];
+		if (c >= 0x20 && c != '"' && c != '\\')
+			continue;
+
+		buffer.append(text + run, i - run);
+		run = i + 1;
+
+		switch (c)
+		{
+			case '"': buffer += "\\\""; break;
+			case '\\': buffer += "\\\\"; break;
+			case '\n': buffer += "\\n"; break;
+			case '\r': buffer += "\\r"; break;
+			case '\t': buffer += "\\t"; break;
+			default:
+			{
+				const char* digits = "0123456789abcdef";
+				char escaped[6] = { '\\', 'u', '0', '0', digits[c >> 4], digits[c & 15] };
+				buffer.append(escaped, sizeof(escaped));
+			}
+		}
+	}
+
+	buffer.append(text + run, n - run);
+	buffer += '"';
+	return *this;
+}
+
+json_writer_t& json_writer_t::value(long long number)
+{
+	char digits[24];
+	int length = std::snprintf(digits, sizeof(digits), "%lld", number);
+
+	separate();
+	buffer.append(digits, length);
+	return *this;
+}
+
+json_writer_t& json_writer_t::value(double number)
+{
+	char digits[32];
+	int length = std::snprintf(digits, sizeof(digits), "%.3f", number);
+
+	separate();
+	buffer.append(digits, length);
+	return *this;
+}
+
+json_writer_t& json_writer_t::value(bool flag)
+{
+	separate();
+	buffer += flag ? "true" : "false";
+	return *this;
+}
+
+json_writer_t& json_writer_t::null()
+{
+	separate();
+	buffer += "null";
+	return *this;
+}
+
+/*
+	End a line of NDJSON, writing the buffer out if it is full
+*/
+void json_writer_t::end_line()
+{
+	buffer += '\n';
+
+	if (output && buffer.size() >= JSON_FLUSH_SIZE)
+		flush();
+}
+
+void json_writer_t::flush()
+{
+	if (output && !buffer.empty())
+	{
+		output->write(buffer.data(), buffer.size());
+		buffer.clear();	// Keeps its capacity for the next lines
+	}
+}
+
+/*
+	Where listings are written. In the JSON formats, this is standard output and everything else the program says goes to standard error, so that the output can be parsed as it is.
+*/
+std::ostream& get_output()
+{
+	static std::ostream output(std::cout.rdbuf());
+	return output;
+}
+
+/*
+	Set the output format from its name, "table", "json" or "ndjson"
+*/
+bool set_output_format(std::string name)
+{
+	output_format_t format;
+
+	if (name == "table")
+		format = TABLE;
+	else if (name == "json")
+		format = JSON;
+	else if (name == "ndjson")
+		format = NDJSON;
+	else
+		return false;
+
+	std::ostream& output = get_output();	// Bound to standard output before messages are moved off it
+	if (format != TABLE && output_format == TABLE)
+		std::cout.rdbuf(std::cerr.rdbuf());
+	else if (format == TABLE && output_format != TABLE)
+		std::cout.rdbuf(output.rdbuf());
+
+	output_format = format;
+	return true;
+}
+
+/*
+	Write every item that satisfies a predicate in the output format: as table rows with print, or as JSON with write. Like scan_print, chunks are formatted in parallel into their own buffers and written out in order. In JSON, every item is written with a leading comma, and the comma before the first is dropped when the buffers are joined.
+*/
+template <typename T>
+void scan_write(const std::vector<T>& items, std::function<bool(const T&)> predicate, std::function<void(const T&, table_writer_t&)> print, std::function<void(const T&, json_writer_t&)> write, std::ostream& output)
+{
+	unsigned int chunks = get_chunk_count(items.size());
+	std::vector<std::string> buffers(chunks);
+
+	for_each_chunk<T>(items, chunks, [&](unsigned int chunk, size_t begin, size_t end)
+	{
+		table_writer_t table(buffers[chunk]);
+		json_writer_t writer(buffers[chunk]);
+
+		for (size_t i = begin; i < end; i++)
+		{
+			if (!predicate(items[i]))
+				continue;
+
+			if (output_format == TABLE)
+			{
+				print(items[i], table);
+				continue;
+			}
+
+			if (output_format == JSON)
+				buffers[chunk] += ",\n";
+			write(items[i], writer);
+			if (output_format == NDJSON)
+				writer.end_line();
+		}
+	});
+
+	bool first = true;
+	if (output_format == JSON)
+		output << '[';
+
+	for (unsigned int chunk = 0; chunk < chunks; chunk++)
+	{
+		size_t skip = output_format == JSON && first && !buffers[chunk].empty() ? 1 : 0;
+		output.write(buffers[chunk].data() + skip, buffers[chunk].size() - skip);
+		first = first && buffers[chunk].empty();
+	}
+
+	if (output_format == JSON)
+		output << "\n]\n";
+	output.flush();
+}
\ No newline at end of file
@@ -1,276 +1,372 @@
-#include "action.h"
-
-std::vector<action_t*> get_actions(int, char**);
-void do_actions(std::vector<action_t*>);
-
-bool set_key(std::string);
-bool login(std::string);
-void logout();
-
-void save();
-
-int main(int argc, char* argv[])
-{
-	/*
-	action_t* action;
-
-	action = new login_action_t("Pa55W0rd");
-	action->exec();
-	delete action;
-
-	action = new add_questions_action_t();
-	*action += "SITE2";
-	*action += "What is red?";
-	*action += "Red";
-	*action += "What is orange?";
-	*action += "Orange";
-	action->exec();
-	delete action;
-
-	action = new print_action_t();
-	action->exec();
-	delete action;
-
-	save();
-	logout();
-	return 0;
-	*/
-	if (argc == 1)
-	{
-		application::run();
-		return 0;
-	}
-	if (argc == 2 && contains(argv[1], "."))
-	{
-		credentials_filename = argv[1];
-		application::edit_credentials();
-		return 0;
-	}
-
-	bool no_actions = false;
-
-	for (int i = 1; i < argc && !no_actions; i++)
-	{
-		if (!strcmp(argv[i], "--version"))	// Check if --version is mentioned anywhere in the arguments
-		{
-			std::cout << VERSION << std::endl;
-			no_actions = true;
-		}
-
-		if (!strcmp(argv[i], "--help"))	// Check if --help is mentioned anywhere in the arguments
-		{
-			application::display_help();
-			no_actions = true;
-		}
-
-		if (!strcmp(argv[i], "--key"))	// Check if --key is mentioned anywhere in the arguments
-		{
-			if (application::login())
-				if (confirm("Would you like to update the program key?"))
-					set_key(get("Enter new program key: "));
-
-			no_actions = true;
-		}
-
-		if (!strcmp(argv[i], "--seclevels"))	// Check if --seclevels is mentioned anywhere in the arguments
-		{
-			if (application::login())
-				application::edit_seclevels();
-
-			no_actions = true;
-		}
-	}
-
-	if (!no_actions)
-		do_actions(get_actions(argc, argv));
-
-	save();
-	logout();
-}
-
-/*
-	Parse command-line arguments into an actions vector
-*/
-std::vector<action_t*> get_actions(int argc, char** argv)
-{
-	std::vector<action_t*> out;
-
-	for (int i = 1; i < argc; i++)
-	{
-		if (!strcmp(argv[i], "-k"))
-			if (++i < argc)	// Make sure that there is at least one more argument to utilize
-				out.push_back(new login_action_t(argv[i]));
-
-		if (!strcmp(argv[i], "-f"))
-			if (++i < argc)
-				out.push_back(new filename_action_t(argv[i]));
-
-		if (!strcmp(argv[i], "-d"))
-			if (++i < argc)
-				out.push_back(new delete_action_t(argv[i]));
-
-		if (!strcmp(argv[i], "-a"))
-			if (i < argc - 2)	// Make sure that there are at least three more arguments to utilize
-				out.push_back(new add_action_t(argc, argv, i));
-			else
-				break;
-
-		if (!strcmp(argv[i], "-m"))
-			if (i++ < argc - 2)
-				out.push_back(new modify_action_t(argc, argv, i));
-			else
-				break;
-
-		if (!strcmp(argv[i], "-l"))
-		{
-			action_t* action = new seclevel_action_t();
-			*action += argv[++i];	// Add the security level code to the options vector
-
-			for (int n = std::stoi(argv[i]); n > 0; n--)	// Add the credentials to modify to the options vector
-				if (++i < argc)
-					*action += argv[i];
-
-			out.push_back(action);
-		}
-
-		if (!strcmp(argv[i], "-q"))
-		{
-			action_t* action;
-
-			std::string name = std::string();
-			int n = 0;
-			if (++i < argc)
-				name = argv[i];
-			if (++i < argc)
-				n = std::stoi(argv[i]);
-
-			if (n >= 0)	// Positive n's call for adding secret questions
-				action = new add_questions_action_t();
-			else	// Negative n's call for deleting secret questions
-				action = new delete_questions_action_t();
-
-			*action += name;	// Both types take the site name before other arguments
-
-			int j = 0;
-			for (; j < n * 2; j++)	// If n is positive, arguments for adding secret questions will be pushed to the options vector
-				if (++i < argc)
-					*action += argv[i];
-			for (; j > n; j--)	// If n is negative, arguments for deleting secret questions will be pushed
-				if (++i < argc)
-					*action += argv[i];
-
-			out.push_back(action);
-		}
-
-		if (!strcmp(argv[i], "-b"))
-		{
-			action_t* action;
-
-			std::string name = std::string();
-			int n = 0;
-			if (++i < argc)
-				name = argv[i];
-			if (++i < argc)
-				n = std::stoi(argv[i]);
-
-			if (n >= 0)	// Positive n's call for adding backup codes
-				action = new add_backups_action_t();
-			else	// Negative n's call for deleting backup codes
-				action = new delete_backups_action_t();
-
-			*action += name;	// Both types take the site name before other arguments
-
-			for (int j = 0; j < abs(n); j++)	// The same number of arguments is required whether n is positive or negative
-				if (++i < argc)
-					*action += argv[i];
-
-			out.push_back(action);
-		}
-
-		if (!strcmp(argv[i], "-u"))
-			if (++i < argc)
-				out.push_back(new set_key_action_t(argv[i]));
-
-		if (!strcmp(argv[i], "-p"))
-			out.push_back(new print_action_t());
-
-		if (!strcmp(argv[i], "-s"))
-			if (++i < argc)
-				out.push_back(new search_action_t(argv[i]));
-	}
-
-	return out;
-}
-
-void do_actions(std::vector<action_t*> actions)
-{
-	action_t* action;
-	do
-	{
-		action = nullptr;
-
-		for (int type = action_t::FILENAME; type <= action_t::SET_KEY; type++)	// Actions have a predefined order they are completed in
-		{
-			for (unsigned int i = 0; !action && i < actions.size(); i++)
-			{
-				if (actions.at(i)->type == type)
-				{
-					actions.at(i)->exec();
-					delete actions.at(i);
-					actions.erase(actions.begin() + i);
-					i--;
-				}
-			}
-		}
-	} while (action);
-}
-
-/*
-	Update master key
-*/
-bool set_key(std::string new_key)
-{
-	if (session)
-	{
-		session->set_key(new_key);
-		return true;
-	}
-
-	return false;
-}
-
-bool login(std::string key)
-{
-	if (!session)
-		session = new session_t(key, credentials_filename, keystore_filename, seclevel_filename);
-
-	if (!session->is_logged_in())
-	{
-		delete session;
-		session = nullptr;
-	}
-
-	if (session)
-		return true;
-	else
-		return false;
-}
-
-void logout()
-{
-	if (session)
-	{
-		session->logout();
-		delete session;
-		std::cout << "Logged out successfully" << std::endl;
-	}
-}
-
-void save()
-{
-	if (session)
-	{
-		std::cout << "Saving credentials and security levels" << std::endl;
-		session->store(credentials_filename);
-	}
+#include "action.h"
+
+std::vector<action_t*> get_actions(int, char**);
+void do_actions(std::vector<action_t*>);
+
+bool set_key(std::string);
+bool login(std::string);
+void logout();
+
+void save();
+
+int main(int argc, char* argv[])
+{
+	/*
+	action_t* action;
+
+	action = new login_action_t("Pa55W0rd");
+	action->exec();
+	delete action;
+
+	action = new add_questions_action_t();
+	*action += "SITE2";
+	*action += "What is red?";
+	*action += "Red";
+	*action += "What is orange?";
+	*action += "Orange";
+	action->exec();
+	delete action;
+
+	action = new print_action_t();
+	action->exec();
+	delete action;
+
+	save();
+	logout();
+	return 0;
+	*/
+	const char* workload = std::getenv(WORKLOAD_ENVIRONMENT_VARIABLE);
+	if (workload && *workload && !get_workload_recorder().open(workload))
+		std::cerr << "Could not open workload log " << workload << std::endl;
+
+	if (argc == 1)
+	{
+		application::run();
+		return 0;
+	}
+	if (argc == 2 && contains(argv[1], "."))
+	{
+		credentials_filename = argv[1];
+		application::edit_credentials();
+		return 0;
+	}
+
+	bool no_actions = false;
+
+	for (int i = 1; i < argc && !no_actions; i++)
+	{
+		if (!strcmp(argv[i], "--version"))	// Check if --version is mentioned anywhere in the arguments
+		{
+			std::cout << VERSION << std::endl;
+			no_actions = true;
+		}
+
+		if (!strcmp(argv[i], "--help"))	// Check if --help is mentioned anywhere in the arguments
+		{
+			application::display_help();
+			no_actions = true;
+		}
+
+		if (!strcmp(argv[i], "--key"))	// Check if --key is mentioned anywhere in the arguments
+		{
+			if (application::login())
+				if (confirm("Would you like to update the program key?"))
+					set_key(get("Enter new program key: "));
+
+			no_actions = true;
+		}
+
+		if (!strcmp(argv[i], "--profile"))	// Check if --profile is mentioned anywhere in the arguments
+			profiling = true;
+
+		if (!strcmp(argv[i], "--mem-report"))	// Check if --mem-report is mentioned anywhere in the arguments
+			memory_tracking = true;
+
+		if (!strcmp(argv[i], "--seclevels"))	// Check if --seclevels is mentioned anywhere in the arguments
+		{
+			if (application::login())
+				application::edit_seclevels();
+
+			no_actions = true;
+		}
+	}
+
+	if (!no_actions)
+		do_actions(get_actions(argc, argv));
+
+	save();
+	logout();
+
+	if (!metrics_filename.empty() && !write_metrics(metrics_filename))
+		std::cerr << "Could not write metrics to " << metrics_filename << std::endl;
+
+	if (profiling)
+		print_profile(std::cerr);
+}
+
+/*
+	Parse command-line arguments into an actions vector
+*/
+std::vector<action_t*> get_actions(int argc, char** argv)
+{
+	std::vector<action_t*> out;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-k"))
+			if (i + 1 < argc)	// Make sure that there is at least one more argument to utilize
+				out.push_back(new login_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "-f"))
+			if (i + 1 < argc)
+				out.push_back(new filename_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "-c"))
+			if (i + 1 < argc)
+				out.push_back(new corpus_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "-t"))
+			if (i + 1 < argc)
+				out.push_back(new threads_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "--format"))
+			if (i + 1 < argc)
+				out.push_back(new format_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "--columns"))
+			if (i + 1 < argc)
+				out.push_back(new columns_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "--metrics"))
+			if (i + 1 < argc)
+				out.push_back(new metrics_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "--record"))
+			if (i + 1 < argc)
+				out.push_back(new record_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "--batch"))
+			if (i + 1 < argc)
+				out.push_back(new batch_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "-d"))
+			if (i + 1 < argc)
+				out.push_back(new delete_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "-a"))
+			if (i < argc - 2)	// Make sure that there are at least three more arguments to utilize
+				out.push_back(new add_action_t(argc, argv, i));
+			else
+				break;
+
+		if (!strcmp(argv[i], "-m"))
+			if (i < argc - 2)
+				out.push_back(new modify_action_t(argc, argv, i));
+			else
+				break;
+
+		if (!strcmp(argv[i], "-l"))
+		{
+			if (i + 2 >= argc)	// Make sure that there are a code and a count
+				break;
+
+			int n = std::stoi(argv[i + 2]);
+			action_t* action = new seclevel_action_t();
+			*action += argv[++i];	// Add the security level code to the options vector
+
+			for (i++; n > 0; n--)	// Add the credentials to modify to the options vector
+				if (i + 1 < argc)
+					*action += argv[++i];
+
+			out.push_back(action);
+		}
+
+		if (!strcmp(argv[i], "-r"))
+			if (i + 1 < argc)
+				out.push_back(new rotate_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "-q"))
+		{
+			action_t* action;
+
+			std::string name = std::string();
+			int n = 0;
+			if (i + 1 < argc)
+				name = argv[++i];
+			if (i + 1 < argc)
+				n = std::stoi(argv[++i]);
+
+			if (n >= 0)	// Positive n's call for adding secret questions
+				action = new add_questions_action_t();
+			else	// Negative n's call for deleting secret questions
+				action = new delete_questions_action_t();
+
+			*action += name;	// Both types take the site name before other arguments
+
+			int j = 0;
+			for (; j < n * 2; j++)	// If n is positive, arguments for adding secret questions will be pushed to the options vector
+				if (i + 1 < argc)
+					*action += argv[++i];
+			for (; j > n; j--)	// If n is negative, arguments for deleting secret questions will be pushed
+				if (i + 1 < argc)
+					*action += argv[++i];
+
+			out.push_back(action);
+		}
+
+		if (!strcmp(argv[i], "-b"))
+		{
+			action_t* action;
+
+			std::string name = std::string();
+			int n = 0;
+			if (i + 1 < argc)
+				name = argv[++i];
+			if (i + 1 < argc)
+				n = std::stoi(argv[++i]);
+
+			if (n >= 0)	// Positive n's call for adding backup codes
+				action = new add_backups_action_t();
+			else	// Negative n's call for deleting backup codes
+				action = new delete_backups_action_t();
+
+			*action += name;	// Both types take the site name before other arguments
+
+			for (int j = 0; j < abs(n); j++)	// The same number of arguments is required whether n is positive or negative
+				if (i + 1 < argc)
+					*action += argv[++i];
+
+			out.push_back(action);
+		}
+
+		if (!strcmp(argv[i], "-u"))
+			if (i + 1 < argc)
+				out.push_back(new set_key_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "-p"))
+			out.push_back(new print_action_t());
+
+		if (!strcmp(argv[i], "-s"))
+			if (i + 1 < argc)
+				out.push_back(new search_action_t(argv[++i]));
+
+		if (!strcmp(argv[i], "--audit"))
+			out.push_back(new audit_action_t());
+
+		if (!strcmp(argv[i], "--bloom"))
+			out.push_back(new build_bloom_action_t());
+
+		if (!strcmp(argv[i], "--dictionary"))
+		{
+			action_t* action = new build_dictionary_action_t();
+
+			while (i + 1 < argc && argv[i + 1][0] != '-')	// Word lists run up to the next option
+				*action += argv[++i];
+
+			out.push_back(action);
+		}
+
+		if (!strcmp(argv[i], "--breaches"))
+			out.push_back(new breaches_action_t());
+
+		if (!strcmp(argv[i], "--mem-report"))
+			out.push_back(new memory_report_action_t());
+
+		if (!strcmp(argv[i], "--due"))
+		{
+			action_t* action = new due_action_t();
+
+			for (int j = 0; j < 2; j++)	// Start and end dates
+				if (i + 1 < argc)
+					*action += argv[++i];
+
+			out.push_back(action);
+		}
+
+		if (!strcmp(argv[i], "-z"))
+			if (i + 1 < argc)
+				out.push_back(new fuzzy_search_action_t(argv[++i]));
+	}
+
+	return out;
+}
+
+/*
+	Run actions in the predefined order of their types, keeping the order they were given in within each type. Actions are sorted into a bucket per type in one pass, and each bucket runs as one run so that actions of the same type can share work.
+*/
+void do_actions(std::vector<action_t*> actions)
+{
+	std::vector<std::vector<action_t*>> buckets(action_t::MEMORY_REPORT + 1);
+
+	for (unsigned int i = 0; i < actions.size(); i++)
+		buckets.at(actions.at(i)->type).push_back(actions.at(i));
+
+	for (unsigned int type = 0; type < buckets.size(); type++)
+	{
+		if (buckets.at(type).empty())
+			continue;
+
+		phase_timer_t timer(buckets.at(type).front()->get_type_name());
+		buckets.at(type).front()->prepare(buckets.at(type));
+
+		for (unsigned int i = 0; i < buckets.at(type).size(); i++)
+		{
+			{
+				operation_timer_t operation(type, buckets.at(type).at(i)->get_type_name());
+				buckets.at(type).at(i)->exec();
+			}
+			delete buckets.at(type).at(i);
+		}
+	}
+}
+
+/*
+	Update master key
+*/
+bool set_key(std::string new_key)
+{
+	if (session)
+	{
+		session->set_key(new_key);
+		return true;
+	}
+
+	return false;
+}
+
+bool login(std::string key)
+{
+	if (!session)
+		session = new session_t(key, credentials_filename, keystore_filename, seclevel_filename);
+
+	if (!session->is_logged_in())
+	{
+		delete session;
+		session = nullptr;
+	}
+
+	if (session)
+		return true;
+	else
+		return false;
+}
+
+void logout()
+{
+	if (session)
+	{
+		session->logout();
+		delete session;
+		std::cout << "Logged out successfully" << std::endl;
+	}
+}
+
+void save()
+{
+	if (session)
+	{
+		std::cout << "Saving credentials and security levels" << std::endl;
+		if (!session->store(credentials_filename))
+			std::cerr << "Could not save to " << credentials_filename << "; the previous files were kept" << std::endl;
+	}
 }
\ No newline at end of file
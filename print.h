@@ -1,27 +1,113 @@
-#pragma once
-
-#include <iostream>
-#include <iomanip>
-#include <string>
-#include <vector>
-
-class printable_t
-{
-	public:
-	virtual void print(std::ostream&, std::string) = 0;
-};
-
-void set_print(std::ostream& output)
-{
-	output << std::setw(50) << std::setfill(' ') << std::left;
-}
-
-void print_list(std::vector<printable_t*> list, std::string key)
-{
-	for (unsigned int i = 0; i < list.size(); i++)
-	{
-		set_print(std::cout);
-		std::cout << (i + 1);
-		list.at(i)->print(std::cout, key);
-	}
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#define PRINT_WIDTH 50	// Columns are padded to this width, and longer fields run past it
+#define TABLE_FLUSH_SIZE (1 << 20)	// Bytes a table writer with a stream holds before writing them out
+
+/*
+	Formats rows of padded cells into a buffer. Padding is copied from a run of spaces rather than set up as stream formatting for every field, and rows end without flushing, so a listing is written out in large blocks.
+*/
+class table_writer_t
+{
+	std::string& buffer;
+	std::ostream* output;	// Where a full buffer is written out, or nullptr to keep everything in the buffer
+
+	public:
+	table_writer_t(std::string&, std::ostream* = nullptr);
+	~table_writer_t();
+
+	table_writer_t& cell(const std::string&);
+	table_writer_t& cell(const char*, size_t);
+	table_writer_t& cell(unsigned int);
+	void end_row();
+	void flush();
+};
+
+class printable_t
+{
+	public:
+	virtual void print(table_writer_t&, std::string) = 0;
+	void print(std::ostream&, std::string);
+};
+
+table_writer_t::table_writer_t(std::string& buffer, std::ostream* output) : buffer(buffer), output(output) {}
+
+table_writer_t::~table_writer_t()
+{
+	flush();
+}
+
+table_writer_t& table_writer_t::cell(const std::string& text)
+{
+	return cell(text.data(), text.length());
+}
+
+/*
+	Add a field padded to PRINT_WIDTH
+*/
+table_writer_t& table_writer_t::cell(const char* text, size_t n)
+{
+	static const std::string padding(PRINT_WIDTH, ' ');
+
+	buffer.append(text, n);
+	if (n < PRINT_WIDTH)
+		buffer.append(padding, 0, PRINT_WIDTH - n);
+
+	return *this;
+}
+
+table_writer_t& table_writer_t::cell(unsigned int number)
+{
+	return cell(std::to_string(number));
+}
+
+/*
+	End a row, writing the buffer out if it is full
+*/
+void table_writer_t::end_row()
+{
+	buffer += '\n';
+
+	if (output && buffer.size() >= TABLE_FLUSH_SIZE)
+		flush();
+}
+
+void table_writer_t::flush()
+{
+	if (output && !buffer.empty())
+	{
+		output->write(buffer.data(), buffer.size());
+		buffer.clear();	// Keeps its capacity for the next rows
+	}
+}
+
+/*
+	Print to a stream through a table writer of its own
+*/
+void printable_t::print(std::ostream& output, std::string key)
+{
+	std::string buffer;
+	table_writer_t table(buffer, &output);
+	print(table, key);
+}
+
+void set_print(std::ostream& output)
+{
+	output << std::setw(PRINT_WIDTH) << std::setfill(' ') << std::left;
+}
+
+void print_list(std::vector<printable_t*> list, std::string key)
+{
+	std::string buffer;
+	table_writer_t table(buffer, &std::cout);
+
+	for (unsigned int i = 0; i < list.size(); i++)
+	{
+		table.cell(i + 1);
+		list.at(i)->print(table, key);
+	}
 }
\ No newline at end of file
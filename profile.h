@@ -0,0 +1,264 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+#include "output.h"
+#include "memory.h"
+
+#ifdef __GNUC__
+#define PROFILE_NOINLINE __attribute__((noinline))	// Keeps the compiler from pairing an inlined free() with a new expression and warning about the mismatch
+#else
+#define PROFILE_NOINLINE
+#endif
+
+enum profile_counter_t
+{
+	DECRYPTS,
+	ENCRYPTS,
+	BYTES_READ,
+	BYTES_WRITTEN,
+	ALLOCATIONS,
+	ALLOCATED_BYTES,
+	PROFILE_COUNTER_COUNT
+};
+
+bool profiling = false;	// Set by --profile before anything is loaded
+std::atomic<unsigned long long> profile_counters[PROFILE_COUNTER_COUNT];
+
+/*
+	Total time spent in a named phase of a run
+*/
+struct profile_phase_t
+{
+	std::string name;
+	unsigned long calls = 0;
+	std::chrono::steady_clock::duration time = std::chrono::steady_clock::duration::zero();
+};
+
+/*
+	Times a phase from construction to destruction when profiling
+*/
+class phase_timer_t
+{
+	const char* name;
+	std::chrono::steady_clock::time_point start;
+
+	public:
+	phase_timer_t(const char*);
+	~phase_timer_t();
+};
+
+std::vector<profile_phase_t>& get_profile_phases();
+void profile_count(profile_counter_t, unsigned long long = 1);
+void profile_read(std::ifstream&);
+void profile_written(std::ofstream&);
+void print_profile(std::ostream&);
+
+/*
+	Phases in the order they were first entered. Phases nest, so a phase's time includes the time of the phases run inside it.
+*/
+std::vector<profile_phase_t>& get_profile_phases()
+{
+	static std::vector<profile_phase_t> phases;
+	return phases;
+}
+
+phase_timer_t::phase_timer_t(const char* name)
+{
+	this->name = name;
+	if (profiling)
+		start = std::chrono::steady_clock::now();
+}
+
+/*
+	Add the time since construction to the phase's total. Phases are timed on the main thread only, so the list needs no lock.
+*/
+phase_timer_t::~phase_timer_t()
+{
+	if (!profiling)
+		return;
+
+	std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+	std::vector<profile_phase_t>& phases = get_profile_phases();
+	unsigned int i = 0;
+
+	while (i < phases.size() && phases.at(i).name != name)
+		i++;
+	if (i == phases.size())
+	{
+		phases.push_back(profile_phase_t());
+		phases.back().name = name;
+	}
+
+	phases.at(i).calls++;
+	phases.at(i).time += elapsed;
+}
+
+/*
+	Add to a counter when profiling. Counters are bumped from scan threads too, so they are atomic, but relaxed since only the totals matter.
+*/
+void profile_count(profile_counter_t counter, unsigned long long n)
+{
+	if (profiling)
+		profile_counters[counter].fetch_add(n, std::memory_order_relaxed);
+}
+
+/*
+	Count the size of a file about to be read in full
+*/
+void profile_read(std::ifstream& file)
+{
+	if (profiling && file.is_open())
+	{
+		file.seekg(0, std::ios::end);
+		profile_count(BYTES_READ, static_cast<unsigned long long>(file.tellg()));
+		file.seekg(0, std::ios::beg);
+	}
+}
+
+/*
+	Count what has been written to a file about to be closed
+*/
+void profile_written(std::ofstream& file)
+{
+	if (profiling && file.is_open())
+		profile_count(BYTES_WRITTEN, static_cast<unsigned long long>(file.tellp()));
+}
+
+/*
+	Print the time spent in each phase and the counters, as a table or, in the JSON formats, as one object
+*/
+void print_profile(std::ostream& output)
+{
+	const char* counter_names[PROFILE_COUNTER_COUNT] = { "decrypts", "encrypts", "bytes_read", "bytes_written", "allocations", "allocated_bytes" };
+	std::vector<profile_phase_t>& phases = get_profile_phases();
+	std::string buffer;
+
+	if (output_format != TABLE)
+	{
+		json_writer_t writer(buffer, &output);
+
+		writer.begin_object();
+		writer.key("phases").begin_array();
+		for (unsigned int i = 0; i < phases.size(); i++)
+		{
+			writer.begin_object();
+			writer.key("name").value(phases.at(i).name);
+			writer.key("calls").value(static_cast<long long>(phases.at(i).calls));
+			writer.key("microseconds").value(static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(phases.at(i).time).count()));
+			writer.end_object();
+		}
+		writer.end_array();
+
+		writer.key("counters").begin_object();
+		for (unsigned int i = 0; i < PROFILE_COUNTER_COUNT; i++)
+			writer.key(counter_names[i]).value(static_cast<long long>(profile_counters[i].load()));
+		writer.end_object();
+
+		writer.end_object();
+		writer.end_line();
+		return;
+	}
+
+	table_writer_t table(buffer, &output);
+
+	table.cell("Phase").cell("Calls").cell("Milliseconds");
+	table.end_row();
+	for (unsigned int i = 0; i < phases.size(); i++)
+	{
+		char milliseconds[32];
+		std::snprintf(milliseconds, sizeof(milliseconds), "%.3f", std::chrono::duration<double, std::milli>(phases.at(i).time).count());
+
+		table.cell(phases.at(i).name).cell(std::to_string(phases.at(i).calls)).cell(milliseconds);
+		table.end_row();
+	}
+
+	table.end_row();
+	for (unsigned int i = 0; i < PROFILE_COUNTER_COUNT; i++)
+	{
+		table.cell(counter_names[i]).cell(std::to_string(profile_counters[i].load()));
+		table.end_row();
+	}
+}
+
+/*
+	Allocate from the heap, counting the allocation when profiling and tracking the block when reporting memory. Every replaceable form of new and delete below goes through malloc and free, so none of them can be paired with a library form that does not.
+*/
+void* profile_allocate(size_t size) noexcept
+{
+	if (profiling)
+	{
+		profile_counters[ALLOCATIONS].fetch_add(1, std::memory_order_relaxed);
+		profile_counters[ALLOCATED_BYTES].fetch_add(size, std::memory_order_relaxed);
+	}
+
+	void* out = std::malloc(size ? size : 1);
+	track_allocation(out);
+	return out;
+}
+
+void* operator new(size_t size)
+{
+	void* out = profile_allocate(size);
+	if (!out)
+		throw std::bad_alloc();
+
+	return out;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return profile_allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return profile_allocate(size);
+}
+
+PROFILE_NOINLINE void operator delete(void* pointer) noexcept
+{
+	track_free(pointer);
+	std::free(pointer);
+}
+
+PROFILE_NOINLINE void operator delete[](void* pointer) noexcept
+{
+	track_free(pointer);
+	std::free(pointer);
+}
+
+PROFILE_NOINLINE void operator delete(void* pointer, size_t) noexcept
+{
+	track_free(pointer);
+	std::free(pointer);
+}
+
+PROFILE_NOINLINE void operator delete[](void* pointer, size_t) noexcept
+{
+	track_free(pointer);
+	std::free(pointer);
+}
+
+PROFILE_NOINLINE void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	track_free(pointer);
+	std::free(pointer);
+}
+
+PROFILE_NOINLINE void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	track_free(pointer);
+	std::free(pointer);
+}
\ No newline at end of file
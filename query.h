@@ -0,0 +1,246 @@
+#pragma once
+
+#include <functional>
+#include <unordered_set>
+#include "credentials.h"
+#include "domain.h"
+
+/*
+	A search over credentials made up of field:value filters, all of which must match
+*/
+class query_t
+{
+	public:
+	enum field_t
+	{
+		NAME,
+		DOMAIN,
+		USERNAME,
+		HAS,
+		LEVEL,
+		EXPIRED
+	};
+
+	struct predicate_t
+	{
+		field_t field;
+		std::string value;
+		double selectivity;	// Estimated fraction of credentials that satisfy the predicate
+		std::string domain = "";	// Registrable domain of the value, if it names a host
+		std::unordered_set<credentials_t*> domain_matches = {};	// Credentials filed under that domain
+	};
+
+	private:
+	std::vector<predicate_t> plain_predicates;	// Evaluated on fields stored in the clear
+	std::vector<predicate_t> secret_predicates;	// Evaluated on the decrypted security level
+	std::vector<credentials_t*> level_members;	// Credentials under the security level of the filter answered by the index
+	std::string error;
+
+	void add_predicate(std::string);
+	void plan();
+
+	public:
+	query_t(std::string);
+
+	bool is_valid();
+	std::string get_error();
+	bool needs_security_level();
+	std::string get_index_domain();
+	void resolve_domains(std::function<std::vector<credentials_t*>(std::string)>);
+	bool resolve_level(std::function<std::vector<credentials_t*>(std::string)>);
+	const std::vector<credentials_t*>& get_level_members();
+
+	bool matches_fields(credentials_t*);
+	bool matches_security_level(std::string, const std::unordered_set<std::string>&);
+};
+
+/*
+	Parse a query such as "user:ops@ name:aws level:HIGH expired:yes has:backups". URLs and domain: filters match site names on the same registrable domain. Other words without a recognized field match the site name.
+*/
+query_t::query_t(std::string query)
+{
+	std::vector<std::string> words = tokenize(query, &error);
+
+	for (unsigned int i = 0; i < words.size() && error.empty(); i++)
+		add_predicate(words.at(i));
+
+	plan();
+}
+
+void query_t::add_predicate(std::string word)
+{
+	size_t colon = word.find(':');
+	std::string field = colon == std::string::npos ? std::string() : word.substr(0, colon);
+	std::string value = colon == std::string::npos ? word : word.substr(colon + 1);
+
+	std::transform(field.begin(), field.end(), field.begin(),
+		[](unsigned char c) { return std::tolower(c); });
+
+	if (field == "domain" || (field.find('/') == std::string::npos && word.find("://") != std::string::npos))	// Full URLs, as passed by browser integrations, are looked up by domain
+	{
+		std::string url = field == "domain" ? value : word;
+		plain_predicates.push_back({ DOMAIN, url, 0, registrable_domain(url) });	// Answered by the domain index, so no other filter can be more selective
+	}
+	else if (field == "name" || field == "user")
+		plain_predicates.push_back({ field == "name" ? NAME : USERNAME, value, 1.0 / (1 + value.length()) });	// Longer substrings match fewer site names
+	else if (field == "has" && (value == "backups" || value == "questions"))
+		plain_predicates.push_back({ HAS, value, 0.5 });
+	else if (field == "has" && value == "level")
+		secret_predicates.push_back({ HAS, value, 0.5 });
+	else if (field == "level")
+		secret_predicates.push_back({ LEVEL, value, 0 });
+	else if (field == "expired" && (value == "yes" || value == "no"))
+		secret_predicates.push_back({ EXPIRED, value, 0 });
+	else if (field == "has" || field == "expired")
+		error = "Unrecognized value \"" + value + "\" for " + field;
+	else
+		plain_predicates.push_back({ NAME, word, 1.0 / (1 + word.length()), registrable_domain(word) });	// Not a filter, so the whole word is part of a site name, or a host on the same domain as one
+}
+
+/*
+	Order the plain predicates so that the most selective is checked first and most credentials are rejected after a single comparison
+*/
+void query_t::plan()
+{
+	std::stable_sort(plain_predicates.begin(), plain_predicates.end(), [](const predicate_t& a, const predicate_t& b)
+	{
+		return a.selectivity < b.selectivity;
+	});
+}
+
+bool query_t::is_valid()
+{
+	return error.empty();
+}
+
+std::string query_t::get_error()
+{
+	return error;
+}
+
+/*
+	Whether the security level of each candidate must be decrypted to finish evaluating the query
+*/
+bool query_t::needs_security_level()
+{
+	return !secret_predicates.empty();
+}
+
+/*
+	Registrable domain of the first domain filter, whose matches are the only credentials worth checking
+*/
+std::string query_t::get_index_domain()
+{
+	for (unsigned int i = 0; i < plain_predicates.size(); i++)
+		if (plain_predicates.at(i).field == DOMAIN)
+			return plain_predicates.at(i).domain;
+
+	return std::string();
+}
+
+/*
+	Look up the credentials filed under each domain in the query so that matching a domain costs a single set lookup
+*/
+void query_t::resolve_domains(std::function<std::vector<credentials_t*>(std::string)> find_domain)
+{
+	for (unsigned int i = 0; i < plain_predicates.size(); i++)
+	{
+		predicate_t& predicate = plain_predicates.at(i);
+
+		if (!predicate.domain.empty())
+		{
+			std::vector<credentials_t*> matches = find_domain(predicate.domain);
+			predicate.domain_matches.insert(matches.begin(), matches.end());
+		}
+	}
+}
+
+/*
+	Look up the credentials under the first level filter in the security-level index. Those credentials are then the only ones checked, and that filter is dropped so no security level has to be decrypted to answer it. Credentials without a security level aren't indexed, so level:N/A is left to the full scan. Returns whether there was a level filter to look up.
+*/
+bool query_t::resolve_level(std::function<std::vector<credentials_t*>(std::string)> find_members)
+{
+	for (unsigned int i = 0; i < secret_predicates.size(); i++)
+	{
+		if (secret_predicates.at(i).field == LEVEL && !lowercase_equals(secret_predicates.at(i).value, NO_SECURITY_LEVEL))
+		{
+			level_members = find_members(secret_predicates.at(i).value);
+			secret_predicates.erase(secret_predicates.begin() + i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const std::vector<credentials_t*>& query_t::get_level_members()
+{
+	return level_members;
+}
+
+/*
+	Check the predicates that do not need decryption
+*/
+bool query_t::matches_fields(credentials_t* credentials)
+{
+	for (unsigned int i = 0; i < plain_predicates.size(); i++)
+	{
+		predicate_t& predicate = plain_predicates.at(i);
+		bool match = false;
+
+		switch (predicate.field)
+		{
+			case NAME:
+				match = lowercase_contains(credentials->get_name(), predicate.value) || predicate.domain_matches.count(credentials);
+				break;
+			case DOMAIN:
+				match = predicate.domain_matches.count(credentials) > 0;
+				break;
+			case USERNAME:
+				match = lowercase_contains(credentials->get_username(), predicate.value);
+				break;
+			case HAS:
+				match = predicate.value == "backups" ? !credentials->get_backups().empty() : !credentials->get_questions().empty();
+				break;
+			default:
+				break;
+		}
+
+		if (!match)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+	Check the predicates on a decrypted security-level code against the codes of security levels whose passwords have expired
+*/
+bool query_t::matches_security_level(std::string code, const std::unordered_set<std::string>& expired_codes)
+{
+	for (unsigned int i = 0; i < secret_predicates.size(); i++)
+	{
+		predicate_t& predicate = secret_predicates.at(i);
+		bool match = false;
+
+		switch (predicate.field)
+		{
+			case HAS:
+				match = code != NO_SECURITY_LEVEL;
+				break;
+			case LEVEL:
+				match = lowercase_equals(code, predicate.value);
+				break;
+			case EXPIRED:
+				match = expired_codes.count(code) == (predicate.value == "yes" ? 1 : 0);
+				break;
+			default:
+				break;
+		}
+
+		if (!match)
+			return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -1,47 +1,109 @@
-#pragma once
-
-#include <iostream>
-#include <sstream>
-#include <string>
-
-std::string get(std::string);
-bool confirm(std::string);
-
-std::string get(std::string question)
-{
-	std::string response;
-	std::string check;
-
-	std::cout << question;
-	getline(std::cin, response);
-
-	std::stringstream ss(response);
-
-	if (ss >> check)	// Check if user entered anything
-		return response;
-	else
-		return std::string();
-}
-
-bool confirm(std::string question)
-{
-	std::string response = get(question + " (y/n): ");
-	
-	while (response.empty())
-	{
-		response = get("");
-	}
-
-	switch (response[0])
-	{
-		case 'y':
-			return true;
-		default:
-			return false;
-	}
-}
-
-bool confirm_deletion(std::string name)
-{
-	return confirm("Are you sure you want to delete \"" + name + "\"?");
+#pragma once
+
+#include <iostream>
+#include <cctype>
+#include <sstream>
+#include <string>
+#include <vector>
+
+enum confirm_policy_t
+{
+	ASK,
+	ASSUME_YES,	// For batches, which can't stop to ask
+	ASSUME_NO
+};
+
+confirm_policy_t confirm_policy = ASK;
+
+std::string get(std::string);
+bool confirm(std::string);
+std::vector<std::string> tokenize(std::string, std::string* = nullptr);
+
+std::string get(std::string question)
+{
+	std::string response;
+	std::string check;
+
+	std::cout << question;
+	getline(std::cin, response);
+
+	std::stringstream ss(response);
+
+	if (ss >> check)	// Check if user entered anything
+		return response;
+	else
+		return std::string();
+}
+
+bool confirm(std::string question)
+{
+	if (confirm_policy != ASK)
+		return confirm_policy == ASSUME_YES;
+
+	std::string response = get(question + " (y/n): ");
+	
+	while (response.empty())
+	{
+		response = get("");
+	}
+
+	switch (response[0])
+	{
+		case 'y':
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool confirm_deletion(std::string name)
+{
+	return confirm("Are you sure you want to delete \"" + name + "\"?");
+}
+
+/*
+	Split a line into words separated by whitespace, keeping double-quoted phrases together. A backslash makes the quote or backslash after it part of the word, and is kept as it is before any other character. A quote left open is reported through error, if given, since the words can't be what was meant.
+*/
+std::vector<std::string> tokenize(std::string line, std::string* error)
+{
+	std::vector<std::string> out;
+	std::string word;
+	bool quoted = false;
+	bool in_word = false;
+
+	for (unsigned int i = 0; i < line.length(); i++)
+	{
+		char c = line[i];
+
+		if (c == '\\' && i + 1 < line.length() && (line[i + 1] == '"' || line[i + 1] == '\\'))
+		{
+			word += line[++i];
+			in_word = true;
+		}
+		else if (c == '"')
+		{
+			quoted = !quoted;
+			in_word = true;	// An empty pair of quotes is still a word
+		}
+		else if (!quoted && std::isspace(static_cast<unsigned char>(c)))
+		{
+			if (in_word)
+				out.push_back(word);
+			word.clear();
+			in_word = false;
+		}
+		else
+		{
+			word += c;
+			in_word = true;
+		}
+	}
+
+	if (in_word)
+		out.push_back(word);
+
+	if (quoted && error)
+		*error = "Unterminated quote";
+
+	return out;
 }
\ No newline at end of file
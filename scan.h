@@ -0,0 +1,211 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+#define SCAN_MIN_CHUNK 1024	// Fewest items in a chunk before it is worth handing to another thread
+#define SCAN_CHUNKS_PER_THREAD 4	// Extra chunks so that threads finishing early can pick up more work
+
+unsigned int scan_threads = 0;	// Number of threads scans may use, where 0 uses every core
+
+/*
+	A fixed set of worker threads that the calling thread joins to run the chunks of one task at a time
+*/
+class thread_pool_t
+{
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable work_ready;
+	std::condition_variable work_done;
+
+	const std::function<void(unsigned int)>* task = nullptr;
+	unsigned int chunk_count = 0;
+	unsigned int next_chunk = 0;
+	unsigned int chunks_done = 0;
+	unsigned long generation = 0;	// Incremented for each task so that workers can tell a new task from a spurious wakeup
+	bool stopping = false;
+
+	void work();
+	bool run_next_chunk(std::unique_lock<std::mutex>&);
+
+	public:
+	thread_pool_t(unsigned int);
+	~thread_pool_t();
+
+	unsigned int size();
+	void run(unsigned int, const std::function<void(unsigned int)>&);
+};
+
+thread_pool_t& get_thread_pool();
+
+/*
+	Start threads - 1 workers, since the thread calling run() does its share of the work
+*/
+thread_pool_t::thread_pool_t(unsigned int threads)
+{
+	for (unsigned int i = 1; i < threads; i++)
+		workers.push_back(std::thread(&thread_pool_t::work, this));
+}
+
+thread_pool_t::~thread_pool_t()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	work_ready.notify_all();
+	for (unsigned int i = 0; i < workers.size(); i++)
+		workers.at(i).join();
+}
+
+/*
+	Number of threads that take part in a task, including the caller
+*/
+unsigned int thread_pool_t::size()
+{
+	return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+/*
+	Claim and run the next chunk of the current task, if any are left. The lock is released while the chunk runs.
+*/
+bool thread_pool_t::run_next_chunk(std::unique_lock<std::mutex>& lock)
+{
+	if (!task || next_chunk >= chunk_count)
+		return false;
+
+	unsigned int chunk = next_chunk++;
+	const std::function<void(unsigned int)>* current = task;
+
+	lock.unlock();
+	(*current)(chunk);
+	lock.lock();
+
+	if (++chunks_done == chunk_count)
+		work_done.notify_all();
+
+	return true;
+}
+
+void thread_pool_t::work()
+{
+	unsigned long seen = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true)
+	{
+		work_ready.wait(lock, [&] { return stopping || generation != seen; });
+		if (stopping)
+			return;
+
+		seen = generation;
+		while (run_next_chunk(lock)) {}
+	}
+}
+
+/*
+	Run task(chunk) for every chunk in [0, chunks) and return once all of them have finished
+*/
+void thread_pool_t::run(unsigned int chunks, const std::function<void(unsigned int)>& task)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	this->task = &task;
+	chunk_count = chunks;
+	next_chunk = chunks_done = 0;
+	generation++;
+	work_ready.notify_all();
+
+	while (run_next_chunk(lock)) {}
+	work_done.wait(lock, [&] { return chunks_done == chunk_count; });
+
+	this->task = nullptr;
+}
+
+/*
+	The pool shared by all scans, started the first time a scan needs it
+*/
+thread_pool_t& get_thread_pool()
+{
+	static thread_pool_t pool(scan_threads ? scan_threads : std::max(1u, std::thread::hardware_concurrency()));
+	return pool;
+}
+
+/*
+	Number of chunks to split n items into
+*/
+unsigned int get_chunk_count(size_t n)
+{
+	if (n < 2 * SCAN_MIN_CHUNK || scan_threads == 1)
+		return 1;
+
+	size_t chunks = std::min<size_t>(n / SCAN_MIN_CHUNK, get_thread_pool().size() * SCAN_CHUNKS_PER_THREAD);
+	return static_cast<unsigned int>(chunks);
+}
+
+/*
+	Run a function over the items of each chunk, in parallel when the list is long enough to be worth it
+*/
+template <typename T>
+void for_each_chunk(const std::vector<T>& items, unsigned int chunks, std::function<void(unsigned int, size_t, size_t)> function)
+{
+	size_t n = items.size();
+	std::function<void(unsigned int)> task = [&](unsigned int chunk)
+	{
+		function(chunk, n * chunk / chunks, n * (chunk + 1) / chunks);
+	};
+
+	if (chunks == 1)
+		task(0);
+	else
+		get_thread_pool().run(chunks, task);
+}
+
+/*
+	Project every item that satisfies a predicate. Items are evaluated chunk by chunk across threads and the results keep the order of the items.
+*/
+template <typename R, typename T>
+std::vector<R> scan(const std::vector<T>& items, std::function<bool(const T&, R&)> project)
+{
+	unsigned int chunks = get_chunk_count(items.size());
+	std::vector<std::vector<R>> chunk_results(chunks);
+
+	for_each_chunk<T>(items, chunks, [&](unsigned int chunk, size_t begin, size_t end)
+	{
+		R result;
+		for (size_t i = begin; i < end; i++)
+			if (project(items[i], result))	// The projection doubles as the predicate
+				chunk_results[chunk].push_back(result);
+	});
+
+	std::vector<R> out;
+	for (unsigned int chunk = 0; chunk < chunks; chunk++)
+		out.insert(out.end(), chunk_results[chunk].begin(), chunk_results[chunk].end());
+
+	return out;
+}
+
+/*
+	Print every item that satisfies a predicate. Each chunk is formatted into its own buffer and the buffers are written out in order, so the output is the same for any number of threads.
+*/
+template <typename T>
+void scan_print(const std::vector<T>& items, std::function<bool(const T&)> predicate, std::function<void(const T&, std::ostream&)> print, std::ostream& output)
+{
+	unsigned int chunks = get_chunk_count(items.size());
+	std::vector<std::ostringstream> buffers(chunks);
+
+	for_each_chunk<T>(items, chunks, [&](unsigned int chunk, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			if (predicate(items[i]))
+				print(items[i], buffers[chunk]);
+	});
+
+	for (unsigned int chunk = 0; chunk < chunks; chunk++)
+		output << buffers[chunk].str();
+}
\ No newline at end of file
@@ -1,27 +1,211 @@
-#pragma once
-
-#include <string>
-#include <cctype>
-#include <algorithm>
-
-/*
-	Return whether the query is in the specified string
-*/
-bool contains(std::string in, std::string query)
-{
-	return in.find(query) != std::string::npos;
-}
-
-/*
-	Return whether the lowercase query is in the lowercase specified string
-*/
-bool lowercase_contains(std::string in, std::string query)
-{
-	std::transform(in.begin(), in.end(), in.begin(),
-		[](unsigned char c) { return std::tolower(c); });	// Convert in to lowercase
-
-	std::transform(query.begin(), query.end(), query.begin(),
-		[](unsigned char c) { return std::tolower(c); });	// Convert query to lowercase
-
-	return in.find(query) != std::string::npos;
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SEARCH_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#define FUZZY_MAX_RESULTS 10	// Number of matches a fuzzy search returns by default
+#define FUZZY_CHARS_PER_EDIT 4	// One edit is tolerated for every this many characters in a fuzzy query
+
+/*
+	Lowercase an ASCII letter. Every byte of a multi-byte UTF-8 character is 0x80 or above, so UTF-8 text passes through unchanged and is matched byte for byte.
+*/
+inline unsigned char fold_case(unsigned char c)
+{
+	return c >= 'A' && c <= 'Z' ? c | 0x20 : c;
+}
+
+/*
+	Compare n bytes, ignoring ASCII case
+*/
+inline bool lowercase_equals(const char* a, const char* b, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		if (fold_case(a[i]) != fold_case(b[i]))
+			return false;
+
+	return true;
+}
+
+#ifdef SEARCH_SSE2
+/*
+	Lowercase the ASCII letters in 16 bytes at once. Signed comparisons leave bytes of 0x80 and above untouched.
+*/
+inline __m128i fold_case(__m128i v)
+{
+	__m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+	return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+inline unsigned int count_trailing_zeros(unsigned int mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+/*
+	Return whether the query is in the specified string
+*/
+bool contains(std::string_view in, std::string_view query)
+{
+	return in.find(query) != std::string_view::npos;
+}
+
+/*
+	Return whether the query is in the specified string, ignoring case. Sixteen candidate positions are tested at a time by comparing the first and last characters of the query; only positions where both match are compared in full.
+*/
+bool lowercase_contains(std::string_view in, std::string_view query)
+{
+	size_t n = in.length();
+	size_t m = query.length();
+
+	if (m == 0)
+		return true;
+	if (m > n)
+		return false;
+
+	size_t i = 0;	// Candidate starting position
+
+#ifdef SEARCH_SSE2
+	const __m128i first = _mm_set1_epi8(static_cast<char>(fold_case(query[0])));
+	const __m128i last = _mm_set1_epi8(static_cast<char>(fold_case(query[m - 1])));
+
+	for (; i + m - 1 + 16 <= n; i += 16)	// While 16 bytes can be loaded from the last character's position
+	{
+		__m128i block_first = fold_case(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data() + i)));
+		__m128i block_last = fold_case(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data() + i + m - 1)));
+		unsigned int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last)));
+
+		while (mask)
+		{
+			unsigned int offset = count_trailing_zeros(mask);
+			if (lowercase_equals(in.data() + i + offset + 1, query.data() + 1, m < 2 ? 0 : m - 2))	// The ends already match
+				return true;
+
+			mask &= mask - 1;	// Clear the lowest set bit
+		}
+	}
+#endif
+
+	for (; i + m <= n; i++)	// Positions too close to the end for a full block
+		if (lowercase_equals(in.data() + i, query.data(), m))
+			return true;
+
+	return false;
+}
+
+/*
+	Return whether two strings are equal, ignoring case
+*/
+bool lowercase_equals(std::string_view a, std::string_view b)
+{
+	return a.length() == b.length() && lowercase_equals(a.data(), b.data(), a.length());
+}
+
+/*
+	Fuzzy distance for queries too long for a single bit vector, computed one row of the edit-distance table at a time
+*/
+unsigned int fuzzy_distance_long(std::string_view in, std::string_view query)
+{
+	size_t m = query.length();
+	std::vector<unsigned int> prev(m + 1), row(m + 1), next(m + 1);
+
+	for (size_t i = 0; i <= m; i++)
+		row[i] = static_cast<unsigned int>(i);
+
+	unsigned int best = row[m];
+	for (size_t j = 0; j < in.length(); j++)
+	{
+		int t = fold_case(in[j]);
+
+		next[0] = 0;	// The query may start anywhere in the string
+		for (size_t i = 1; i <= m; i++)
+		{
+			int q = fold_case(query[i - 1]);
+
+			next[i] = std::min({ row[i] + 1, next[i - 1] + 1, row[i - 1] + (q == t ? 0 : 1) });
+
+			if (i > 1 && j > 0 && q == fold_case(in[j - 1]) && t == fold_case(query[i - 2]))
+				next[i] = std::min(next[i], prev[i - 2] + 1);	// Adjacent characters swapped
+		}
+
+		std::swap(prev, row);
+		std::swap(row, next);
+		best = std::min(best, row[m]);
+	}
+
+	return best;
+}
+
+/*
+	Return the fewest edits (insertions, deletions, substitutions, or swaps of adjacent characters) needed for the query to appear somewhere in the specified string, ignoring case.
+	Each bit of a 64-bit word holds one row of the edit-distance table, so a whole column is advanced per character of the string (Hyyro's extension of Myers' bit-parallel algorithm).
+*/
+unsigned int fuzzy_distance(std::string_view in, std::string_view query)
+{
+	size_t m = query.length();
+
+	if (m == 0)
+		return 0;
+	if (m > 64)
+		return fuzzy_distance_long(in, query);
+
+	uint64_t peq[256] = {};	// Bit i of peq[c] is set if character i of the query is c
+	for (size_t i = 0; i < m; i++)
+		peq[fold_case(query[i])] |= uint64_t(1) << i;
+
+	uint64_t vp = ~uint64_t(0), vn = 0;	// Vertical deltas of the current column
+	uint64_t d0 = 0, prev_pm = 0;	// Diagonal zero-deltas and match mask of the previous column
+	uint64_t last = uint64_t(1) << (m - 1);
+	unsigned int score = static_cast<unsigned int>(m);
+	unsigned int best = score;
+
+	for (size_t j = 0; j < in.length(); j++)
+	{
+		uint64_t pm = peq[fold_case(in[j])];
+		uint64_t tr = (((~d0) & pm) << 1) & prev_pm;	// Adjacent transpositions
+
+		d0 = (((pm & vp) + vp) ^ vp) | pm | vn | tr;
+		uint64_t hp = vn | ~(d0 | vp);
+		uint64_t hn = vp & d0;
+
+		if (hp & last)
+			score++;
+		else if (hn & last)
+			score--;
+
+		hp <<= 1;	// Nothing is shifted in so that the query may start anywhere in the string
+		hn <<= 1;
+		vp = hn | ~(d0 | hp);
+		vn = hp & d0;
+		prev_pm = pm;
+
+		best = std::min(best, score);
+	}
+
+	return best;
+}
+
+/*
+	Maximum fuzzy distance at which a string still matches a query of the specified length
+*/
+unsigned int fuzzy_max_distance(size_t query_length)
+{
+	return query_length < 3 ? 0 : std::max<unsigned int>(1, static_cast<unsigned int>(query_length / FUZZY_CHARS_PER_EDIT));
 }
\ No newline at end of file
@@ -1,703 +1,1048 @@
-#pragma once
-
-#include <queue>
-#include <ctime>
-#include <utility>
-#include "key.h"
-
-struct basic_tm : public std::tm
-{
-	private:
-	enum unit_code
-	{
-		TIME = 'T'
-	};
-
-	void set_fields(int, int, int);
-	void set_fields(std::string);
-
-	public:
-	basic_tm();
-	basic_tm(int, int, int);
-	basic_tm(std::string);
-	basic_tm(std::ifstream&);
-
-	int compare(basic_tm);
-
-	std::string to_string();
-	void print(std::ostream&, bool = true);
-	void store(std::ofstream&);
-};
-
-class seclevel_t : public printable_t
-{
-	public:
-	struct prevpwrd_t
-	{
-		private:
-		enum group_code
-		{
-			PASSWORD = 'P',
-			TIMESTAMP = 'T'
-		};
-
-		public:
-		key_t password;
-		basic_tm timestamp;
-
-		prevpwrd_t(key_t, basic_tm);
-		prevpwrd_t(std::ifstream&);
-
-		void store(std::ofstream&);
-	};
-
-	private:
-	enum group_code
-	{
-		BASIC = 'B',
-		PASSWORD = 'P',
-		PREV_PWRD = 'O',
-		UPDATE = 'U'
-	};
-
-	enum unit_code
-	{
-		CODE = 'C',
-		MONTHS = 'M'
-	};
-
-	std::string code;
-
-	secret_t* password;
-	std::queue<prevpwrd_t*> prev_passwords;
-
-	int months_valid;
-	basic_tm update_time;
-
-	void save_password(std::string);
-
-	public:
-	seclevel_t() {}
-	seclevel_t(std::string, int, int, int, int);
-	seclevel_t(std::string, std::string, int, int, int, int, std::string);
-	seclevel_t(std::ifstream&);
-	~seclevel_t();
-
-	void set_months_valid(int);
-	void set_update_time(int, int, int);
-	void set_password(std::string, std::string);
-	void clear_password(std::string);
-
-	std::string get_code();
-	std::string get_password(std::string);
-	basic_tm get_update_time();
-	bool has_password();
-	bool is_old_password(std::string);
-	bool is_expired();
-	void update_password(std::string, std::string);
-
-	void print(std::ostream&, std::string);
-	void print_long(std::ostream&, std::string);
-	void store(std::ofstream&);
-};
-
-class seclevel_manager_t
-{
-	enum group_code
-	{
-		SECLEVELS = 'L'
-	};
-
-	std::vector<seclevel_t*> security_levels;
-
-	std::string filename;
-
-	void read();
-
-	public:
-	seclevel_manager_t(std::string);
-	~seclevel_manager_t();
-
-	void add_seclevel(std::string, std::string, int, int, int, int, std::string);
-	void add_seclevel(std::string, int, int, int, int);
-	bool delete_seclevel(std::string);
-	bool set_seclevel_password(std::string, std::string, std::string);
-	bool clear_seclevel_password(std::string, std::string);
-
-	std::vector<seclevel_t*>::iterator find_seclevel(std::string);
-	bool is_end(std::vector<seclevel_t*>::iterator);
-	bool is_old_password(std::string, std::string);
-	std::vector<seclevel_t*> get_exp_passwords();
-
-	void print(std::ostream&, std::string);
-	void store();
-};
-
-void basic_tm::set_fields(int year, int month, int day)
-{
-	tm_year = year;
-	tm_mon = month;
-	tm_mday = day;
-}
-
-void basic_tm::set_fields(std::string str)
-{
-	if (str.length() == 10)
-		set_fields(std::stoi(str.substr(0, 4)), std::stoi(str.substr(5, 2)), std::stoi(str.substr(8, 2)));
-}
-
-/*
-	Generate basic_tm based on current date
-*/
-basic_tm::basic_tm()
-{
-	std::time_t now;
-	std::time(&now);
-	std::tm timeinfo;
-	localtime_s(&timeinfo, &now);
-	
-	set_fields(timeinfo.tm_year, timeinfo.tm_mon, timeinfo.tm_mday);
-}
-
-basic_tm::basic_tm(int year, int month, int day)
-{
-	set_fields(year, month, day);
-}
-
-/*
-	Converts YYYY/MM/DD-formatted string to tm
-*/
-basic_tm::basic_tm(std::string str)
-{
-	set_fields(str);
-}
-
-basic_tm::basic_tm(std::ifstream& input)
-{
-	if (input.is_open())
-	{
-		char unit_code;
-		while (!storage::is_eor(input) && storage::read_unit(unit_code, input))	// Read next unit code
-		{
-			std::string str_time;
-			switch (unit_code)
-			{
-				case TIME:
-					storage::read(str_time, input);
-					set_fields(str_time);
-			}
-		}
-
-		storage::consume_rs(input);
-	}
-}
-
-/*
-	Compares tm to another tm
-*/
-int basic_tm::compare(basic_tm other)
-{
-	if (tm_year > other.tm_year)	// Check for differences in year
-		return 1;
-	if (tm_year < other.tm_year)
-		return -1;
-
-	if (tm_mon > other.tm_mon)	// Check for differences in month
-		return 1;
-	if (tm_mon < other.tm_mon)
-		return -1;
-
-	if (tm_mday > other.tm_mday)	// Check for differences in day of the month
-		return 1;
-	if (tm_mday < other.tm_mday)
-		return -1;
-
-	return 0;	// If no differences, return 0
-}
-
-/*
-	Converts tm to YYYY/MM/DD format
-*/
-std::string basic_tm::to_string()
-{
-	std::string out = "";
-	std::string temp;
-
-	temp = std::to_string(tm_year);
-	for (unsigned int i = 0; i < 4 - temp.length(); i++)
-		out += "0";	// Pad with 0's as needed
-	out += temp + "/";
-
-	temp = std::to_string(tm_mon);
-	if (temp.length() < 2)
-		out += "0" + temp + "/";
-	else
-		out += temp + "/";
-
-	temp = std::to_string(tm_mday);
-	if (temp.length() < 2)
-		out += "0" + temp;
-	else
-		out += temp;
-
-	return out;
-}
-
-void basic_tm::print(std::ostream& output, bool newline)
-{
-	set_print(output);
-	output << to_string();
-	if (newline)
-		output << std::endl;
-}
-
-void basic_tm::store(std::ofstream& output)
-{
-	storage::store(TIME, to_string(), output);
-	storage::store_rs(output);
-}
-
-seclevel_t::prevpwrd_t::prevpwrd_t(key_t password, basic_tm timestamp)
-{
-	this->password = password;
-	this->timestamp = timestamp;
-}
-
-seclevel_t::prevpwrd_t::prevpwrd_t(std::ifstream& input)
-{
-	if (input.is_open())
-	{
-		char group_code;
-		while (!storage::is_eor(input) && storage::read_group(group_code, input))	// Read next group code
-		{
-			if (group_code == PASSWORD)
-				password = key_t(input);
-
-			if (group_code == TIMESTAMP)
-				timestamp = basic_tm(input);
-		}
-
-		storage::consume_rs(input);
-	}
-}
-
-void seclevel_t::prevpwrd_t::store(std::ofstream& output)
-{
-	storage::store_gs(PASSWORD, output);
-	password.store(output);
-
-	storage::store_gs(TIMESTAMP, output);
-	timestamp.store(output);
-
-	storage::store_rs(output);
-}
-
-void seclevel_t::save_password(std::string key)
-{
-	if (this->password)
-		prev_passwords.push(new prevpwrd_t(key_t(this->password->get_data(key)), basic_tm()));
-}
-
-seclevel_t::seclevel_t(std::string code, int months_valid, int update_year, int update_month, int update_day)
-{
-	this->code = code;
-	this->months_valid = months_valid;
-	set_update_time(update_year, update_month, update_day);
-	password = nullptr;
-}
-
-seclevel_t::seclevel_t(std::string code, std::string password, int months_valid, int update_year, int update_month, int update_day, std::string key)
-{
-	this->code = code;
-	this->months_valid = months_valid;
-	set_update_time(update_year, update_month, update_day);
-	this->password = new secret_t(password, key);
-}
-
-seclevel_t::seclevel_t(std::ifstream& input)
-{
-	password = nullptr;
-
-	if (input.is_open())
-	{
-		char group_code;
-		while (!storage::is_eor(input) && storage::read_group(group_code, input))	// Read next group code
-		{
-			if (group_code == BASIC)
-			{
-				char unit_code;
-				while (!storage::is_eog(input) && storage::read_unit(unit_code, input))	// Read next unit code
-				{
-					switch (unit_code)
-					{
-						case CODE:
-							storage::read(code, input);
-							break;
-						case MONTHS:
-							storage::read(months_valid, input);
-					}
-				}
-			}
-
-			if (group_code == UPDATE)
-				update_time = basic_tm(input);
-
-			if (group_code == PASSWORD)
-				password = new secret_t(input);
-
-			if (group_code == PREV_PWRD)
-			{
-				while (!storage::is_eor(input))
-					prev_passwords.push(new prevpwrd_t(input));
-
-				storage::consume_rs(input);	// There is an extra record separator since this list doesn't span the entire file
-			}
-		}
-
-		storage::consume_rs(input);
-	}
-}
-
-seclevel_t::~seclevel_t()
-{
-	if (password)
-		delete password;
-
-	for (int i = prev_passwords.size(); i > 0; i--)	 // With this setup, no extra variables are needed
-	{
-		delete prev_passwords.front();
-		prev_passwords.pop();
-	}
-}
-
-void seclevel_t::set_months_valid(int months_valid)
-{
-	this->months_valid = months_valid;
-}
-
-void seclevel_t::set_update_time(int year, int month, int day)
-{
-	update_time.tm_year = year;
-	update_time.tm_mon = month;
-	update_time.tm_mday = day;
-}
-
-void seclevel_t::set_password(std::string password, std::string key)
-{
-	save_password(key);
-	if (this->password)
-		delete this->password;
-	this->password = new secret_t(password, key);
-}
-
-void seclevel_t::clear_password(std::string key)
-{
-	save_password(key);
-	if (password)
-		delete password;
-	password = nullptr;
-}
-
-std::string seclevel_t::get_code()
-{
-	return code;
-}
-
-std::string seclevel_t::get_password(std::string key)
-{
-	if (password)
-		return password->get_data(key);
-	else
-		return std::string();
-}
-
-basic_tm seclevel_t::get_update_time()
-{
-	return update_time;
-}
-
-bool seclevel_t::has_password()
-{
-	if (password)
-		return true;
-	else
-		return false;
-}
-
-bool seclevel_t::is_old_password(std::string password)
-{
-	if (!has_password())
-		return false;
-
-	bool out = false;
-
-	for (unsigned int i = 0; i < prev_passwords.size(); i++)
-	{
-		if (prev_passwords.front()->password.equals(password))
-			out = true;	// Don't return here so the queue can get back to its original state
-
-		prev_passwords.push(prev_passwords.front());
-		prev_passwords.pop();
-	}
-
-	return out;
-}
-
-/*
-	Whether the date specified in update_time has been reached
-*/
-bool seclevel_t::is_expired()
-{
-	return update_time.compare(basic_tm()) <= 0;
-}
-
-void seclevel_t::update_password(std::string password, std::string key)
-{
-	basic_tm now = basic_tm();
-
-	while (months_valid > 0 && update_time.compare(now) <= 0)	// Advance update_time in months_valid increments until update_time is in the future
-	{
-		update_time.tm_mon += months_valid;
-		while (update_time.tm_mon > 12)
-		{
-			update_time.tm_mon -= 12;
-			update_time.tm_year++;
-		}
-	}
-
-	set_password(password, key);
-}
-
-void seclevel_t::print(std::ostream& output, std::string key)
-{
-	set_print(output);
-	output << get_code();
-	
-	if (password)
-		password->print(output, key, false);
-	else
-	{
-		set_print(output);
-		output << "No Password";
-	}
-
-	set_print(output);
-	get_update_time().print(output, false);
-	output << std::endl;
-}
-
-void seclevel_t::print_long(std::ostream& output, std::string key)
-{
-	print(output, key);
-
-	set_print(output);
-	output << "";
-	set_print(output);
-	output << "Update every " + std::to_string(months_valid) + " month" + (months_valid != 1 ? "s" : "");
-	output << std::endl;
-}
-
-void seclevel_t::store(std::ofstream& output)
-{
-	storage::store_gs(BASIC, output);
-	storage::store(CODE, code, output);
-	storage::store(MONTHS, months_valid, output);
-	
-	storage::store_gs(UPDATE, output);
-	update_time.store(output);
-
-	if (password)
-	{
-		storage::store_gs(PASSWORD, output);
-		password->store(output);
-	}
-
-	if (!prev_passwords.empty())
-	{
-		storage::store_gs(PREV_PWRD, output);
-		for (unsigned int i = 0; i < prev_passwords.size(); i++)
-		{
-			prev_passwords.front()->store(output);
-			prev_passwords.push(prev_passwords.front());	// Rotate through values
-			prev_passwords.pop();
-		}
-
-		storage::store_rs(output);	// Store an extra record separator since this list doesn't span the entire file
-	}
-
-	storage::store_rs(output);
-}
-
-/*
-	Read in security-level information from the file on record
-*/
-void seclevel_manager_t::read()
-{
-	std::ifstream file(filename, std::ios::binary);
-
-	if (file.is_open())
-	{
-		char group_code;
-		while (storage::read_group(group_code, file))	// Read next group code
-		{
-			if (group_code == SECLEVELS)
-			{
-				while (!storage::is_eor(file))	// Push all security-level records to security_levels
-					security_levels.push_back(new seclevel_t(file));
-
-				storage::consume_rs(file);
-			}
-		}
-
-		file.close();
-	}
-}
-
-seclevel_manager_t::seclevel_manager_t(std::string filename)
-{
-	this->filename = filename;
-	read();
-}
-
-seclevel_manager_t::~seclevel_manager_t()
-{
-	for (unsigned int i = 0; i < security_levels.size(); i++)
-	{
-		delete security_levels.at(i);
-	}
-
-	security_levels.clear();
-}
-
-void seclevel_manager_t::add_seclevel(std::string code, std::string password, int months_valid, int update_year, int update_month, int update_day, std::string key)
-{
-	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
-
-	if (is_end(it))
-		security_levels.push_back(new seclevel_t(code, password, months_valid, update_year, update_month, update_day, key));
-}
-
-void seclevel_manager_t::add_seclevel(std::string code, int months_valid, int update_year, int update_month, int update_day)
-{
-	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
-
-	if (is_end(it))
-		security_levels.push_back(new seclevel_t(code, months_valid, update_year, update_month, update_day));
-}
-
-bool seclevel_manager_t::delete_seclevel(std::string code)
-{
-	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
-
-	if (!is_end(it))
-	{
-		delete *it;
-		security_levels.erase(it);
-		return true;
-	}
-
-	return false;
-}
-
-bool seclevel_manager_t::set_seclevel_password(std::string code, std::string password, std::string key)
-{
-	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
-
-	if (!is_end(it))
-	{
-		(*it)->set_password(password, key);
-		return true;
-	}
-
-	return false;
-}
-
-bool seclevel_manager_t::clear_seclevel_password(std::string code, std::string key)
-{
-	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
-
-	if (!is_end(it))
-	{
-		(*it)->clear_password(key);
-		return true;
-	}
-
-	return false;
-}
-
-/*
-	Find security level with code fully matching the code parameter
-*/
-std::vector<seclevel_t*>::iterator seclevel_manager_t::find_seclevel(std::string code)
-{
-	std::vector<seclevel_t*>::iterator out;
-
-	for (out = security_levels.begin(); out < security_levels.end() && (*out)->get_code() != code; out++) {}
-
-	return out;
-}
-
-/*
-	Whether an iterator is at the end of the list of security levels
-*/
-bool seclevel_manager_t::is_end(std::vector<seclevel_t*>::iterator it)
-{
-	return it == security_levels.end();
-}
-
-/*
-	Whether a password matches a previous password for its security level
-*/
-bool seclevel_manager_t::is_old_password(std::string code, std::string password)
-{
-	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
-
-	if (!is_end(it))
-		return (*it)->is_old_password(password);
-
-	return false;
-}
-
-/*
-Return a list of security levels whose passwords are expired
-*/
-std::vector<seclevel_t*> seclevel_manager_t::get_exp_passwords()
-{
-	std::vector<seclevel_t*> out;
-
-	for (std::vector<seclevel_t*>::iterator it = security_levels.begin(); it < security_levels.end(); it++)
-		if ((*it)->is_expired())
-			out.push_back(*it);
-
-	return out;
-}
-
-void seclevel_manager_t::print(std::ostream& output, std::string key)
-{
-	for (unsigned int i = 0; i < security_levels.size(); i++)
-		security_levels.at(i)->print(output, key);
-}
-
-/*
-	Store security-level information in the file on record
-*/
-void seclevel_manager_t::store()
-{
-	std::ofstream file(filename, std::ios::trunc | std::ios::binary);
-
-	if (file.is_open())
-	{
-		if (!security_levels.empty())
-		{
-			storage::store_gs(SECLEVELS, file);
-			for (unsigned int i = 0; i < security_levels.size(); i++)
-			{
-				security_levels.at(i)->store(file);
-			}
-
-			storage::store_rs(file);
-		}
-
-		file.close();
-	}
+#pragma once
+
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include "key.h"
+#include "date.h"
+#include "generator.h"
+#include "output.h"
+
+#define DEFAULT_HISTORY_DEPTH 24	// Number of previous passwords a new security level remembers
+#define MAX_GENERATE_ATTEMPTS 100
+
+class seclevel_t : public printable_t
+{
+	public:
+	struct prevpwrd_t
+	{
+		private:
+		enum group_code
+		{
+			PASSWORD = 'P',
+			TIMESTAMP = 'T'
+		};
+
+		public:
+		key_t password;
+		date_t timestamp;
+
+		prevpwrd_t() {}
+		prevpwrd_t(key_t, date_t);
+		prevpwrd_t(std::ifstream&);
+
+		void store(std::ofstream&);
+	};
+
+	private:
+	enum group_code
+	{
+		BASIC = 'B',
+		PASSWORD = 'P',
+		PREV_PWRD = 'O',
+		UPDATE = 'U',
+		GENERATOR = 'G'
+	};
+
+	enum unit_code
+	{
+		CODE = 'C',
+		MONTHS = 'M',
+		DEPTH = 'D',
+		RETENTION = 'R',
+		SALT = 'S'
+	};
+
+	std::string code;
+
+	secret_t* password;
+	generator_t* generator;	// Policy for generating new passwords, if any
+
+	std::vector<prevpwrd_t> prev_passwords;	// Ring buffer of previous passwords, holding history_depth entries
+	unsigned int prev_start;	// Index of the oldest previous password
+	unsigned int prev_count;
+	std::unordered_multiset<int> prev_hashes;	// Hash values of previous passwords salted with history_salt
+	unsigned int legacy_count;	// Number of previous passwords with their own salt, stored before history_salt existed
+	std::string history_salt;
+	int history_depth;	// Maximum number of previous passwords to keep
+	int retention_months;	// How long to keep previous passwords, or 0 to keep them until they are pushed out
+
+	int months_valid;
+	date_t update_time;
+
+	void init_history();
+	prevpwrd_t& get_prev_password(unsigned int);
+	void push_prev_password(prevpwrd_t);
+	void pop_prev_password();
+	void prune_prev_passwords(date_t);
+	void save_password(std::string);
+	bool in_history(std::string);
+	void advance_update_time(date_t);
+
+	public:
+	seclevel_t() {}
+	seclevel_t(std::string, int, int, int, int);
+	seclevel_t(std::string, std::string, int, int, int, int, std::string);
+	seclevel_t(std::ifstream&);
+	~seclevel_t();
+
+	void set_months_valid(int);
+	void set_history_policy(int, int);
+	void set_generator(generator_t*);
+	void set_update_time(int, int, int);
+	void set_password(std::string, std::string);
+	void clear_password(std::string);
+
+	std::string get_code();
+	int get_months_valid();
+	std::string get_password(std::string);
+	date_t get_update_time();
+	bool has_password();
+	generator_t* get_generator();
+	std::string generate_password();
+	std::vector<std::string> generate_passwords(unsigned int);
+	bool is_old_password(std::string);
+	bool is_expired(date_t);
+	void update_password(std::string, std::string);
+	void record_passwords(const std::vector<std::string>&);
+
+	using printable_t::print;
+	void print(table_writer_t&, std::string);
+	void print_long(std::ostream&, std::string);
+	void write(json_writer_t&, std::string);
+	void store(std::ofstream&);
+	void account_memory(memory_report_t&);
+};
+
+class seclevel_manager_t
+{
+	enum group_code
+	{
+		SECLEVELS = 'L'
+	};
+
+	std::vector<seclevel_t*> security_levels;
+	std::set<std::pair<int32_t, seclevel_t*>> schedule;	// Security levels ordered by the date their passwords expire, keyed by date_t::get_days()
+
+	std::string filename;
+
+	void read();
+	void schedule_seclevel(seclevel_t*);
+	void unschedule_seclevel(seclevel_t*);
+
+	public:
+	seclevel_manager_t(std::string);
+	~seclevel_manager_t();
+
+	void add_seclevel(std::string, std::string, int, int, int, int, std::string);
+	void add_seclevel(std::string, int, int, int, int);
+	bool delete_seclevel(std::string);
+	bool set_seclevel_password(std::string, std::string, std::string);
+	bool clear_seclevel_password(std::string, std::string);
+	bool set_update_time(std::string, int, int, int);
+	bool set_history_policy(std::string, int, int);
+	bool set_generator(std::string, generator_t*);
+	void update_password(seclevel_t*, std::string, std::string);
+	void record_passwords(seclevel_t*, const std::vector<std::string>&);
+
+	std::vector<seclevel_t*>::iterator find_seclevel(std::string);
+	std::vector<seclevel_t*> get_seclevels();
+	bool is_end(std::vector<seclevel_t*>::iterator);
+	bool is_old_password(std::string, std::string);
+	std::vector<seclevel_t*> get_exp_passwords();
+	std::vector<seclevel_t*> get_due_seclevels(date_t, date_t);
+	seclevel_t* get_next_due();
+
+	void print(std::ostream&, std::string);
+	void write(std::ostream&, std::string);
+	bool store();
+	void store(commit_t&);
+	void account_memory(memory_report_t&);
+};
+
+seclevel_t::prevpwrd_t::prevpwrd_t(key_t password, date_t timestamp)
+{
+	this->password = password;
+	this->timestamp = timestamp;
+}
+
+seclevel_t::prevpwrd_t::prevpwrd_t(std::ifstream& input)
+{
+	if (input.is_open())
+	{
+		char group_code;
+		while (!storage::is_eor(input) && storage::read_group(group_code, input))	// Read next group code
+		{
+			if (group_code == PASSWORD)
+				password = key_t(input);
+
+			if (group_code == TIMESTAMP)
+				timestamp = date_t(input);
+		}
+
+		storage::consume_rs(input);
+	}
+}
+
+void seclevel_t::prevpwrd_t::store(std::ofstream& output)
+{
+	storage::store_gs(PASSWORD, output);
+	password.store(output);
+
+	storage::store_gs(TIMESTAMP, output);
+	timestamp.store(output);
+
+	storage::store_rs(output);
+}
+
+/*
+	Set up an empty password history with the default policy
+*/
+void seclevel_t::init_history()
+{
+	prev_passwords.assign(DEFAULT_HISTORY_DEPTH, prevpwrd_t());
+	prev_start = 0;
+	prev_count = 0;
+	legacy_count = 0;
+	history_salt = key_t::generate_salt();
+	history_depth = DEFAULT_HISTORY_DEPTH;
+	retention_months = 0;
+}
+
+/*
+	Return a previous password by age, where 0 is the oldest
+*/
+seclevel_t::prevpwrd_t& seclevel_t::get_prev_password(unsigned int i)
+{
+	return prev_passwords.at((prev_start + i) % history_depth);
+}
+
+/*
+	Add a previous password to the history, pushing out the oldest one if the history is full
+*/
+void seclevel_t::push_prev_password(prevpwrd_t prev_password)
+{
+	if (history_depth <= 0)
+		return;
+
+	if (prev_count == (unsigned int)history_depth)
+		pop_prev_password();
+
+	prev_passwords.at((prev_start + prev_count) % history_depth) = prev_password;
+	prev_count++;
+
+	if (prev_password.password.has_salt(history_salt))
+		prev_hashes.insert(prev_password.password.get_value());
+	else
+		legacy_count++;
+}
+
+void seclevel_t::pop_prev_password()
+{
+	prevpwrd_t& oldest = get_prev_password(0);
+
+	if (oldest.password.has_salt(history_salt))
+		prev_hashes.erase(prev_hashes.find(oldest.password.get_value()));
+	else
+		legacy_count--;
+
+	oldest = prevpwrd_t();
+	prev_start = (prev_start + 1) % history_depth;
+	prev_count--;
+}
+
+/*
+	Drop previous passwords older than the retention period
+*/
+void seclevel_t::prune_prev_passwords(date_t today)
+{
+	if (retention_months <= 0)
+		return;
+
+	while (prev_count > 0 && get_prev_password(0).timestamp.add_months(retention_months) < today)
+		pop_prev_password();
+}
+
+void seclevel_t::save_password(std::string key)
+{
+	if (this->password)
+	{
+		date_t today = date_t::today();
+		push_prev_password(prevpwrd_t(key_t(this->password->get_data(key), history_salt), today));
+		prune_prev_passwords(today);
+	}
+}
+
+seclevel_t::seclevel_t(std::string code, int months_valid, int update_year, int update_month, int update_day)
+{
+	this->code = code;
+	this->months_valid = months_valid;
+	set_update_time(update_year, update_month, update_day);
+	password = nullptr;
+	generator = nullptr;
+	init_history();
+}
+
+seclevel_t::seclevel_t(std::string code, std::string password, int months_valid, int update_year, int update_month, int update_day, std::string key)
+{
+	this->code = code;
+	this->months_valid = months_valid;
+	set_update_time(update_year, update_month, update_day);
+	this->password = new secret_t(password, key);
+	generator = nullptr;
+	init_history();
+}
+
+seclevel_t::seclevel_t(std::ifstream& input)
+{
+	password = nullptr;
+	generator = nullptr;
+	init_history();
+
+	int depth = history_depth;
+	std::string salt;
+	std::vector<prevpwrd_t> loaded;	// The policy has to be known before the ring buffer can be filled
+
+	if (input.is_open())
+	{
+		char group_code;
+		while (!storage::is_eor(input) && storage::read_group(group_code, input))	// Read next group code
+		{
+			if (group_code == BASIC)
+			{
+				char unit_code;
+				while (!storage::is_eog(input) && storage::read_unit(unit_code, input))	// Read next unit code
+				{
+					switch (unit_code)
+					{
+						case CODE:
+							storage::read(code, input);
+							break;
+						case MONTHS:
+							storage::read(months_valid, input);
+							break;
+						case DEPTH:
+							storage::read(depth, input);
+							break;
+						case RETENTION:
+							storage::read(retention_months, input);
+							break;
+						case SALT:
+							storage::read(salt, input);
+					}
+				}
+			}
+
+			if (group_code == UPDATE)
+				update_time = date_t(input);
+
+			if (group_code == PASSWORD)
+				password = new secret_t(input);
+
+			if (group_code == GENERATOR)
+				generator = new generator_t(input);
+
+			if (group_code == PREV_PWRD)
+			{
+				while (!storage::is_eor(input))
+					loaded.push_back(prevpwrd_t(input));
+
+				storage::consume_rs(input);	// There is an extra record separator since this list doesn't span the entire file
+			}
+		}
+
+		storage::consume_rs(input);
+	}
+
+	if (!salt.empty())	// Files from before the history had its own salt keep the freshly generated one
+		history_salt = salt;
+
+	set_history_policy(depth, retention_months);
+
+	for (unsigned int i = 0; i < loaded.size(); i++)
+		push_prev_password(loaded.at(i));
+
+	prune_prev_passwords(date_t::today());
+}
+
+seclevel_t::~seclevel_t()
+{
+	if (password)
+		delete password;
+
+	if (generator)
+		delete generator;
+}
+
+void seclevel_t::set_months_valid(int months_valid)
+{
+	this->months_valid = months_valid;
+}
+
+/*
+	Change how many previous passwords are kept and for how many months, keeping the newest ones that still fit
+*/
+void seclevel_t::set_history_policy(int depth, int retention_months)
+{
+	std::vector<prevpwrd_t> kept;
+	for (unsigned int i = 0; i < prev_count; i++)
+		kept.push_back(get_prev_password(i));
+
+	prev_passwords.assign(std::max(depth, 0), prevpwrd_t());
+	prev_start = 0;
+	prev_count = 0;
+	prev_hashes.clear();
+	legacy_count = 0;
+	history_depth = std::max(depth, 0);
+	this->retention_months = retention_months;
+
+	for (unsigned int i = 0; i < kept.size(); i++)
+		push_prev_password(kept.at(i));
+
+	prune_prev_passwords(date_t::today());
+}
+
+/*
+	Replace the password generator, taking ownership of it. Passing nullptr removes it.
+*/
+void seclevel_t::set_generator(generator_t* generator)
+{
+	if (this->generator)
+		delete this->generator;
+	this->generator = generator;
+}
+
+void seclevel_t::set_update_time(int year, int month, int day)
+{
+	update_time = date_t(year, month, day);
+}
+
+void seclevel_t::set_password(std::string password, std::string key)
+{
+	save_password(key);
+	if (this->password)
+		delete this->password;
+	this->password = new secret_t(password, key);
+}
+
+void seclevel_t::clear_password(std::string key)
+{
+	save_password(key);
+	if (password)
+		delete password;
+	password = nullptr;
+}
+
+std::string seclevel_t::get_code()
+{
+	return code;
+}
+
+int seclevel_t::get_months_valid()
+{
+	return months_valid;
+}
+
+std::string seclevel_t::get_password(std::string key)
+{
+	if (password)
+		return password->get_data(key);
+	else
+		return std::string();
+}
+
+date_t seclevel_t::get_update_time()
+{
+	return update_time;
+}
+
+bool seclevel_t::has_password()
+{
+	if (password)
+		return true;
+	else
+		return false;
+}
+
+generator_t* seclevel_t::get_generator()
+{
+	return generator;
+}
+
+/*
+	Generate a password that is not among the previous passwords, or return an empty string if there is no usable generator
+*/
+std::string seclevel_t::generate_password()
+{
+	for (int attempts = 0; generator && attempts < MAX_GENERATE_ATTEMPTS; attempts++)	// Small policies can run out of passwords that haven't been used
+	{
+		std::string out = generator->generate();
+		if (out.empty() || !is_old_password(out))
+			return out;
+	}
+
+	return std::string();
+}
+
+/*
+	Generate a batch of distinct passwords that are not among the previous passwords, or return an empty list if there is no usable generator
+*/
+std::vector<std::string> seclevel_t::generate_passwords(unsigned int count)
+{
+	std::vector<std::string> out;
+	if (!generator)
+		return out;
+
+	out = generator->generate(count);	// One policy check for the whole batch
+	if (out.size() != count)
+		return std::vector<std::string>();
+
+	std::unordered_set<std::string> seen;
+
+	for (unsigned int i = 0; i < out.size(); i++)	// Only passwords that were issued before or repeat within the batch are generated again
+	{
+		for (int attempts = 0; in_history(out.at(i)) || seen.count(out.at(i)); attempts++)
+		{
+			if (attempts == MAX_GENERATE_ATTEMPTS)
+				return std::vector<std::string>();
+
+			out.at(i) = generator->generate();
+			if (out.at(i).empty())
+				return std::vector<std::string>();
+		}
+
+		seen.insert(out.at(i));
+	}
+
+	return out;
+}
+
+bool seclevel_t::is_old_password(std::string password)
+{
+	return has_password() && in_history(password);
+}
+
+/*
+	Whether a password is among the previous passwords, whether or not the security level has a password of its own
+*/
+bool seclevel_t::in_history(std::string password)
+{
+	if (prev_hashes.count(key_t(password, history_salt).get_value()))	// Hashing once under the shared salt covers every entry but legacy ones
+		return true;
+
+	for (unsigned int i = 0; legacy_count > 0 && i < prev_count; i++)
+	{
+		prevpwrd_t& prev_password = get_prev_password(i);
+		if (!prev_password.password.has_salt(history_salt) && prev_password.password.equals(password))
+			return true;
+	}
+
+	return false;
+}
+
+/*
+	Whether the date specified in update_time has been reached, given today's date
+*/
+bool seclevel_t::is_expired(date_t today)
+{
+	return update_time <= today;
+}
+
+void seclevel_t::update_password(std::string password, std::string key)
+{
+	advance_update_time(date_t::today());
+	set_password(password, key);
+}
+
+/*
+	Record passwords generated for the members of the security level in its history, and move its update time forward as if its password was updated
+*/
+void seclevel_t::record_passwords(const std::vector<std::string>& passwords)
+{
+	date_t today = date_t::today();
+
+	advance_update_time(today);
+
+	for (unsigned int i = 0; i < passwords.size(); i++)
+		push_prev_password(prevpwrd_t(key_t(passwords.at(i), history_salt), today));
+	prune_prev_passwords(today);
+}
+
+/*
+	Advance update_time by whole update periods until it is in the future
+*/
+void seclevel_t::advance_update_time(date_t today)
+{
+	if (months_valid <= 0 || today < update_time)
+		return;
+
+	int periods = std::max(1, today.months_since(update_time) / months_valid);	// Jump straight to about today rather than one period at a time
+
+	while (update_time.add_months(periods * months_valid) <= today)
+		periods++;
+
+	update_time = update_time.add_months(periods * months_valid);	// A single step from the original date keeps its day of the month
+}
+
+void seclevel_t::print(table_writer_t& output, std::string key)
+{
+	output.cell(get_code());
+
+	if (password)
+		password->print(output, key);
+	else
+		output.cell("No Password");
+
+	output.cell(get_update_time().to_string());
+	output.end_row();
+}
+
+/*
+	Print with a row for each setting below
+*/
+void seclevel_t::print_long(std::ostream& stream, std::string key)
+{
+	std::string buffer;
+	table_writer_t output(buffer, &stream);
+
+	print(output, key);
+
+	output.cell("");
+	output.cell("Update every " + std::to_string(months_valid) + " month" + (months_valid != 1 ? "s" : ""));
+	output.end_row();
+
+	output.cell("");
+	output.cell("Remember " + std::to_string(history_depth) + " password" + (history_depth != 1 ? "s" : "") + (retention_months > 0 ? " for " + std::to_string(retention_months) + " month" + (retention_months != 1 ? "s" : "") : ""));
+	output.end_row();
+
+	if (generator)
+	{
+		output.cell("");
+		output.cell(generator->describe());
+		output.end_row();
+	}
+}
+
+/*
+	Write as a JSON object, with the settings print_long describes. The password and generator are null when there are none.
+*/
+void seclevel_t::write(json_writer_t& output, std::string key)
+{
+	output.begin_object();
+	output.key("code").value(get_code());
+
+	if (password)
+		output.key("password").value(get_password(key));
+	else
+		output.key("password").null();
+
+	output.key("update").value(get_update_time().to_string());
+	output.key("months_valid").value(static_cast<long long>(months_valid));
+	output.key("history_depth").value(static_cast<long long>(history_depth));
+	output.key("retention_months").value(static_cast<long long>(retention_months));
+
+	if (generator)
+		output.key("generator").value(generator->describe());
+	else
+		output.key("generator").null();
+
+	output.end_object();
+}
+
+void seclevel_t::store(std::ofstream& output)
+{
+	storage::store_gs(BASIC, output);
+	storage::store(CODE, code, output);
+	storage::store(MONTHS, months_valid, output);
+	storage::store(DEPTH, history_depth, output);
+	storage::store(RETENTION, retention_months, output);
+	storage::store(SALT, history_salt, output);
+
+	storage::store_gs(UPDATE, output);
+	update_time.store(output);
+
+	if (password)
+	{
+		storage::store_gs(PASSWORD, output);
+		password->store(output);
+	}
+
+	if (generator)
+	{
+		storage::store_gs(GENERATOR, output);
+		generator->store(output);
+	}
+
+	if (prev_count > 0)
+	{
+		storage::store_gs(PREV_PWRD, output);
+		for (unsigned int i = 0; i < prev_count; i++)	// Oldest first, so reading pushes them back in the same order
+			get_prev_password(i).store(output);
+
+		storage::store_rs(output);	// Store an extra record separator since this list doesn't span the entire file
+	}
+
+	storage::store_rs(output);
+}
+
+/*
+	Add the security level, its password history, and its generator to a memory report. The hashes of previous passwords only speed up is_old_password, so they are counted as a cache.
+*/
+void seclevel_t::account_memory(memory_report_t& report)
+{
+	size_t bytes = sizeof(seclevel_t) + heap_bytes_of(code) + heap_bytes_of(history_salt) + heap_bytes_of(prev_passwords);
+
+	for (unsigned int i = 0; i < prev_passwords.size(); i++)
+		bytes += prev_passwords.at(i).password.get_heap_bytes();
+	if (generator)
+		bytes += sizeof(generator_t);
+
+	report.add(SECLEVELS_MEMORY, 1, bytes);
+	if (password)
+		report.add(SECRETS_MEMORY, 1, sizeof(secret_t));
+	report.add(CACHES_MEMORY, prev_hashes.size(), heap_bytes_of(prev_hashes));
+}
+
+/*
+	Read in security-level information from the file on record
+*/
+void seclevel_manager_t::read()
+{
+	phase_timer_t timer("seclevel load");
+	TRACE_SPAN("seclevel_manager_t::read");
+	std::ifstream file(filename, std::ios::binary);
+	profile_read(file);
+
+	if (file.is_open())
+	{
+		char group_code;
+		while (storage::read_group(group_code, file))	// Read next group code
+		{
+			if (group_code == GENERATION)	// Only the generation follows, and its bytes aren't groups
+				break;
+
+			if (group_code == SECLEVELS)
+			{
+				while (!storage::is_eor(file))	// Push all security-level records to security_levels
+				{
+					security_levels.push_back(new seclevel_t(file));
+					schedule_seclevel(security_levels.back());
+				}
+
+				storage::consume_rs(file);
+			}
+		}
+
+		file.close();
+	}
+}
+
+void seclevel_manager_t::schedule_seclevel(seclevel_t* seclevel)
+{
+	schedule.insert(std::make_pair(seclevel->get_update_time().get_days(), seclevel));
+}
+
+/*
+	Remove a security level from the schedule, before its update time changes or it is deleted
+*/
+void seclevel_manager_t::unschedule_seclevel(seclevel_t* seclevel)
+{
+	schedule.erase(std::make_pair(seclevel->get_update_time().get_days(), seclevel));
+}
+
+seclevel_manager_t::seclevel_manager_t(std::string filename)
+{
+	this->filename = filename;
+	read();
+}
+
+seclevel_manager_t::~seclevel_manager_t()
+{
+	for (unsigned int i = 0; i < security_levels.size(); i++)
+	{
+		delete security_levels.at(i);
+	}
+
+	security_levels.clear();
+}
+
+void seclevel_manager_t::add_seclevel(std::string code, std::string password, int months_valid, int update_year, int update_month, int update_day, std::string key)
+{
+	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
+
+	if (is_end(it))
+	{
+		security_levels.push_back(new seclevel_t(code, password, months_valid, update_year, update_month, update_day, key));
+		schedule_seclevel(security_levels.back());
+	}
+}
+
+void seclevel_manager_t::add_seclevel(std::string code, int months_valid, int update_year, int update_month, int update_day)
+{
+	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
+
+	if (is_end(it))
+	{
+		security_levels.push_back(new seclevel_t(code, months_valid, update_year, update_month, update_day));
+		schedule_seclevel(security_levels.back());
+	}
+}
+
+bool seclevel_manager_t::delete_seclevel(std::string code)
+{
+	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
+
+	if (!is_end(it))
+	{
+		unschedule_seclevel(*it);
+		delete *it;
+		security_levels.erase(it);
+		return true;
+	}
+
+	return false;
+}
+
+bool seclevel_manager_t::set_seclevel_password(std::string code, std::string password, std::string key)
+{
+	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
+
+	if (!is_end(it))
+	{
+		(*it)->set_password(password, key);
+		return true;
+	}
+
+	return false;
+}
+
+bool seclevel_manager_t::clear_seclevel_password(std::string code, std::string key)
+{
+	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
+
+	if (!is_end(it))
+	{
+		(*it)->clear_password(key);
+		return true;
+	}
+
+	return false;
+}
+
+bool seclevel_manager_t::set_update_time(std::string code, int year, int month, int day)
+{
+	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
+
+	if (!is_end(it))
+	{
+		unschedule_seclevel(*it);
+		(*it)->set_update_time(year, month, day);
+		schedule_seclevel(*it);
+		return true;
+	}
+
+	return false;
+}
+
+bool seclevel_manager_t::set_history_policy(std::string code, int depth, int retention_months)
+{
+	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
+
+	if (!is_end(it))
+	{
+		(*it)->set_history_policy(depth, retention_months);
+		return true;
+	}
+
+	return false;
+}
+
+bool seclevel_manager_t::set_generator(std::string code, generator_t* generator)
+{
+	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
+
+	if (!is_end(it))
+	{
+		(*it)->set_generator(generator);
+		return true;
+	}
+
+	delete generator;
+	return false;
+}
+
+/*
+	Replace the password of a security level and move its update time forward
+*/
+void seclevel_manager_t::update_password(seclevel_t* seclevel, std::string password, std::string key)
+{
+	unschedule_seclevel(seclevel);
+	seclevel->update_password(password, key);
+	schedule_seclevel(seclevel);
+}
+
+/*
+	Record the passwords generated for the members of a security level and move its update time forward
+*/
+void seclevel_manager_t::record_passwords(seclevel_t* seclevel, const std::vector<std::string>& passwords)
+{
+	unschedule_seclevel(seclevel);
+	seclevel->record_passwords(passwords);
+	schedule_seclevel(seclevel);
+}
+
+/*
+	Find security level with code fully matching the code parameter
+*/
+std::vector<seclevel_t*>::iterator seclevel_manager_t::find_seclevel(std::string code)
+{
+	std::vector<seclevel_t*>::iterator out;
+
+	for (out = security_levels.begin(); out < security_levels.end() && (*out)->get_code() != code; out++) {}
+
+	return out;
+}
+
+std::vector<seclevel_t*> seclevel_manager_t::get_seclevels()
+{
+	return security_levels;
+}
+
+/*
+	Whether an iterator is at the end of the list of security levels
+*/
+bool seclevel_manager_t::is_end(std::vector<seclevel_t*>::iterator it)
+{
+	return it == security_levels.end();
+}
+
+/*
+	Whether a password matches a previous password for its security level
+*/
+bool seclevel_manager_t::is_old_password(std::string code, std::string password)
+{
+	std::vector<seclevel_t*>::iterator it = find_seclevel(code);
+
+	if (!is_end(it))
+		return (*it)->is_old_password(password);
+
+	return false;
+}
+
+/*
+	Return a list of security levels whose passwords are expired, read off the front of the schedule
+*/
+std::vector<seclevel_t*> seclevel_manager_t::get_exp_passwords()
+{
+	std::vector<seclevel_t*> out;
+	date_t today = date_t::today();
+
+	for (std::set<std::pair<int32_t, seclevel_t*>>::iterator it = schedule.begin(); it != schedule.end() && it->second->is_expired(today); it++)
+		out.push_back(it->second);
+
+	return out;
+}
+
+/*
+	Return the security levels whose passwords expire between two dates, inclusive, in the order they expire
+*/
+std::vector<seclevel_t*> seclevel_manager_t::get_due_seclevels(date_t from, date_t to)
+{
+	std::vector<seclevel_t*> out;
+	std::set<std::pair<int32_t, seclevel_t*>>::iterator it = schedule.lower_bound(std::make_pair(from.get_days(), static_cast<seclevel_t*>(nullptr)));
+
+	for (; it != schedule.end() && it->first <= to.get_days(); it++)
+		out.push_back(it->second);
+
+	return out;
+}
+
+/*
+	Return the security level whose password expires next, or nullptr if there are none
+*/
+seclevel_t* seclevel_manager_t::get_next_due()
+{
+	return schedule.empty() ? nullptr : schedule.begin()->second;
+}
+
+void seclevel_manager_t::print(std::ostream& stream, std::string key)
+{
+	std::string buffer;
+	table_writer_t output(buffer, &stream);
+
+	for (unsigned int i = 0; i < security_levels.size(); i++)
+		security_levels.at(i)->print(output, key);
+}
+
+/*
+	Write every security level in the output format, as print would
+*/
+void seclevel_manager_t::write(std::ostream& output, std::string key)
+{
+	std::string buffer;
+	json_writer_t writer(buffer, &output);
+
+	if (output_format == JSON)
+		writer.begin_array();
+
+	for (unsigned int i = 0; i < security_levels.size(); i++)
+	{
+		security_levels.at(i)->write(writer, key);
+		if (output_format == NDJSON)
+			writer.end_line();
+	}
+
+	if (output_format == JSON)
+	{
+		writer.end_array();
+		writer.end_line();
+	}
+}
+
+/*
+	Store security levels in the file on record, replacing it in one step
+*/
+bool seclevel_manager_t::store()
+{
+	commit_t commit;
+
+	store(commit);
+	return commit.commit();
+}
+
+/*
+	Stage the security levels as part of a larger commit
+*/
+void seclevel_manager_t::store(commit_t& commit)
+{
+	phase_timer_t timer("save seclevels");
+	TRACE_SPAN("seclevel_manager_t::store");
+	std::ofstream& file = commit.stage(filename);
+
+	if (file.is_open())
+	{
+		if (!security_levels.empty())
+		{
+			storage::store_gs(SECLEVELS, file);
+			for (unsigned int i = 0; i < security_levels.size(); i++)
+			{
+				security_levels.at(i)->store(file);
+			}
+
+			storage::store_rs(file);
+		}
+
+		profile_written(file);
+	}
+}
+
+/*
+	Add every security level and the manager's list and schedule to a memory report
+*/
+void seclevel_manager_t::account_memory(memory_report_t& report)
+{
+	for (unsigned int i = 0; i < security_levels.size(); i++)
+		security_levels.at(i)->account_memory(report);
+
+	report.add(INDEXES_MEMORY, schedule.size(), heap_bytes_of(security_levels) + heap_bytes_of(schedule));
 }
\ No newline at end of file
@@ -1,634 +1,1538 @@
-#pragma once
-
-#include <stdlib.h>
-#include <time.h>
-#include "key.h"
-#include "seclevel.h"
-#include "credentials.h"
-
-/*
-	An object to streamline user interaction with credentials
-*/
-class session_t
-{
-	enum group_code
-	{
-		KEY = 'K',
-		CREDENTIALS = 'C'
-	};
-
-	std::string key;	// Program key
-	std::string crypt_key;	// Encryption key
-	bool logged_in = false;
-	std::vector<credentials_t*> credentials_list;
-	seclevel_manager_t* seclevel_manager;
-
-	std::string keystore_filename;
-
-	public:
-	session_t(std::string, std::string, std::string);
-	session_t(std::string, std::string, std::string, std::string);
-	~session_t();
-
-	bool login(std::string);
-	void logout();
-
-	void add_credentials(std::string, std::string, std::string, seclevel_t* = nullptr);
-	void add_credentials(std::string, std::string, seclevel_t*);
-	void add_credentials(std::string, std::string, std::string, std::initializer_list<std::pair<std::string, std::string>>, std::initializer_list<std::string>);
-	bool modify_credentials(std::string, std::string, std::string);
-	int set_security_level(std::string, std::vector<std::string>);
-	bool set_security_level(std::string, seclevel_t*);
-	bool add_questions(std::string, std::vector<std::pair<std::string, std::string>>);
-	int delete_questions(std::string, std::vector<std::string>);
-	bool delete_question(std::string, int);
-	bool add_backups(std::string, std::vector<std::string>);
-	int delete_backups(std::string, std::vector<std::string>);
-	bool delete_backup(std::string, int);
-	bool delete_credentials(std::string);
-
-	void set_key(std::string);
-
-	void add_seclevel(std::string, std::string, int, int, int, int);
-	void add_seclevel(std::string, int, int, int, int);
-	bool delete_seclevel(std::string);
-	bool set_seclevel_password(std::string, std::string);
-	bool clear_seclevel_password(std::string);
-	std::vector<credentials_t*> get_old_passwords();
-	std::vector<seclevel_t*> get_exp_passwords();
-	bool update_password(credentials_t*);
-	void update_seclevel(seclevel_t*, std::string);
-
-	std::vector<credentials_t*>::iterator find_credentials(std::string);
-	bool is_end(std::vector<credentials_t*>::iterator);
-	std::string get_crypt_key();
-	seclevel_t* find_seclevel(std::string);
-	bool is_logged_in();
-	bool are_credentials_loaded();
-	
-	void print_credentials();
-	void print_questions(std::string);
-	void print_backups(std::string);
-	void print_seclevels();
-	void search_credentials(std::string);
-
-	bool read(std::string);
-	void store(std::string);
-	void store_credentials(std::string);
-	void store_seclevels();
-	void unload();
-};
-
-/*
-	Create session without reading credentials and log in
-*/
-session_t::session_t(std::string key, std::string keystore_filename, std::string seclevel_filename)
-{
-	srand(static_cast<unsigned int>(std::time(nullptr)));
-
-	this->keystore_filename = keystore_filename;
-	login(key);
-	seclevel_manager = new seclevel_manager_t(seclevel_filename);
-}
-
-/*
-	Create session and log in
-*/
-session_t::session_t(std::string key, std::string credentials_filename, std::string keystore_filename, std::string seclevel_filename)
-{
-	srand(static_cast<unsigned int>(std::time(nullptr)));
-
-	this->keystore_filename = keystore_filename;
-	login(key);
-	seclevel_manager = new seclevel_manager_t(seclevel_filename);
-	read(credentials_filename);
-}
-
-session_t::~session_t()
-{
-	unload();
-	delete seclevel_manager;
-}
-
-/*
-	Log in using the provided key
-*/
-bool session_t::login(std::string key)
-{
-	keystore_t keystore = keystore_t(keystore_filename);
-
-	logged_in = keystore.login(key);
-
-	if (logged_in)
-	{
-		this->key = key;
-		crypt_key = keystore.get_static_key(key);
-	}
-
-	return logged_in;
-}
-
-/*
-	Reset key information
-*/
-void session_t::logout()
-{
-	key = crypt_key = "";
-	logged_in = false;
-}
-
-void session_t::add_credentials(std::string name, std::string username, std::string password, seclevel_t* seclevel)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			(*it)->set_username(username);
-			(*it)->set_password(password, crypt_key);
-			(*it)->set_security_level(seclevel->get_code(), crypt_key);
-		}
-		else
-		{
-			if (seclevel)
-				credentials_list.push_back(new credentials_t(name, username, password, seclevel->get_code(), crypt_key));
-			else
-				credentials_list.push_back(new credentials_t(name, username, password, crypt_key));
-		}
-	}
-}
-
-void session_t::add_credentials(std::string name, std::string username, seclevel_t* seclevel)
-{
-	add_credentials(name, username, seclevel->get_password(crypt_key), seclevel);
-}
-
-/*
-	Add credentials with programmatic lists of secret questions and backup codes. The purpose of this function is to give more control to developers in testing.
-*/
-void session_t::add_credentials(std::string name, std::string username, std::string password, std::initializer_list<std::pair<std::string, std::string>> secret_questions, std::initializer_list<std::string> backup_codes)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			(*it)->set_username(username);
-			(*it)->set_password(password, crypt_key);
-			(*it)->add_questions(secret_questions, crypt_key);
-		}
-		else
-		{
-			credentials_list.push_back(new credentials_t(name, username, password, crypt_key, secret_questions, backup_codes));
-		}
-	}
-}
-
-bool session_t::modify_credentials(std::string name, std::string field, std::string value)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			switch (std::tolower(field[0]))
-			{
-				case 'n':	// Site name
-					(*it)->set_name(value);
-					return true;
-				case 'u':	// Username
-					(*it)->set_username(value);
-					return true;
-				case 'p':	// Password
-					(*it)->set_password(value, crypt_key);
-					return true;
-				case 'l':	// Security level
-					(*it)->set_security_level(value, crypt_key);
-					return true;
-			}
-		}
-	}
-
-	return false;
-}
-
-int session_t::set_security_level(std::string security_level, std::vector<std::string> names)
-{
-	int out = 0;
-
-	std::vector<credentials_t*>::iterator it;
-	for (unsigned int i = 0; i < names.size(); i++)
-	{
-		it = find_credentials(names.at(i));
-
-		if (it != credentials_list.end() && (*it)->set_security_level(security_level, crypt_key))
-			out++;
-	}
-
-	return out;
-}
-
-bool session_t::set_security_level(std::string name, seclevel_t* security_level)
-{
-	std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-	if (it != credentials_list.end() && (*it)->set_security_level(security_level, crypt_key))
-		return true;
-
-	return false;
-}
-
-bool session_t::add_questions(std::string name, std::vector<std::pair<std::string, std::string>> questions)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			(*it)->add_questions(questions, crypt_key);
-			return true;
-		}
-	}
-
-	return false;
-}
-
-int session_t::delete_questions(std::string name, std::vector<std::string> queries)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			return (*it)->delete_questions(queries);
-		}
-	}
-	
-	return 0;
-}
-
-bool session_t::delete_question(std::string name, int index)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			return (*it)->delete_question(index);
-		}
-	}
-
-	return false;
-}
-
-bool session_t::add_backups(std::string name, std::vector<std::string> backups)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			(*it)->add_backups(backups, crypt_key);
-			return true;
-		}
-	}
-
-	return false;
-}
-
-int session_t::delete_backups(std::string name, std::vector<std::string> queries)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			return (*it)->delete_backups(queries, crypt_key);
-		}
-		else
-		{
-			return 0;
-		}
-	}
-	else
-	{
-		return 0;
-	}
-}
-
-bool session_t::delete_backup(std::string name, int index)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			return (*it)->delete_backup(index);
-		}
-	}
-
-	return false;
-}
-
-bool session_t::delete_credentials(std::string name)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			delete *it;
-			credentials_list.erase(it);
-			return true;
-		}
-	}
-
-	return false;
-}
-
-/*
-	Set master key
-*/
-void session_t::set_key(std::string new_key)
-{
-	if (logged_in)
-	{
-		keystore_t(keystore_filename).set_key(new_key, key);
-	}
-}
-
-void session_t::add_seclevel(std::string code, std::string password, int months_valid, int update_year, int update_month, int update_day)
-{
-	seclevel_manager->add_seclevel(code, password, months_valid, update_year, update_month, update_day, crypt_key);
-}
-
-void session_t::add_seclevel(std::string code, int months_valid, int update_year, int update_month, int update_day)
-{
-	seclevel_manager->add_seclevel(code, months_valid, update_year, update_month, update_day);
-}
-
-bool session_t::delete_seclevel(std::string code)
-{
-	return seclevel_manager->delete_seclevel(code);
-}
-
-bool session_t::set_seclevel_password(std::string code, std::string password)
-{
-	return seclevel_manager->set_seclevel_password(code, password, crypt_key);
-}
-
-bool session_t::clear_seclevel_password(std::string code)
-{
-	return seclevel_manager->clear_seclevel_password(code, crypt_key);
-}
-
-/*
-	Return a list of credentials whose passwords match an older password for their security level
-*/
-std::vector<credentials_t*> session_t::get_old_passwords()
-{
-	std::vector<credentials_t*> out;
-
-	for (std::vector<credentials_t*>::iterator it = credentials_list.begin(); it < credentials_list.end(); it++)
-		if (seclevel_manager->is_old_password((*it)->get_security_level(crypt_key), (*it)->get_password(crypt_key)))
-			out.push_back(*it);
-
-	return out;
-}
-
-std::vector<seclevel_t*> session_t::get_exp_passwords()
-{
-	return seclevel_manager->get_exp_passwords();
-}
-
-bool session_t::update_password(credentials_t* credentials)
-{
-	seclevel_t* ptr = find_seclevel(credentials->get_security_level(crypt_key));	// Get security-level information to update the set of credentials
-	if (ptr)
-		return modify_credentials(credentials->get_name(), "p", ptr->get_password(crypt_key));
-	else
-		return false;
-}
-
-void session_t::update_seclevel(seclevel_t* seclevel, std::string password)
-{
-	seclevel->update_password(password, crypt_key);
-}
-
-/*
-	Find credentials with site name fully matching the name parameter
-*/
-std::vector<credentials_t*>::iterator session_t::find_credentials(std::string name)
-{
-	std::vector<credentials_t*>::iterator out;
-
-	for (out = credentials_list.begin(); out < credentials_list.end() && (*out)->get_name() != name; out++) {}
-
-	return out;
-}
-
-/*
-	Return whether the iterator points to the end of credentials_list
-*/
-bool session_t::is_end(std::vector<credentials_t*>::iterator it)
-{
-	return it == credentials_list.end();
-}
-
-std::string session_t::get_crypt_key()
-{
-	return crypt_key;
-}
-
-seclevel_t* session_t::find_seclevel(std::string code)
-{
-	std::vector<seclevel_t*>::iterator it = seclevel_manager->find_seclevel(code);
-
-	if (!seclevel_manager->is_end(it))
-		return *it;
-	else
-		return nullptr;
-}
-
-bool session_t::is_logged_in()
-{
-	return logged_in;
-}
-
-bool session_t::are_credentials_loaded()
-{
-	return !credentials_list.empty();
-}
-
-void session_t::print_credentials()
-{
-	for (unsigned int i = 0; i < credentials_list.size(); i++)
-	{
-		credentials_list.at(i)->print(std::cout, crypt_key);
-	}
-}
-
-/*
-	Print the secret questions of a set of credentials in an ordered list
-*/
-void session_t::print_questions(std::string name)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			std::vector<credentials_t::secquestion_t*> secret_questions = (*it)->get_questions();
-
-			for (unsigned int i = 0; i < secret_questions.size(); i++)
-			{
-				set_print(std::cout);
-				std::cout << (i + 1);
-				secret_questions.at(i)->print(std::cout, crypt_key);
-			}
-		}
-	}
-}
-
-/*
-	Print the backup codes of a set of credentials in an ordered list
-*/
-void session_t::print_backups(std::string name)
-{
-	if (logged_in)
-	{
-		std::vector<credentials_t*>::iterator it = find_credentials(name);
-
-		if (!is_end(it))
-		{
-			std::vector<secret_t*> backup_codes = (*it)->get_backups();
-
-			for (unsigned int i = 0; i < backup_codes.size(); i++)
-			{
-				set_print(std::cout);
-				std::cout << (i + 1);
-				backup_codes.at(i)->print(std::cout, crypt_key);
-			}
-		}
-	}
-}
-
-void session_t::print_seclevels()
-{
-	seclevel_manager->print(std::cout, crypt_key);
-}
-
-/*
-	Find credentials with the site name pattern-matching the query
-*/
-void session_t::search_credentials(std::string query)
-{
-	for (unsigned int i = 0; i < credentials_list.size(); i++)
-	{
-		if (lowercase_contains(credentials_list.at(i)->get_name(), query))	// For each site name that pattern-matches the query
-		{
-			credentials_list.at(i)->print(std::cout, crypt_key);
-		}
-	}
-}
-
-/*
-	Read in credentials from a file
-*/
-bool session_t::read(std::string filename)
-{
-	bool same_key = true;	// Assume that there is no key stored and, therefore, the file can be read (albeit in a less secure manner)
-	std::ifstream file(filename, std::ios::binary);
-
-	if (file.is_open())	// same_key will also stay true if the file isn't open
-	{
-		char group_code;
-		while (storage::read_group(group_code, file))	// Read next group code
-		{
-			if (group_code == KEY && logged_in)
-				same_key = key_t(file).equals(crypt_key);	// Read hashed key used to encrypt the credentials and check it against crypt_key
-
-			if (group_code == CREDENTIALS)
-			{
-				while (!storage::is_eor(file))	// Push all credential records to credentials_list
-					credentials_list.push_back(new credentials_t(file));
-
-				storage::consume_rs(file);	// There is an extra record separator since this list doesn't span the entire file
-			}
-		}
-
-		file.close();
-	}
-
-	if (!same_key)
-		unload();
-
-	return same_key;
-}
-
-/*
-	Store credentials in a file and security-level information in the file on record
-*/
-void session_t::store(std::string credentials_filename)
-{
-	store_credentials(credentials_filename);
-	store_seclevels();
-}
-
-/*
-	Store credentials in a file
-*/
-void session_t::store_credentials(std::string filename)
-{
-	std::ofstream file(filename, std::ios::trunc | std::ios::binary);
-
-	if (file.is_open())
-	{
-		if (!credentials_list.empty())
-		{
-			storage::store_gs(KEY, file);
-			key_t(crypt_key).store(file);	// Hash crypt_key and store
-
-			storage::store_gs(CREDENTIALS, file);
-			for (unsigned int i = 0; i < credentials_list.size(); i++)
-			{
-				credentials_list.at(i)->store(file);
-			}
-			storage::store_rs(file);	// Store an extra record separator since this list doesn't span the entire file
-		}
-
-		file.close();
-	}
-}
-
-/*
-	Store security-level information in the file on record
-*/
-void session_t::store_seclevels()
-{
-	seclevel_manager->store();
-}
-
-/*
-	Clear loaded credentials
-*/
-void session_t::unload()
-{
-	for (unsigned int i = 0; i < credentials_list.size(); i++)
-	{
-		delete credentials_list.at(i);
-	}
-
-	credentials_list.clear();
+#pragma once
+
+#include <stdlib.h>
+#include <time.h>
+#include <unordered_map>
+#include "key.h"
+#include "seclevel.h"
+#include "credentials.h"
+#include "domain.h"
+#include "trie.h"
+#include "query.h"
+#include "scan.h"
+#include "output.h"
+#include "metrics.h"
+#include "audit.h"
+#include "breach.h"
+#include "workload.h"
+
+/*
+	An object to streamline user interaction with credentials
+*/
+class session_t
+{
+	enum group_code
+	{
+		KEY = 'K',
+		CREDENTIALS = 'C'
+	};
+
+	std::string key;	// Program key
+	std::string crypt_key;	// Encryption key
+	bool logged_in = false;
+	std::vector<credentials_t*> credentials_list;
+	std::unordered_map<std::string, std::vector<credentials_t*>> domain_index;	// Credentials by the registrable domain of their site names
+	std::unordered_map<std::string, std::vector<credentials_t*>> seclevel_index;	// Credentials by security-level code, so the members of a level are known without decrypting every record
+	std::unordered_map<std::string, credentials_t*> name_index;	// Credentials by site name, so lookups don't scan the list
+	radix_trie_t name_trie;	// Site names, for completion
+	seclevel_manager_t* seclevel_manager;
+	radix_trie_t seclevel_trie;	// Security-level codes, for completion
+
+	std::string keystore_filename;
+
+	void index_credentials(credentials_t*);
+	void unindex_credentials(credentials_t*);
+	void index_members(std::vector<credentials_t*>);
+	void add_member(credentials_t*, std::string);
+	void remove_member(credentials_t*);
+	void index_seclevels();
+
+	public:
+	session_t(std::string, std::string, std::string);
+	session_t(std::string, std::string, std::string, std::string);
+	~session_t();
+
+	bool login(std::string);
+	void logout();
+
+	void add_credentials(std::string, std::string, std::string, seclevel_t* = nullptr);
+	void add_credentials(std::string, std::string, seclevel_t*);
+	void add_credentials(std::string, std::string, std::string, std::initializer_list<std::pair<std::string, std::string>>, std::initializer_list<std::string>);
+	bool modify_credentials(std::string, std::string, std::string);
+	int set_security_level(std::string, std::vector<std::string>);
+	bool set_security_level(std::string, seclevel_t*);
+	bool add_questions(std::string, std::vector<std::pair<std::string, std::string>>);
+	int delete_questions(std::string, std::vector<std::string>);
+	bool delete_question(std::string, int);
+	bool add_backups(std::string, std::vector<std::string>);
+	int delete_backups(std::string, std::vector<std::string>);
+	bool delete_backup(std::string, int);
+	bool delete_credentials(std::string);
+	std::vector<bool> delete_credentials(std::vector<std::string>);
+	void reserve_credentials(size_t);
+
+	void set_key(std::string);
+
+	void add_seclevel(std::string, std::string, int, int, int, int);
+	void add_seclevel(std::string, int, int, int, int);
+	bool delete_seclevel(std::string);
+	bool set_seclevel_password(std::string, std::string);
+	bool clear_seclevel_password(std::string);
+	bool set_seclevel_update_time(std::string, int, int, int);
+	bool set_seclevel_history(std::string, int, int);
+	bool set_seclevel_generator(std::string, generator_t*);
+	std::vector<credentials_t*> get_old_passwords();
+	std::vector<credentials_t*> get_members(std::string);
+	std::vector<credentials_t*> find_level_members(std::string);
+	std::vector<credentials_t*> in_list_order(const std::vector<credentials_t*>&);
+	int rotate_seclevel(std::string);
+	std::vector<seclevel_t*> get_exp_passwords();
+	std::vector<seclevel_t*> get_due_seclevels(date_t, date_t);
+	bool update_password(credentials_t*);
+	void update_seclevel(seclevel_t*, std::string);
+
+	std::vector<credentials_t*>::iterator find_credentials(std::string);
+	credentials_t* get_credentials(std::string);
+	bool has_credentials(std::string);
+	radix_trie_t& get_name_trie();
+	radix_trie_t& get_seclevel_trie();
+	std::vector<credentials_t*> find_domain(std::string);
+	std::vector<credentials_t*> fuzzy_find_credentials(std::string, unsigned int = FUZZY_MAX_RESULTS);
+	std::vector<credentials_t*> query_credentials(query_t&);
+	const std::vector<credentials_t*>& plan_query(query_t&);
+	std::unordered_set<std::string> get_expired_codes(query_t&);
+	bool matches_query(credentials_t*, query_t&, const std::unordered_set<std::string>&);
+	std::vector<std::string> suggest_names(std::string, unsigned int);
+	bool is_end(std::vector<credentials_t*>::iterator);
+	std::string get_crypt_key();
+	seclevel_t* find_seclevel(std::string);
+	bool is_logged_in();
+	bool are_credentials_loaded();
+	
+	void print_credentials();
+	void print_questions(std::string);
+	void print_backups(std::string);
+	void print_seclevels();
+	void print_due_seclevels(date_t, date_t);
+	void search_credentials(std::string);
+	void fuzzy_search_credentials(std::string);
+	void audit_credentials();
+	void check_breaches(breach_corpus_t&);
+	void print_memory();
+
+	bool read(std::string);
+	bool store(std::string);
+	bool store_credentials(std::string);
+	void store_credentials(commit_t&, std::string);
+	bool store_seclevels();
+	void unload();
+	void account_memory(memory_report_t&);
+};
+
+/*
+	Create session without reading credentials and log in
+*/
+session_t::session_t(std::string key, std::string keystore_filename, std::string seclevel_filename)
+{
+	srand(static_cast<unsigned int>(std::time(nullptr)));
+
+	this->keystore_filename = keystore_filename;
+	recover_commit({ seclevel_filename });
+	login(key);
+	seclevel_manager = new seclevel_manager_t(seclevel_filename);
+	index_seclevels();
+}
+
+/*
+	Create session and log in
+*/
+session_t::session_t(std::string key, std::string credentials_filename, std::string keystore_filename, std::string seclevel_filename)
+{
+	srand(static_cast<unsigned int>(std::time(nullptr)));
+
+	this->keystore_filename = keystore_filename;
+	recover_commit({ credentials_filename, seclevel_filename });	// Finish any save that was cut short before either file is read
+	login(key);
+	seclevel_manager = new seclevel_manager_t(seclevel_filename);
+	index_seclevels();
+	read(credentials_filename);
+}
+
+session_t::~session_t()
+{
+	unload();
+	delete seclevel_manager;
+}
+
+/*
+	Add credentials to the lookup indexes
+*/
+void session_t::index_credentials(credentials_t* credentials)
+{
+	std::string domain = registrable_domain(credentials->get_name());
+
+	if (!domain.empty())
+		domain_index[domain].push_back(credentials);
+
+	name_index.emplace(credentials->get_name(), credentials);	// The first of any credentials sharing a name is the one found
+	name_trie.insert(credentials->get_name());
+}
+
+/*
+	Remove credentials from the lookup indexes, before they are renamed or deleted
+*/
+void session_t::unindex_credentials(credentials_t* credentials)
+{
+	std::unordered_map<std::string, std::vector<credentials_t*>>::iterator it = domain_index.find(registrable_domain(credentials->get_name()));
+
+	if (it != domain_index.end())
+	{
+		it->second.erase(std::remove(it->second.begin(), it->second.end(), credentials), it->second.end());
+		if (it->second.empty())
+			domain_index.erase(it);
+	}
+
+	std::unordered_map<std::string, credentials_t*>::iterator named = name_index.find(credentials->get_name());
+	if (named != name_index.end() && named->second == credentials)
+		name_index.erase(named);
+
+	name_trie.erase(credentials->get_name());
+}
+
+/*
+	Add credentials to the security-level index in bulk, decrypting their security levels in parallel
+*/
+void session_t::index_members(std::vector<credentials_t*> credentials)
+{
+	std::vector<std::pair<credentials_t*, std::string>> codes = scan<std::pair<credentials_t*, std::string>, credentials_t*>(credentials, [&](credentials_t* const& member, std::pair<credentials_t*, std::string>& out)
+	{
+		out = std::make_pair(member, member->get_security_level(crypt_key));
+		return true;
+	});
+
+	for (unsigned int i = 0; i < codes.size(); i++)
+		add_member(codes.at(i).first, codes.at(i).second);
+}
+
+void session_t::add_member(credentials_t* credentials, std::string code)
+{
+	if (code != NO_SECURITY_LEVEL)
+		seclevel_index[code].push_back(credentials);
+}
+
+/*
+	Remove credentials from the security-level index, before their security level changes or they are deleted
+*/
+void session_t::remove_member(credentials_t* credentials)
+{
+	std::unordered_map<std::string, std::vector<credentials_t*>>::iterator it = seclevel_index.find(credentials->get_security_level(crypt_key));
+
+	if (it != seclevel_index.end())
+	{
+		it->second.erase(std::remove(it->second.begin(), it->second.end(), credentials), it->second.end());
+		if (it->second.empty())
+			seclevel_index.erase(it);
+	}
+}
+
+/*
+	Fill the security-level code index from the security levels on record
+*/
+void session_t::index_seclevels()
+{
+	std::vector<seclevel_t*> seclevels = seclevel_manager->get_seclevels();
+
+	seclevel_trie.clear();
+	for (unsigned int i = 0; i < seclevels.size(); i++)
+		seclevel_trie.insert(seclevels.at(i)->get_code());
+}
+
+/*
+	Log in using the provided key
+*/
+bool session_t::login(std::string key)
+{
+	keystore_t keystore = keystore_t(keystore_filename);
+
+	logged_in = keystore.login(key);
+
+	if (logged_in)
+	{
+		this->key = key;
+		crypt_key = keystore.get_static_key(key);
+	}
+
+	return logged_in;
+}
+
+/*
+	Reset key information
+*/
+void session_t::logout()
+{
+	key = crypt_key = "";
+	logged_in = false;
+}
+
+void session_t::add_credentials(std::string name, std::string username, std::string password, seclevel_t* seclevel)
+{
+	workload_event_t event("add_credentials");
+	event.name(name).secret(username).secret(password);
+	if (seclevel)
+		event.level(seclevel->get_code());
+
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			credentials->set_username(username);
+			credentials->set_password(password, crypt_key);
+			remove_member(credentials);
+			credentials->set_security_level(seclevel, crypt_key);
+			add_member(credentials, credentials->get_security_level(crypt_key));
+		}
+		else
+		{
+			if (seclevel)
+				credentials_list.push_back(new credentials_t(name, username, password, seclevel->get_code(), crypt_key));
+			else
+				credentials_list.push_back(new credentials_t(name, username, password, crypt_key));
+
+			index_credentials(credentials_list.back());
+			add_member(credentials_list.back(), seclevel ? seclevel->get_code() : NO_SECURITY_LEVEL);
+		}
+	}
+}
+
+void session_t::add_credentials(std::string name, std::string username, seclevel_t* seclevel)
+{
+	add_credentials(name, username, seclevel->get_password(crypt_key), seclevel);
+}
+
+/*
+	Add credentials with programmatic lists of secret questions and backup codes. The purpose of this function is to give more control to developers in testing.
+*/
+void session_t::add_credentials(std::string name, std::string username, std::string password, std::initializer_list<std::pair<std::string, std::string>> secret_questions, std::initializer_list<std::string> backup_codes)
+{
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			credentials->set_username(username);
+			credentials->set_password(password, crypt_key);
+			credentials->add_questions(secret_questions, crypt_key);
+		}
+		else
+		{
+			credentials_list.push_back(new credentials_t(name, username, password, crypt_key, secret_questions, backup_codes));
+			index_credentials(credentials_list.back());
+		}
+	}
+}
+
+bool session_t::modify_credentials(std::string name, std::string field, std::string value)
+{
+	workload_event_t event("modify_credentials");
+	event.name(name).field(field);
+	if (!field.empty() && std::tolower(field[0]) == 'n')
+		event.name(value);
+	else if (!field.empty() && std::tolower(field[0]) == 'l')
+		event.level(value);
+	else
+		event.secret(value);
+
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			switch (std::tolower(field[0]))
+			{
+				case 'n':	// Site name
+					unindex_credentials(credentials);
+					credentials->set_name(value);
+					index_credentials(credentials);
+					return true;
+				case 'u':	// Username
+					credentials->set_username(value);
+					return true;
+				case 'p':	// Password
+					credentials->set_password(value, crypt_key);
+					return true;
+				case 'l':	// Security level
+					remove_member(credentials);
+					credentials->set_security_level(value, crypt_key);
+					add_member(credentials, value);
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+int session_t::set_security_level(std::string security_level, std::vector<std::string> names)
+{
+	workload_event_t event("set_security_level");
+	event.level(security_level);
+	for (unsigned int i = 0; i < names.size(); i++)
+		event.name(names.at(i));
+
+	int out = 0;
+
+	for (unsigned int i = 0; i < names.size(); i++)
+	{
+		credentials_t* credentials = get_credentials(names.at(i));
+
+		if (credentials)
+		{
+			remove_member(credentials);
+			if (credentials->set_security_level(security_level, crypt_key))
+				out++;
+			add_member(credentials, credentials->get_security_level(crypt_key));
+		}
+	}
+
+	return out;
+}
+
+bool session_t::set_security_level(std::string name, seclevel_t* security_level)
+{
+	workload_event_t event("set_security_level");
+	event.level(security_level ? security_level->get_code() : NO_SECURITY_LEVEL).name(name);
+
+	credentials_t* credentials = get_credentials(name);
+	bool out = false;
+
+	if (credentials)
+	{
+		remove_member(credentials);
+		out = credentials->set_security_level(security_level, crypt_key);
+		add_member(credentials, credentials->get_security_level(crypt_key));
+	}
+
+	return out;
+}
+
+bool session_t::add_questions(std::string name, std::vector<std::pair<std::string, std::string>> questions)
+{
+	workload_event_t event("add_questions");
+	event.name(name);
+	for (unsigned int i = 0; i < questions.size(); i++)
+		event.secret(questions.at(i).first).secret(questions.at(i).second);
+
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			credentials->add_questions(questions, crypt_key);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int session_t::delete_questions(std::string name, std::vector<std::string> queries)
+{
+	workload_event_t event("delete_questions");
+	event.name(name);
+	for (unsigned int i = 0; i < queries.size(); i++)
+		event.secret(queries.at(i));
+
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			return credentials->delete_questions(queries);
+		}
+	}
+	
+	return 0;
+}
+
+bool session_t::delete_question(std::string name, int index)
+{
+	workload_event_t event("delete_question");
+	event.name(name).number(index);
+
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			return credentials->delete_question(index);
+		}
+	}
+
+	return false;
+}
+
+bool session_t::add_backups(std::string name, std::vector<std::string> backups)
+{
+	workload_event_t event("add_backups");
+	event.name(name);
+	for (unsigned int i = 0; i < backups.size(); i++)
+		event.secret(backups.at(i));
+
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			credentials->add_backups(backups, crypt_key);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int session_t::delete_backups(std::string name, std::vector<std::string> queries)
+{
+	workload_event_t event("delete_backups");
+	event.name(name);
+	for (unsigned int i = 0; i < queries.size(); i++)
+		event.secret(queries.at(i));
+
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			return credentials->delete_backups(queries, crypt_key);
+		}
+		else
+		{
+			return 0;
+		}
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+bool session_t::delete_backup(std::string name, int index)
+{
+	workload_event_t event("delete_backup");
+	event.name(name).number(index);
+
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			return credentials->delete_backup(index);
+		}
+	}
+
+	return false;
+}
+
+bool session_t::delete_credentials(std::string name)
+{
+	workload_event_t event("delete_credentials");
+	event.name(name);
+
+	if (logged_in)
+	{
+		std::vector<credentials_t*>::iterator it = find_credentials(name);
+
+		if (!is_end(it))
+		{
+			unindex_credentials(*it);
+			remove_member(*it);
+			delete *it;
+			credentials_list.erase(it);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+	Delete credentials by site name with one pass over the list and each index, rather than one pass per name. Returns whether each name was deleted.
+*/
+std::vector<bool> session_t::delete_credentials(std::vector<std::string> names)
+{
+	workload_event_t event("delete_credentials");
+	for (unsigned int i = 0; i < names.size(); i++)
+		event.name(names.at(i));
+
+	std::vector<bool> out(names.size(), false);
+	std::unordered_set<credentials_t*> doomed;
+
+	if (!logged_in)
+		return out;
+
+	for (unsigned int i = 0; i < names.size(); i++)
+	{
+		credentials_t* credentials = get_credentials(names.at(i));
+
+		if (credentials && doomed.count(credentials))	// Taken by an earlier name, so delete the next set of credentials sharing it, as deleting one at a time would
+		{
+			credentials = nullptr;
+			for (unsigned int j = 0; j < credentials_list.size() && !credentials; j++)
+				if (credentials_list.at(j)->get_name() == names.at(i) && !doomed.count(credentials_list.at(j)))
+					credentials = credentials_list.at(j);
+		}
+
+		if (credentials)
+		{
+			doomed.insert(credentials);
+			out[i] = true;
+		}
+	}
+
+	if (doomed.empty())
+		return out;
+
+	for (std::unordered_set<credentials_t*>::iterator it = doomed.begin(); it != doomed.end(); it++)	// Only once every name is resolved, since lookups can put doomed credentials back in the name index
+	{
+		std::unordered_map<std::string, credentials_t*>::iterator named = name_index.find((*it)->get_name());
+		if (named != name_index.end() && doomed.count(named->second))
+			name_index.erase(named);
+
+		name_trie.erase((*it)->get_name());
+	}
+
+	auto is_doomed = [&](credentials_t* credentials) { return doomed.count(credentials) > 0; };
+	auto sweep = [&](std::unordered_map<std::string, std::vector<credentials_t*>>& index)
+	{
+		for (std::unordered_map<std::string, std::vector<credentials_t*>>::iterator it = index.begin(); it != index.end();)
+		{
+			it->second.erase(std::remove_if(it->second.begin(), it->second.end(), is_doomed), it->second.end());
+			if (it->second.empty())
+				it = index.erase(it);
+			else
+				it++;
+		}
+	};
+
+	sweep(domain_index);
+	sweep(seclevel_index);
+	credentials_list.erase(std::remove_if(credentials_list.begin(), credentials_list.end(), is_doomed), credentials_list.end());
+
+	for (std::unordered_set<credentials_t*>::iterator it = doomed.begin(); it != doomed.end(); it++)
+		delete *it;
+
+	return out;
+}
+
+/*
+	Make room for more credentials ahead of adding them in bulk
+*/
+void session_t::reserve_credentials(size_t count)
+{
+	credentials_list.reserve(credentials_list.size() + count);
+	name_index.reserve(name_index.size() + count);
+}
+
+/*
+	Set master key
+*/
+void session_t::set_key(std::string new_key)
+{
+	workload_event_t event("set_key");
+	event.secret(new_key);
+
+	if (logged_in)
+	{
+		keystore_t(keystore_filename).set_key(new_key, key);
+	}
+}
+
+void session_t::add_seclevel(std::string code, std::string password, int months_valid, int update_year, int update_month, int update_day)
+{
+	if (!find_seclevel(code))	// Existing security levels are left alone
+		seclevel_trie.insert(code);
+
+	seclevel_manager->add_seclevel(code, password, months_valid, update_year, update_month, update_day, crypt_key);
+}
+
+void session_t::add_seclevel(std::string code, int months_valid, int update_year, int update_month, int update_day)
+{
+	if (!find_seclevel(code))
+		seclevel_trie.insert(code);
+
+	seclevel_manager->add_seclevel(code, months_valid, update_year, update_month, update_day);
+}
+
+bool session_t::delete_seclevel(std::string code)
+{
+	if (!seclevel_manager->delete_seclevel(code))
+		return false;
+
+	seclevel_trie.erase(code);
+	return true;
+}
+
+bool session_t::set_seclevel_password(std::string code, std::string password)
+{
+	return seclevel_manager->set_seclevel_password(code, password, crypt_key);
+}
+
+bool session_t::clear_seclevel_password(std::string code)
+{
+	return seclevel_manager->clear_seclevel_password(code, crypt_key);
+}
+
+bool session_t::set_seclevel_update_time(std::string code, int year, int month, int day)
+{
+	return seclevel_manager->set_update_time(code, year, month, day);
+}
+
+bool session_t::set_seclevel_history(std::string code, int depth, int retention_months)
+{
+	return seclevel_manager->set_history_policy(code, depth, retention_months);
+}
+
+bool session_t::set_seclevel_generator(std::string code, generator_t* generator)
+{
+	return seclevel_manager->set_generator(code, generator);
+}
+
+/*
+	Return a list of credentials whose passwords match an older password for their security level
+*/
+std::vector<credentials_t*> session_t::get_old_passwords()
+{
+	TRACE_SPAN("session_t::get_old_passwords");
+	std::vector<credentials_t*> out;
+	std::vector<seclevel_t*> seclevels = seclevel_manager->get_seclevels();
+
+	for (unsigned int i = 0; i < seclevels.size(); i++)	// Only members of security levels with a password can be behind, and only their passwords are decrypted
+	{
+		seclevel_t* seclevel = seclevels.at(i);
+		if (!seclevel->has_password() || seclevel->get_generator())	// The history of a level with a generator also holds the passwords its members hold now
+			continue;
+
+		std::vector<credentials_t*> old = scan<credentials_t*, credentials_t*>(get_members(seclevel->get_code()), [&](credentials_t* const& credentials, credentials_t*& match)
+		{
+			match = credentials;
+			return seclevel->is_old_password(credentials->get_password(crypt_key));	// History lookups only read, so they run alongside decryption
+		});
+
+		out.insert(out.end(), old.begin(), old.end());
+	}
+
+	return in_list_order(out);
+}
+
+/*
+	Return the credentials assigned to a security level
+*/
+std::vector<credentials_t*> session_t::get_members(std::string code)
+{
+	std::unordered_map<std::string, std::vector<credentials_t*>>::iterator it = seclevel_index.find(code);
+
+	if (it != seclevel_index.end())
+		return it->second;
+
+	return std::vector<credentials_t*>();
+}
+
+/*
+	Return the credentials whose security-level code matches a level: filter, ignoring case. The filter is resolved to the codes on record, and to codes of deleted security levels that credentials still carry, before their members are read from the index.
+*/
+std::vector<credentials_t*> session_t::find_level_members(std::string value)
+{
+	std::vector<std::string> codes;
+	std::vector<seclevel_t*> seclevels = seclevel_manager->get_seclevels();
+
+	for (unsigned int i = 0; i < seclevels.size(); i++)
+		if (lowercase_equals(seclevels.at(i)->get_code(), value))
+			codes.push_back(seclevels.at(i)->get_code());
+
+	for (std::unordered_map<std::string, std::vector<credentials_t*>>::iterator it = seclevel_index.begin(); it != seclevel_index.end(); it++)
+		if (lowercase_equals(it->first, value) && !find_seclevel(it->first))
+			codes.push_back(it->first);
+
+	std::vector<credentials_t*> out;
+	for (unsigned int i = 0; i < codes.size(); i++)
+	{
+		std::vector<credentials_t*> members = get_members(codes.at(i));
+		out.insert(out.end(), members.begin(), members.end());
+	}
+
+	return in_list_order(out);
+}
+
+/*
+	Put credentials taken from an index back in the order of the credentials list, which the index loses as security levels are set and credentials are renamed. Listings keep the order they would have from a scan over the whole list.
+*/
+std::vector<credentials_t*> session_t::in_list_order(const std::vector<credentials_t*>& credentials)
+{
+	if (credentials.size() < 2)
+		return credentials;
+
+	std::unordered_set<credentials_t*> members(credentials.begin(), credentials.end());
+	std::vector<credentials_t*> out;
+	out.reserve(credentials.size());
+
+	for (unsigned int i = 0; i < credentials_list.size(); i++)
+		if (members.count(credentials_list.at(i)))
+			out.push_back(credentials_list.at(i));
+
+	return out;
+}
+
+/*
+	Give every set of credentials assigned to a security level a new password, returning how many were updated. Security levels with a generator give each set its own generated password, and others give them all the password of the security level.
+*/
+int session_t::rotate_seclevel(std::string code)
+{
+	workload_event_t event("rotate_seclevel");
+	event.level(code);
+
+	seclevel_t* seclevel = find_seclevel(code);
+	if (!logged_in || !seclevel)
+		return -1;
+
+	std::vector<credentials_t*> members = get_members(code);
+
+	if (seclevel->get_generator())
+	{
+		std::vector<std::string> passwords = seclevel->generate_passwords(members.size());
+		if (passwords.size() != members.size())
+			return -1;
+
+		for (unsigned int i = 0; i < members.size(); i++)
+			members.at(i)->set_password(passwords.at(i), crypt_key);
+
+		seclevel_manager->record_passwords(seclevel, passwords);	// The rotation counts as an update of the security level, so it is no longer due
+		return members.size();
+	}
+
+	if (!seclevel->has_password())
+		return -1;
+
+	std::string password = seclevel->get_password(crypt_key);	// Decrypted once for the whole batch
+
+	for (unsigned int i = 0; i < members.size(); i++)	// Encryption draws IVs from rand(), which is not safe to share across threads everywhere, so this stays serial
+		members.at(i)->set_password(password, crypt_key);
+
+	return members.size();
+}
+
+std::vector<seclevel_t*> session_t::get_exp_passwords()
+{
+	return seclevel_manager->get_exp_passwords();
+}
+
+/*
+	Return the security levels whose passwords expire between two dates, inclusive
+*/
+std::vector<seclevel_t*> session_t::get_due_seclevels(date_t from, date_t to)
+{
+	return seclevel_manager->get_due_seclevels(from, to);
+}
+
+bool session_t::update_password(credentials_t* credentials)
+{
+	seclevel_t* ptr = find_seclevel(credentials->get_security_level(crypt_key));	// Get security-level information to update the set of credentials
+	if (ptr)
+		return modify_credentials(credentials->get_name(), "p", ptr->get_password(crypt_key));
+	else
+		return false;
+}
+
+void session_t::update_seclevel(seclevel_t* seclevel, std::string password)
+{
+	seclevel_manager->update_password(seclevel, password, crypt_key);
+}
+
+/*
+	Find credentials with site name fully matching the name parameter
+*/
+std::vector<credentials_t*>::iterator session_t::find_credentials(std::string name)
+{
+	credentials_t* credentials = get_credentials(name);
+
+	if (!credentials)
+		return credentials_list.end();
+
+	return std::find(credentials_list.begin(), credentials_list.end(), credentials);
+}
+
+/*
+	Credentials by site name, or nullptr if there are none
+*/
+credentials_t* session_t::get_credentials(std::string name)
+{
+	std::unordered_map<std::string, credentials_t*>::iterator it = name_index.find(name);
+
+	if (it != name_index.end())
+	{
+		get_metrics().name_index_hits.add();
+		return it->second;
+	}
+
+	get_metrics().name_index_misses.add();
+	if (!has_credentials(name))
+		return nullptr;
+
+	for (unsigned int i = 0; i < credentials_list.size(); i++)	// Another set of credentials with the name lost its place in the index when the first was deleted or renamed
+	{
+		if (credentials_list.at(i)->get_name() == name)
+		{
+			name_index[name] = credentials_list.at(i);
+			return credentials_list.at(i);
+		}
+	}
+
+	return nullptr;
+}
+
+/*
+	Whether credentials with the site name exist, without searching the list
+*/
+bool session_t::has_credentials(std::string name)
+{
+	return name_trie.count(name) > 0;
+}
+
+radix_trie_t& session_t::get_name_trie()
+{
+	return name_trie;
+}
+
+radix_trie_t& session_t::get_seclevel_trie()
+{
+	return seclevel_trie;
+}
+
+/*
+	Find credentials whose site names share a registrable domain with a URL or host name, such as github.com and login.github.com
+*/
+std::vector<credentials_t*> session_t::find_domain(std::string url)
+{
+	std::unordered_map<std::string, std::vector<credentials_t*>>::iterator it = domain_index.find(registrable_domain(url));
+
+	if (it != domain_index.end())
+		return it->second;
+
+	return std::vector<credentials_t*>();
+}
+
+/*
+	Find the credentials whose site names most closely match the name parameter, best match first
+*/
+std::vector<credentials_t*> session_t::fuzzy_find_credentials(std::string name, unsigned int max_results)
+{
+	struct match_t
+	{
+		credentials_t* credentials;
+		unsigned int distance;
+		size_t length_difference;	// Breaks ties in favor of site names closest in length to the query
+		size_t order;	// Keeps the list order otherwise
+	};
+
+	unsigned int max_distance = fuzzy_max_distance(name.length());
+	std::vector<match_t> matches = scan<match_t, credentials_t*>(credentials_list, [&](credentials_t* const& credentials, match_t& match)
+	{
+		std::string site = credentials->get_name();
+		match.credentials = credentials;
+		match.distance = fuzzy_distance(site, name);
+		match.length_difference = site.length() > name.length() ? site.length() - name.length() : name.length() - site.length();
+
+		return match.distance <= max_distance;
+	});
+
+	for (size_t i = 0; i < matches.size(); i++)
+		matches[i].order = i;
+
+	size_t k = std::min<size_t>(max_results, matches.size());
+	std::partial_sort(matches.begin(), matches.begin() + k, matches.end(), [](const match_t& a, const match_t& b)
+	{
+		if (a.distance != b.distance)
+			return a.distance < b.distance;
+		if (a.length_difference != b.length_difference)
+			return a.length_difference < b.length_difference;
+		return a.order < b.order;
+	});
+
+	std::vector<credentials_t*> out;
+	for (size_t i = 0; i < k; i++)
+		out.push_back(matches[i].credentials);
+
+	return out;
+}
+
+/*
+	Find credentials matching a parsed query
+*/
+std::vector<credentials_t*> session_t::query_credentials(query_t& query)
+{
+	const std::vector<credentials_t*>& candidates = plan_query(query);
+	std::unordered_set<std::string> expired_codes = get_expired_codes(query);
+
+	return scan<credentials_t*, credentials_t*>(candidates, [&](credentials_t* const& credentials, credentials_t*& match)
+	{
+		match = credentials;
+		return matches_query(credentials, query, expired_codes);
+	});
+}
+
+/*
+	Resolve the domains in a query against the domain index and pick the credentials it has to check: those under its domain filter if it has one, those under its level filter in the security-level index if it has one, or else every set of credentials
+*/
+const std::vector<credentials_t*>& session_t::plan_query(query_t& query)
+{
+	static const std::vector<credentials_t*> no_credentials;
+
+	query.resolve_domains([&](std::string domain) { return find_domain(domain); });
+
+	std::string domain = query.get_index_domain();
+	if (!domain.empty())
+	{
+		std::unordered_map<std::string, std::vector<credentials_t*>>::iterator it = domain_index.find(domain);
+		return it != domain_index.end() ? it->second : no_credentials;
+	}
+
+	if (logged_in && query.resolve_level([&](std::string value) { return find_level_members(value); }))	// The index is only filled once the key can decrypt security levels
+		return query.get_level_members();
+
+	return credentials_list;
+}
+
+/*
+	Codes of the security levels whose passwords have expired, resolved once per query rather than per set of credentials
+*/
+std::unordered_set<std::string> session_t::get_expired_codes(query_t& query)
+{
+	std::unordered_set<std::string> out;
+
+	if (query.needs_security_level())
+	{
+		std::vector<seclevel_t*> expired = get_exp_passwords();
+		for (unsigned int i = 0; i < expired.size(); i++)
+			out.insert(expired.at(i)->get_code());
+	}
+
+	return out;
+}
+
+/*
+	Filters on stored fields run first so that only the credentials surviving them have their security levels decrypted
+*/
+bool session_t::matches_query(credentials_t* credentials, query_t& query, const std::unordered_set<std::string>& expired_codes)
+{
+	if (!query.matches_fields(credentials))
+		return false;
+
+	return !query.needs_security_level() || query.matches_security_level(credentials->get_security_level(crypt_key), expired_codes);
+}
+
+/*
+	Return up to n site names resembling a name that was not found
+*/
+std::vector<std::string> session_t::suggest_names(std::string name, unsigned int n)
+{
+	std::vector<std::string> out;
+	std::vector<credentials_t*> matches = fuzzy_find_credentials(name, n);
+
+	for (unsigned int i = 0; i < matches.size(); i++)
+		out.push_back(matches.at(i)->get_name());
+
+	return out;
+}
+
+/*
+	Return whether the iterator points to the end of credentials_list
+*/
+bool session_t::is_end(std::vector<credentials_t*>::iterator it)
+{
+	return it == credentials_list.end();
+}
+
+std::string session_t::get_crypt_key()
+{
+	return crypt_key;
+}
+
+seclevel_t* session_t::find_seclevel(std::string code)
+{
+	std::vector<seclevel_t*>::iterator it = seclevel_manager->find_seclevel(code);
+
+	if (!seclevel_manager->is_end(it))
+		return *it;
+	else
+		return nullptr;
+}
+
+bool session_t::is_logged_in()
+{
+	return logged_in;
+}
+
+bool session_t::are_credentials_loaded()
+{
+	return !credentials_list.empty();
+}
+
+void session_t::print_credentials()
+{
+	workload_event_t event("print_credentials");
+
+	scan_write<credentials_t*>(credentials_list,
+		[](credentials_t* const&) { return true; },
+		[&](credentials_t* const& credentials, table_writer_t& output) { credentials->print(output, crypt_key); },
+		[&](credentials_t* const& credentials, json_writer_t& output) { credentials->write(output, crypt_key); },
+		get_output());
+}
+
+/*
+	Print the secret questions of a set of credentials in an ordered list
+*/
+void session_t::print_questions(std::string name)
+{
+	workload_event_t event("print_questions");
+	event.name(name);
+
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			std::vector<credentials_t::secquestion_t*> secret_questions = credentials->get_questions();
+
+			if (output_format != TABLE)
+			{
+				std::string buffer;
+				json_writer_t writer(buffer, &get_output());
+
+				if (output_format == JSON)
+					writer.begin_array();
+
+				for (unsigned int i = 0; i < secret_questions.size(); i++)
+				{
+					writer.begin_object();
+					writer.key("question").value(secret_questions.at(i)->get_question());
+					writer.key("answer").value(secret_questions.at(i)->get_data(crypt_key));
+					writer.end_object();
+
+					if (output_format == NDJSON)
+						writer.end_line();
+				}
+
+				if (output_format == JSON)
+				{
+					writer.end_array();
+					writer.end_line();
+				}
+				return;
+			}
+
+			std::string buffer;
+			table_writer_t output(buffer, &get_output());
+
+			for (unsigned int i = 0; i < secret_questions.size(); i++)
+			{
+				output.cell(i + 1);
+				secret_questions.at(i)->print(output, crypt_key);
+				output.end_row();
+			}
+		}
+	}
+}
+
+/*
+	Print the backup codes of a set of credentials in an ordered list
+*/
+void session_t::print_backups(std::string name)
+{
+	workload_event_t event("print_backups");
+	event.name(name);
+
+	if (logged_in)
+	{
+		credentials_t* credentials = get_credentials(name);
+
+		if (credentials)
+		{
+			std::vector<secret_t*> backup_codes = credentials->get_backups();
+
+			if (output_format != TABLE)
+			{
+				std::string buffer;
+				json_writer_t writer(buffer, &get_output());
+
+				if (output_format == JSON)
+					writer.begin_array();
+
+				for (unsigned int i = 0; i < backup_codes.size(); i++)
+				{
+					writer.value(backup_codes.at(i)->get_data(crypt_key));
+					if (output_format == NDJSON)
+						writer.end_line();
+				}
+
+				if (output_format == JSON)
+				{
+					writer.end_array();
+					writer.end_line();
+				}
+				return;
+			}
+
+			std::string buffer;
+			table_writer_t output(buffer, &get_output());
+
+			for (unsigned int i = 0; i < backup_codes.size(); i++)
+			{
+				output.cell(i + 1);
+				backup_codes.at(i)->print(output, crypt_key);
+				output.end_row();
+			}
+		}
+	}
+}
+
+void session_t::print_seclevels()
+{
+	workload_event_t event("print_seclevels");
+
+	if (output_format == TABLE)
+		seclevel_manager->print(get_output(), crypt_key);
+	else
+		seclevel_manager->write(get_output(), crypt_key);
+}
+
+/*
+	Print the security levels due for a password rotation between two dates, in the order they are due
+*/
+void session_t::print_due_seclevels(date_t from, date_t to)
+{
+	std::vector<seclevel_t*> due = get_due_seclevels(from, to);
+
+	std::string buffer;
+	table_writer_t output(buffer, &std::cout);
+
+	for (unsigned int i = 0; i < due.size(); i++)
+	{
+		output.cell(due.at(i)->get_code());
+		output.cell(due.at(i)->get_update_time().to_string());
+		output.end_row();
+	}
+}
+
+/*
+	Print credentials matching every filter in the query, such as "user:ops@ name:aws level:HIGH expired:yes has:backups". Plain words pattern-match the site name.
+*/
+void session_t::search_credentials(std::string query)
+{
+	workload_event_t event("search_credentials");
+	event.query(query);
+	TRACE_SPAN("session_t::search_credentials");
+	query_t parsed = query_t(query);
+
+	if (!parsed.is_valid())
+	{
+		std::cout << parsed.get_error() << std::endl;
+		return;
+	}
+
+	const std::vector<credentials_t*>& candidates = plan_query(parsed);
+	std::unordered_set<std::string> expired_codes = get_expired_codes(parsed);
+
+	scan_write<credentials_t*>(candidates,
+		[&](credentials_t* const& credentials) { return matches_query(credentials, parsed, expired_codes); },
+		[&](credentials_t* const& credentials, table_writer_t& output) { credentials->print(output, crypt_key); },
+		[&](credentials_t* const& credentials, json_writer_t& output) { credentials->write(output, crypt_key); },
+		get_output());
+}
+
+/*
+	Print the credentials whose site names most closely match the query, allowing for typos
+*/
+void session_t::fuzzy_search_credentials(std::string query)
+{
+	workload_event_t event("fuzzy_search_credentials");
+	event.secret(query);
+
+	std::vector<credentials_t*> matches = fuzzy_find_credentials(query);
+
+	scan_write<credentials_t*>(matches,
+		[](credentials_t* const&) { return true; },
+		[&](credentials_t* const& credentials, table_writer_t& output) { credentials->print(output, crypt_key); },
+		[&](credentials_t* const& credentials, json_writer_t& output) { credentials->write(output, crypt_key); },
+		get_output());
+}
+
+/*
+	Print a health report on every password: its strength, whether other credentials share it, whether it is an old security-level password, its age, and whether there are backup codes
+*/
+void session_t::audit_credentials()
+{
+	workload_event_t event("audit_credentials");
+	uint8_t fingerprint_key[FINGERPRINT_KEY_LENGTH];
+	get_random().fill(fingerprint_key, sizeof(fingerprint_key));	// A new key for every audit, so fingerprints mean nothing outside it
+	date_t today = date_t::today();
+	strength_estimator_t& estimator = get_strength_estimator();
+
+	std::vector<audit_entry_t> entries = scan<audit_entry_t, credentials_t*>(credentials_list, [&](credentials_t* const& credentials, audit_entry_t& entry)
+	{
+		std::string password = credentials->get_password(crypt_key);	// Each secret is decrypted once
+		std::string code = credentials->get_security_level(crypt_key);
+		seclevel_t* seclevel = code == NO_SECURITY_LEVEL ? nullptr : find_seclevel(code);
+
+		entry.credentials = credentials;
+		entry.strength = estimator.estimate(password);
+		entry.fingerprint = fingerprint(password, fingerprint_key);
+		entry.reuse_count = 1;
+		entry.old_password = seclevel && !seclevel->get_generator() && seclevel->is_old_password(password);
+		entry.age = credentials->has_password_date() ? today.get_days() - credentials->get_password_date().get_days() : -1;
+
+		if (entry.age < 0)
+			entry.over_age = false;
+		else if (seclevel && seclevel->get_months_valid() > 0)	// Passwords under a security level are due once a full update period has passed
+			entry.over_age = credentials->get_password_date().add_months(seclevel->get_months_valid()) <= today;
+		else
+			entry.over_age = entry.age > AUDIT_MAX_AGE_DAYS;
+
+		entry.no_backups = credentials->get_backups().empty();
+		return true;
+	});
+
+	std::memset(fingerprint_key, 0, sizeof(fingerprint_key));
+
+	std::unordered_map<uint64_t, unsigned int> reuse_counts;	// Equal passwords meet here, with no comparisons between pairs of credentials
+	reuse_counts.reserve(entries.size());
+	for (unsigned int i = 0; i < entries.size(); i++)
+		reuse_counts[entries[i].fingerprint]++;
+
+	unsigned int weak = 0, reused = 0, old = 0, over_age = 0, no_backups = 0;
+	for (unsigned int i = 0; i < entries.size(); i++)
+	{
+		entries[i].reuse_count = reuse_counts[entries[i].fingerprint];
+
+		weak += entries[i].is_weak();
+		reused += entries[i].reuse_count > 1;
+		old += entries[i].old_password;
+		over_age += entries[i].over_age;
+		no_backups += entries[i].no_backups;
+	}
+
+	scan_print<audit_entry_t>(entries,
+		[](const audit_entry_t& entry) { return entry.is_flagged(); },
+		[](const audit_entry_t& entry, std::ostream& output)
+		{
+			set_print(output);
+			output << entry.credentials->get_name();
+			set_print(output);
+			output << entry.credentials->get_username();
+			output << entry.describe() << std::endl;
+		},
+		std::cout);
+
+	std::cout << std::endl << "Audited " << entries.size() << " set" << (entries.size() != 1 ? "s" : "") << " of credentials: "
+		<< weak << " weak, " << reused << " reused, " << old << " old security-level passwords, "
+		<< over_age << " due for a change, " << no_backups << " without backup codes" << std::endl;
+}
+
+/*
+	Print the credentials whose passwords appear in a breach corpus, with how many times they appear
+*/
+void session_t::check_breaches(breach_corpus_t& corpus)
+{
+	std::vector<std::pair<credentials_t*, unsigned int>> breached = scan<std::pair<credentials_t*, unsigned int>, credentials_t*>(credentials_list, [&](credentials_t* const& credentials, std::pair<credentials_t*, unsigned int>& out)
+	{
+		out = std::make_pair(credentials, corpus.count(credentials->get_password(crypt_key)));	// The corpus is only read, so lookups run in parallel
+		return out.second > 0;
+	});
+
+	for (unsigned int i = 0; i < breached.size(); i++)
+	{
+		set_print(std::cout);
+		std::cout << breached.at(i).first->get_name();
+		set_print(std::cout);
+		std::cout << breached.at(i).first->get_username();
+		std::cout << "Seen " << breached.at(i).second << " time" << (breached.at(i).second != 1 ? "s" : "") << " in breaches" << std::endl;
+	}
+
+	std::cout << std::endl << breached.size() << " of " << credentials_list.size() << " passwords found in breaches" << std::endl;
+}
+
+/*
+	Print how much memory the credentials, security levels, and indexes take up, by subsystem
+*/
+void session_t::print_memory()
+{
+	memory_report_t report;
+
+	account_memory(report);
+	report.print(get_output());
+}
+
+/*
+	Read in credentials from a file
+*/
+bool session_t::read(std::string filename)
+{
+	phase_timer_t timer("credentials parse");
+	TRACE_SPAN("session_t::read");
+	bool same_key = true;	// Assume that there is no key stored and, therefore, the file can be read (albeit in a less secure manner)
+	std::ifstream file(filename, std::ios::binary);
+	profile_read(file);
+
+	if (file.is_open())	// same_key will also stay true if the file isn't open
+	{
+		char group_code;
+		while (storage::read_group(group_code, file))	// Read next group code
+		{
+			if (group_code == GENERATION)	// Only the generation follows, and its bytes aren't groups
+				break;
+
+			if (group_code == KEY && logged_in)
+				same_key = key_t(file).equals(crypt_key);	// Read hashed key used to encrypt the credentials and check it against crypt_key
+
+			if (group_code == CREDENTIALS)
+			{
+				size_t first = credentials_list.size();
+
+				while (!storage::is_eor(file))	// Push all credential records to credentials_list
+				{
+					credentials_list.push_back(new credentials_t(file));
+					index_credentials(credentials_list.back());
+				}
+
+				if (logged_in)
+					index_members(std::vector<credentials_t*>(credentials_list.begin() + first, credentials_list.end()));
+
+				storage::consume_rs(file);	// There is an extra record separator since this list doesn't span the entire file
+			}
+		}
+
+		file.close();
+	}
+
+	if (!same_key)
+		unload();
+
+	return same_key;
+}
+
+/*
+	Store credentials in a file and security-level information in the file on record, as one commit so that neither is replaced without the other
+*/
+bool session_t::store(std::string credentials_filename)
+{
+	workload_event_t event("store");
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	commit_t commit;
+
+	store_credentials(commit, credentials_filename);
+	seclevel_manager->store(commit);
+	bool out = commit.commit();
+
+	get_metrics().last_save_nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	get_metrics().saves++;
+	return out;
+}
+
+/*
+	Store credentials in a file, replacing it in one step
+*/
+bool session_t::store_credentials(std::string filename)
+{
+	commit_t commit;
+
+	store_credentials(commit, filename);
+	return commit.commit();
+}
+
+/*
+	Stage credentials as part of a larger commit
+*/
+void session_t::store_credentials(commit_t& commit, std::string filename)
+{
+	phase_timer_t timer("save credentials");
+	TRACE_SPAN("session_t::store_credentials");
+	std::ofstream& file = commit.stage(filename);
+
+	if (file.is_open())
+	{
+		if (!credentials_list.empty())
+		{
+			storage::store_gs(KEY, file);
+			key_t(crypt_key).store(file);	// Hash crypt_key and store
+
+			storage::store_gs(CREDENTIALS, file);
+			for (unsigned int i = 0; i < credentials_list.size(); i++)
+			{
+				credentials_list.at(i)->store(file);
+			}
+			storage::store_rs(file);	// Store an extra record separator since this list doesn't span the entire file
+		}
+
+		get_metrics().vault_bytes = file.tellp();
+		get_metrics().credentials_count = credentials_list.size();
+		profile_written(file);
+	}
+}
+
+/*
+	Store security-level information in the file on record
+*/
+bool session_t::store_seclevels()
+{
+	return seclevel_manager->store();
+}
+
+/*
+	Clear loaded credentials
+*/
+void session_t::unload()
+{
+	for (unsigned int i = 0; i < credentials_list.size(); i++)
+	{
+		delete credentials_list.at(i);
+	}
+
+	credentials_list.clear();
+	domain_index.clear();
+	seclevel_index.clear();
+	name_index.clear();
+	name_trie.clear();
+}
+
+/*
+	Add the loaded credentials, security levels, and every index over them to a memory report
+*/
+void session_t::account_memory(memory_report_t& report)
+{
+	size_t bytes = heap_bytes_of(name_index) + heap_bytes_of(domain_index) + heap_bytes_of(seclevel_index);
+
+	report.add(RECORDS_MEMORY, 0, heap_bytes_of(credentials_list));
+	for (unsigned int i = 0; i < credentials_list.size(); i++)
+		credentials_list.at(i)->account_memory(report);
+
+	for (std::unordered_map<std::string, credentials_t*>::iterator it = name_index.begin(); it != name_index.end(); it++)
+		bytes += heap_bytes_of(it->first);
+	for (std::unordered_map<std::string, std::vector<credentials_t*>>::iterator it = domain_index.begin(); it != domain_index.end(); it++)
+		bytes += heap_bytes_of(it->first) + heap_bytes_of(it->second);
+	for (std::unordered_map<std::string, std::vector<credentials_t*>>::iterator it = seclevel_index.begin(); it != seclevel_index.end(); it++)
+		bytes += heap_bytes_of(it->first) + heap_bytes_of(it->second);
+
+	report.add(INDEXES_MEMORY, name_index.size() + domain_index.size() + seclevel_index.size(), bytes);
+	name_trie.account_memory(report, INDEXES_MEMORY);
+	seclevel_trie.account_memory(report, INDEXES_MEMORY);
+	seclevel_manager->account_memory(report);
 }
\ No newline at end of file
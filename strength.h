@@ -0,0 +1,711 @@
+#pragma once
+
+#include <cmath>
+#include <fstream>
+#include <string>
+#include "dawg.h"
+#include "date.h"
+
+#define DEFAULT_DICTIONARY_FILENAME "dictionary.dawg"
+#define WEAK_SCORE 2	// Passwords scoring this or lower are weak
+#define STRENGTH_MAX_LENGTH 100	// Characters past this are counted as brute force without looking for patterns
+#define MAX_MATCH_COUNT 16	// Splits into more matches than this are counted as this many
+#define BRUTEFORCE_CARDINALITY 10	// Guesses per character not covered by a pattern
+#define MIN_SEQUENCE_GUESSES 4	// log10 of the guesses added for every match past the first
+#define KEYBOARD_STARTING_POSITIONS 94
+#define KEYBOARD_AVERAGE_DEGREE 4.6
+#define MIN_YEAR_SPACE 20
+
+/*
+	How hard a password is to guess, as estimated from the patterns it is made of
+*/
+struct strength_t
+{
+	enum pattern_t
+	{
+		BRUTEFORCE,
+		DICTIONARY,
+		REVERSED,
+		L33T,
+		KEYBOARD,
+		SEQUENCE,
+		REPEAT,
+		DATE
+	};
+
+	double guesses = 0;	// log10 of the guesses needed
+	int score = 0;	// 0 for trivially guessable to 4 for very hard to guess
+	pattern_t weakness = BRUTEFORCE;	// Pattern covering most of the password
+
+	bool is_weak() const;
+	std::string describe() const;
+};
+
+/*
+	A password strength estimator in the manner of zxcvbn. Every dictionary word, keyboard walk, sequence, repeat and date found in the password is a candidate match, and the estimate is that of the cheapest way for an attacker to cover the whole password with matches and brute force.
+*/
+class strength_estimator_t
+{
+	struct match_t
+	{
+		uint8_t start, end;
+		double guesses;	// log10
+		strength_t::pattern_t pattern;
+	};
+
+	dawg_t dictionary;	// Lowercase words ranked by how common they are
+	int current_year;
+
+	void find_dictionary_matches(const std::string&, const std::string&, const std::string&, std::vector<match_t>&);
+	void find_keyboard_matches(const std::string&, std::vector<match_t>&);
+	void find_sequence_matches(const std::string&, std::vector<match_t>&);
+	void find_repeat_matches(const std::string&, std::vector<match_t>&);
+	void find_date_matches(const std::string&, std::vector<match_t>&);
+
+	double year_guesses(int);
+
+	static char unleet(char);
+	static double log10_choose(int, int);
+	static double log10_variations(int, int);
+	static double uppercase_variations(const std::string&, size_t, size_t);
+	static int cardinality(char);
+	static bool get_key_position(char, int&, int&, bool&);
+
+	public:
+	strength_estimator_t();
+
+	bool open(std::string);
+	void load_common_passwords();
+	bool has_dictionary();
+
+	strength_t estimate(const std::string&);
+
+	static bool build_dictionary(std::vector<std::string>, std::string);
+};
+
+strength_estimator_t& get_strength_estimator();
+
+bool strength_t::is_weak() const
+{
+	return score <= WEAK_SCORE;
+}
+
+/*
+	Describe the strength, such as "score 1, about 10^4 guesses, a keyboard pattern"
+*/
+std::string strength_t::describe() const
+{
+	const char* patterns[] = { "", "a common word", "a reversed word", "a word with symbol substitutions", "a keyboard pattern", "a sequence", "a repeat", "a date" };
+	std::string out = "score " + std::to_string(score) + ", about 10^" + std::to_string((int)guesses) + " guesses";
+
+	if (weakness != BRUTEFORCE)
+		out += std::string(", ") + patterns[weakness];
+
+	return out;
+}
+
+strength_estimator_t::strength_estimator_t()
+{
+	current_year = date_t::today().to_civil().year;
+}
+
+/*
+	Map a dictionary compiled with build_dictionary. Without one, only the built-in list of the most common passwords is matched.
+*/
+bool strength_estimator_t::open(std::string filename)
+{
+	if (dictionary.open(filename))
+		return true;
+
+	load_common_passwords();
+	return false;
+}
+
+/*
+	Use a short list of the most common passwords, most common first, so that the likes of "password" and "P@ssw0rd" are weak even when no dictionary has been built
+*/
+void strength_estimator_t::load_common_passwords()
+{
+	const char* passwords[] = {
+		"123456", "password", "123456789", "12345678", "12345", "qwerty", "1234567", "111111", "1234567890", "123123",
+		"abc123", "1234", "password1", "iloveyou", "1q2w3e4r", "000000", "qwerty123", "zaq12wsx", "dragon", "sunshine",
+		"princess", "letmein", "654321", "monkey", "welcome1", "1qaz2wsx", "123321", "qwertyuiop", "superman", "asdfghjkl",
+		"666666", "121212", "football", "baseball", "welcome", "admin", "master", "shadow", "michael", "login",
+		"passw0rd", "starwars", "trustno1", "whatever", "freedom", "hello", "secret", "charlie", "donald", "loveme",
+		"batman", "access", "mustang", "jordan", "harley", "ranger", "buster", "soccer", "hockey", "killer",
+		"george", "computer", "summer", "internet", "cheese", "pepper", "ginger", "tigger", "hunter", "ashley",
+		"jessica", "nicole", "chelsea", "matthew", "yankees", "dallas", "taylor", "orange", "matrix", "banana",
+		"purple", "cookie", "silver", "flower", "test", "guest", "default", "changeme", "root", "pass",
+		"asdf", "zxcvbnm", "asdfgh", "abcd1234", "aa123456", "987654321", "112233", "159753", "7777777", "11111111"
+	};
+	std::vector<std::pair<std::string, uint32_t>> words;
+
+	for (unsigned int i = 0; i < sizeof(passwords) / sizeof(passwords[0]); i++)
+		words.push_back({ passwords[i], i + 1 });
+
+	dictionary.load(words);
+}
+
+bool strength_estimator_t::has_dictionary()
+{
+	return dictionary.is_open();
+}
+
+/*
+	Estimate the guesses needed for a password. Matches are joined by a search over prefixes of the password that also tracks how many matches make up each prefix, since an attacker trying combinations of l patterns has l! orderings and every shorter combination to get through first.
+*/
+strength_t strength_estimator_t::estimate(const std::string& password)
+{
+	strength_t out;
+	size_t n = std::min<size_t>(password.length(), STRENGTH_MAX_LENGTH);
+
+	if (n == 0)
+		return out;
+
+	std::string text = password.substr(0, n), lower = text, plain = text;
+	for (size_t i = 0; i < n; i++)
+	{
+		lower[i] = std::tolower((unsigned char)text[i]);
+		plain[i] = unleet(lower[i]);
+	}
+
+	std::vector<match_t> matches;
+	matches.reserve(n * 4);
+	find_dictionary_matches(text, lower, plain, matches);
+	find_keyboard_matches(text, matches);
+	find_sequence_matches(text, matches);
+	find_repeat_matches(text, matches);
+	find_date_matches(text, matches);
+
+	for (unsigned int i = 0; i < matches.size(); i++)
+	{
+		match_t& match = matches[i];
+		if ((size_t)(match.end - match.start) < n)	// Telling where a pattern starts and ends within a password costs guesses of its own
+			match.guesses = std::max(match.guesses, match.end - match.start == 1 ? 1.0 : std::log10(50.0));
+	}
+
+	std::sort(matches.begin(), matches.end(), [](const match_t& a, const match_t& b) { return a.start < b.start; });
+	std::vector<unsigned int> starting(n + 1, 0);	// Matches starting at i are matches[starting[i]] up to matches[starting[i + 1]]
+	for (unsigned int i = 0; i < matches.size(); i++)
+		starting[matches[i].start + 1]++;
+	for (size_t i = 0; i < n; i++)
+		starting[i + 1] += starting[i];
+
+	struct state_t
+	{
+		double guesses = INFINITY;	// log10 of the product of the guesses of the matches so far
+		uint8_t previous = 0, previous_count = 0;
+		bool previous_bruteforce = false;
+		const match_t* match = nullptr;	// Match ending here, or nullptr for brute force
+	};
+
+	// best[i][l][b] covers the first i characters with l matches, the last being brute force if b is set
+	std::vector<state_t> best((n + 1) * (MAX_MATCH_COUNT + 1) * 2);
+	auto at = [&](size_t i, int l, bool b) -> state_t& { return best[(i * (MAX_MATCH_COUNT + 1) + l) * 2 + b]; };
+	auto relax = [&](size_t i, int l, bool b, size_t j, int k, bool c, double guesses, const match_t* match)
+	{
+		state_t& to = at(j, std::min(k, MAX_MATCH_COUNT), c);
+		if (guesses < to.guesses)
+		{
+			to.guesses = guesses;
+			to.previous = i;
+			to.previous_count = l;
+			to.previous_bruteforce = b;
+			to.match = match;
+		}
+	};
+
+	at(0, 0, false).guesses = 0;
+	double bruteforce = std::log10((double)BRUTEFORCE_CARDINALITY);
+
+	for (size_t i = 0; i < n; i++)
+	{
+		for (int l = 0; l <= MAX_MATCH_COUNT; l++)
+		{
+			for (int b = 0; b < 2; b++)
+			{
+				const state_t& from = at(i, l, b);
+				if (from.guesses == INFINITY)
+					continue;
+
+				if (b)	// Carry on the brute-force run
+					relax(i, l, b, i + 1, l, true, from.guesses + bruteforce, nullptr);
+				else
+					relax(i, l, b, i + 1, l + 1, true, from.guesses + bruteforce, nullptr);
+
+				for (unsigned int m = starting[i]; m < starting[i + 1]; m++)
+					relax(i, l, b, matches[m].end, l + 1, false, from.guesses + matches[m].guesses, &matches[m]);
+			}
+		}
+	}
+
+	int best_count = 0;
+	bool best_bruteforce = false;
+	out.guesses = INFINITY;
+
+	for (int l = 1; l <= MAX_MATCH_COUNT; l++)
+	{
+		for (int b = 0; b < 2; b++)
+		{
+			if (at(n, l, b).guesses == INFINITY)
+				continue;
+
+			double product = at(n, l, b).guesses + std::lgamma(l + 1.0) / std::log(10.0);	// l! orderings of the matches
+			double shorter = (l - 1) * MIN_SEQUENCE_GUESSES;	// Fewer matches are tried first
+			double total = std::max(product, shorter) + std::log10(1 + std::pow(10.0, -std::fabs(product - shorter)));
+
+			if (total < out.guesses)
+			{
+				out.guesses = total;
+				best_count = l;
+				best_bruteforce = b;
+			}
+		}
+	}
+
+	unsigned int widest = 0;
+	for (size_t i = n; i > 0;)	// Walk back through the best split to the match covering the most characters
+	{
+		const state_t& state = at(i, best_count, best_bruteforce);
+		if (state.match && (unsigned int)(state.match->end - state.match->start) > widest)
+		{
+			widest = state.match->end - state.match->start;
+			out.weakness = state.match->pattern;
+		}
+
+		i = state.previous;
+		best_count = state.previous_count;
+		best_bruteforce = state.previous_bruteforce;
+	}
+
+	out.guesses += (password.length() - n) * bruteforce;
+	out.score = out.guesses < 3 ? 0 : out.guesses < 6 ? 1 : out.guesses < 8 ? 2 : out.guesses < 10 ? 3 : 4;
+
+	return out;
+}
+
+/*
+	Dictionary words read forwards, backwards, and with symbols read as the letters they stand in for, such as "p4$$w0rd"
+*/
+void strength_estimator_t::find_dictionary_matches(const std::string& text, const std::string& lower, const std::string& plain, std::vector<match_t>& out)
+{
+	if (!dictionary.is_open())
+		return;
+
+	size_t n = text.length();
+	std::string reversed(lower.rbegin(), lower.rend());
+	bool leet = plain != lower;
+
+	auto rank_guesses = [](int tier) { return (tier + 0.5) * std::log10(2.0); };	// Middle of the tier
+
+	for (size_t i = 0; i < n; i++)
+	{
+		dictionary.find_prefixes(lower.data() + i, n - i, [&](size_t length, int tier)
+		{
+			out.push_back({ (uint8_t)i, (uint8_t)(i + length), rank_guesses(tier) + uppercase_variations(text, i, i + length), strength_t::DICTIONARY });
+		});
+
+		dictionary.find_prefixes(reversed.data() + i, n - i, [&](size_t length, int tier)
+		{
+			size_t start = n - i - length, end = n - i;
+			if (length > 1)	// Single letters read the same either way
+				out.push_back({ (uint8_t)start, (uint8_t)end, rank_guesses(tier) + uppercase_variations(text, start, end) + std::log10(2.0), strength_t::REVERSED });
+		});
+
+		if (!leet)
+			continue;
+
+		dictionary.find_prefixes(plain.data() + i, n - i, [&](size_t length, int tier)
+		{
+			bool targets[256] = {};	// Letters that some symbol in the word stands in for
+			int substituted = 0, unsubstituted = 0;
+
+			for (size_t j = i; j < i + length; j++)
+				if (plain[j] != lower[j])
+				{
+					targets[(uint8_t)plain[j]] = true;
+					substituted++;
+				}
+
+			for (size_t j = i; j < i + length; j++)
+				unsubstituted += plain[j] == lower[j] && targets[(uint8_t)plain[j]];
+
+			if (substituted)
+				out.push_back({ (uint8_t)i, (uint8_t)(i + length), rank_guesses(tier) + uppercase_variations(text, i, i + length) + log10_variations(substituted, unsubstituted), strength_t::L33T });
+		});
+	}
+}
+
+/*
+	Walks of three or more adjacent keys on a QWERTY keyboard, such as "qwerty" or "zaq1@WSX". Guesses grow with the length of the walk and the number of turns it takes.
+*/
+void strength_estimator_t::find_keyboard_matches(const std::string& text, std::vector<match_t>& out)
+{
+	size_t n = text.length();
+
+	for (size_t i = 0; i + 2 < n;)
+	{
+		int turns = 0, shifted = 0, direction = -1;
+		size_t j = i;
+		int row, column;
+		bool shift;
+
+		if (!get_key_position(text[i], row, column, shift))
+		{
+			i++;
+			continue;
+		}
+		shifted += shift;
+
+		for (; j + 1 < n; j++)
+		{
+			int next_row, next_column;
+			if (!get_key_position(text[j + 1], next_row, next_column, shift))
+				break;
+
+			int d_row = next_row - row, d_column = next_column - column;
+			bool adjacent = d_row == 0 ? std::abs(d_column) == 4 : std::abs(d_row) == 1 && std::abs(d_column) < 4;
+			if (!adjacent)
+				break;
+
+			int next_direction = (d_row + 1) * 3 + (d_column > 0 ? 2 : d_column < 0 ? 0 : 1);
+			if (next_direction != direction)
+				turns++;
+
+			direction = next_direction;
+			shifted += shift;
+			row = next_row;
+			column = next_column;
+		}
+
+		size_t length = j - i + 1;
+		if (length >= 3)
+		{
+			double guesses = 0;
+			for (size_t k = 2; k <= length; k++)
+				for (int t = 1; t <= std::min<int>(turns, k - 1); t++)
+					guesses += std::exp(std::lgamma((double)k) - std::lgamma((double)t) - std::lgamma((double)k - t + 1)) * KEYBOARD_STARTING_POSITIONS * std::pow(KEYBOARD_AVERAGE_DEGREE, t);
+
+			out.push_back({ (uint8_t)i, (uint8_t)(j + 1), std::log10(guesses) + log10_variations(shifted, length - shifted), strength_t::KEYBOARD });
+		}
+
+		i = j > i ? j : i + 1;	// Walks share their last key with the walk after them
+	}
+}
+
+/*
+	Runs of three or more characters of the same class that go up or down in even steps, such as "abc", "7531" or "ZYX"
+*/
+void strength_estimator_t::find_sequence_matches(const std::string& text, std::vector<match_t>& out)
+{
+	size_t n = text.length();
+
+	auto class_of = [](char c) { return std::islower((unsigned char)c) ? 1 : std::isupper((unsigned char)c) ? 2 : std::isdigit((unsigned char)c) ? 3 : 0; };
+
+	for (size_t i = 0; i + 2 < n;)
+	{
+		int delta = text[i + 1] - text[i];
+		size_t j = i + 1;
+
+		if (class_of(text[i]) && delta != 0 && std::abs(delta) <= 2)
+			while (j + 1 < n && text[j + 1] - text[j] == delta && class_of(text[j + 1]) == class_of(text[i]))
+				j++;
+
+		size_t length = j - i + 1;
+		if (length >= 3 && class_of(text[j]) == class_of(text[i]))
+		{
+			char first = text[i];
+			double base = std::string("aAzZ01").find(first) != std::string::npos ? 4 : std::isdigit((unsigned char)first) ? 10 : 26;
+			if (delta < 0)
+				base *= 2;
+
+			out.push_back({ (uint8_t)i, (uint8_t)(j + 1), std::log10(base * length), strength_t::SEQUENCE });
+			i = j;
+		}
+		else
+			i++;
+	}
+}
+
+/*
+	A character or a block of characters repeated, such as "aaa" or "abcabc". The guesses are those for the block times the number of repeats.
+*/
+void strength_estimator_t::find_repeat_matches(const std::string& text, std::vector<match_t>& out)
+{
+	size_t n = text.length();
+
+	for (size_t i = 0; i + 2 < n; i++)
+	{
+		size_t j = i + 1;
+		while (j < n && text[j] == text[i])
+			j++;
+
+		if (j - i >= 3 && (i == 0 || text[i - 1] != text[i]))
+			out.push_back({ (uint8_t)i, (uint8_t)j, std::log10((double)cardinality(text[i]) * (j - i)), strength_t::REPEAT });
+	}
+
+	for (size_t block = 2; block * 2 <= n; block++)
+	{
+		for (size_t i = 0; i + block * 2 <= n; i++)
+		{
+			size_t repeats = 1;
+			while (i + (repeats + 1) * block <= n && text.compare(i + repeats * block, block, text, i, block) == 0)
+				repeats++;
+
+			if (repeats < 2 || (i > 0 && text[i - 1] == text[i + block - 1]))	// Only runs that can't start any earlier
+				continue;
+
+			size_t period = 1;	// Blocks that are themselves repeats are found as the smaller block
+			while (period < block && (block % period || text.compare(i, block - period, text, i + period, block - period)))
+				period++;
+			if (period < block)
+				continue;
+
+			double base = estimate(text.substr(i, block)).guesses;
+			out.push_back({ (uint8_t)i, (uint8_t)(i + repeats * block), base + std::log10((double)repeats), strength_t::REPEAT });
+		}
+	}
+}
+
+/*
+	Years from 1900 to 2050 and dates of four to eight digits in day, month and year order or any other, with or without separators, such as "1987", "4/7/91" or "19910704"
+*/
+void strength_estimator_t::find_date_matches(const std::string& text, std::vector<match_t>& out)
+{
+	size_t n = text.length();
+
+	auto read = [&](size_t start, size_t length)
+	{
+		int value = 0;
+		for (size_t k = start; k < start + length; k++)
+			value = value * 10 + (text[k] - '0');
+		return value;
+	};
+
+	auto full_year = [](int year, size_t digits) { return digits == 4 ? year : year > 50 ? 1900 + year : 2000 + year; };
+	auto is_day_month = [](int a, int b) { return (a >= 1 && a <= 31 && b >= 1 && b <= 12) || (b >= 1 && b <= 31 && a >= 1 && a <= 12); };
+	auto is_year = [](int year) { return year >= 1900 && year <= 2050; };
+
+	for (size_t i = 0; i < n; i++)
+	{
+		if (!std::isdigit((unsigned char)text[i]) || (i > 0 && std::isdigit((unsigned char)text[i - 1])))
+			continue;
+
+		size_t digits = i;
+		while (digits < n && digits - i < 8 && std::isdigit((unsigned char)text[digits]))
+			digits++;
+
+		for (size_t end = i + 4; end <= digits; end++)	// Dates without separators
+		{
+			size_t length = end - i;
+			int best_year = -1;
+
+			if (length == 4 && is_year(read(i, 4)))
+				best_year = read(i, 4);
+
+			for (size_t year_digits = 2; year_digits <= 4; year_digits += 2)
+			{
+				if (length <= year_digits + 1 || length > year_digits + 4)
+					continue;
+
+				for (int year_first = 0; year_first < 2; year_first++)
+				{
+					size_t rest = year_first ? i + year_digits : i, rest_length = length - year_digits;
+					int year = full_year(read(year_first ? i : end - year_digits, year_digits), year_digits);
+					if (!is_year(year))
+						continue;
+
+					for (size_t split = 1; split < rest_length && split <= 2; split++)
+						if (rest_length - split <= 2 && is_day_month(read(rest, split), read(rest + split, rest_length - split)))
+							if (best_year < 0 || std::abs(year - current_year) < std::abs(best_year - current_year))
+								best_year = year;
+				}
+			}
+
+			if (best_year >= 0)
+			{
+				double guesses = year_guesses(best_year) + (length == 4 && is_year(read(i, 4)) ? 0 : std::log10(365.0));
+				out.push_back({ (uint8_t)i, (uint8_t)end, guesses, strength_t::DATE });
+			}
+		}
+
+		size_t first = digits - i;	// Dates with separators, from the end of the first group of digits
+		if (first == 0 || first > 4 || digits >= n || !std::strchr(" -/._\\", text[digits]))
+			continue;
+
+		char separator = text[digits];
+		size_t second_start = digits + 1, second_end = second_start;
+		while (second_end < n && second_end - second_start < 2 && std::isdigit((unsigned char)text[second_end]))
+			second_end++;
+
+		if (second_end == second_start || second_end >= n || text[second_end] != separator)
+			continue;
+
+		size_t third_start = second_end + 1, third_end = third_start;
+		while (third_end < n && third_end - third_start < 4 && std::isdigit((unsigned char)text[third_end]))
+			third_end++;
+
+		size_t third = third_end - third_start;
+		if (third == 0 || (third_end < n && std::isdigit((unsigned char)text[third_end])))
+			continue;
+
+		int a = read(i, first), b = read(second_start, second_end - second_start), c = read(third_start, third);
+		int year = -1;
+
+		if ((third == 2 || third == 4) && first <= 2 && is_day_month(a, b) && is_year(full_year(c, third)))
+			year = full_year(c, third);
+		else if ((first == 2 || first == 4) && third <= 2 && is_day_month(b, c) && is_year(full_year(a, first)))
+			year = full_year(a, first);
+
+		if (year >= 0)
+			out.push_back({ (uint8_t)i, (uint8_t)third_end, year_guesses(year) + std::log10(365.0 * 4), strength_t::DATE });	// Four common separators
+	}
+}
+
+double strength_estimator_t::year_guesses(int year)
+{
+	return std::log10((double)std::max(std::abs(year - current_year), MIN_YEAR_SPACE));
+}
+
+/*
+	The letter a symbol most often stands in for in passwords, or the character itself
+*/
+char strength_estimator_t::unleet(char c)
+{
+	switch (c)
+	{
+		case '4': case '@': return 'a';
+		case '8': return 'b';
+		case '(': case '{': case '[': case '<': return 'c';
+		case '3': return 'e';
+		case '6': case '9': return 'g';
+		case '1': case '!': case '|': return 'i';
+		case '0': return 'o';
+		case '$': case '5': return 's';
+		case '7': case '+': return 't';
+		case '%': return 'x';
+		case '2': return 'z';
+		default: return c;
+	}
+}
+
+/*
+	log10 of n choose k
+*/
+double strength_estimator_t::log10_choose(int n, int k)
+{
+	return (std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0)) / std::log(10.0);
+}
+
+/*
+	log10 of the ways to pick which of the characters of a match take a variant, such as upper case or a symbol, given how many do and how many don't
+*/
+double strength_estimator_t::log10_variations(int variant, int plain)
+{
+	if (variant == 0)
+		return 0;
+	if (plain == 0)
+		return std::log10(2.0);	// All of them, which is tried about as soon as none
+
+	double sum = 0;
+	for (int i = 1; i <= std::min(variant, plain); i++)
+		sum += std::pow(10.0, log10_choose(variant + plain, i));
+
+	return std::log10(sum);
+}
+
+/*
+	log10 of the extra guesses for the capitalization of a word. A capital first or last letter, or all capitals, only doubles them.
+*/
+double strength_estimator_t::uppercase_variations(const std::string& text, size_t start, size_t end)
+{
+	int upper = 0, lower = 0;
+	for (size_t i = start; i < end; i++)
+	{
+		upper += std::isupper((unsigned char)text[i]) != 0;
+		lower += std::islower((unsigned char)text[i]) != 0;
+	}
+
+	if (upper == 0)
+		return 0;
+	if (lower == 0 || (upper == 1 && (std::isupper((unsigned char)text[start]) || std::isupper((unsigned char)text[end - 1]))))
+		return std::log10(2.0);
+
+	return log10_variations(upper, lower);
+}
+
+int strength_estimator_t::cardinality(char c)
+{
+	return std::isdigit((unsigned char)c) ? 10 : std::isalpha((unsigned char)c) ? 26 : 33;
+}
+
+/*
+	Where a character is on a QWERTY keyboard, in rows and quarter keys across, since each row is offset from the one above by part of a key
+*/
+bool strength_estimator_t::get_key_position(char c, int& row, int& column, bool& shifted)
+{
+	static const char* rows[] = { "`1234567890-=", "qwertyuiop[]\\", "asdfghjkl;'", "zxcvbnm,./" };
+	static const char* shifted_rows[] = { "~!@#$%^&*()_+", "QWERTYUIOP{}|", "ASDFGHJKL:\"", "ZXCVBNM<>?" };
+	static const int offsets[] = { 0, 6, 7, 9 };	// Where each row starts, in quarter keys
+
+	for (int r = 0; r < 4; r++)
+	{
+		const char* found = std::strchr(rows[r], c);
+		shifted = !found;
+		if (!found)
+			found = std::strchr(shifted_rows[r], c);
+
+		if (found && c)
+		{
+			row = r;
+			column = offsets[r] + 4 * (int)(found - (shifted ? shifted_rows[r] : rows[r]));
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+	Compile word lists into a dictionary file. Each list has one word per line, most common first, and a word in more than one list keeps its best rank.
+*/
+bool strength_estimator_t::build_dictionary(std::vector<std::string> list_filenames, std::string filename)
+{
+	std::vector<std::pair<std::string, uint32_t>> words;
+
+	for (unsigned int i = 0; i < list_filenames.size(); i++)
+	{
+		std::ifstream list(list_filenames.at(i));
+		if (!list.is_open())
+			return false;
+
+		std::string word;
+		uint32_t rank = 0;
+		while (std::getline(list, word))
+		{
+			if (!word.empty() && word.back() == '\r')
+				word.pop_back();
+			if (word.empty() || word.length() > STRENGTH_MAX_LENGTH)
+				continue;
+
+			for (size_t j = 0; j < word.length(); j++)
+				word[j] = std::tolower((unsigned char)word[j]);
+
+			words.push_back({ word, ++rank });
+		}
+	}
+
+	return dawg_t::build(words, filename);
+}
+
+/*
+	The estimator shared by the whole program, with the default dictionary if it has been built
+*/
+strength_estimator_t& get_strength_estimator()
+{
+	static strength_estimator_t estimator;
+	static bool opened = estimator.open(DEFAULT_DICTIONARY_FILENAME);
+
+	(void)opened;
+	return estimator;
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "output.h"
+
+#define TRACE_ENVIRONMENT_VARIABLE "PASSMNGR_TRACE"	// Names the file to write a trace to on exit
+#define TRACE_RING_SIZE (1 << 16)	// Events kept per thread, after which the oldest are overwritten
+
+/*
+	Time the rest of the enclosing scope as a span. Defining PASSMNGR_NO_TRACE compiles spans out entirely.
+*/
+#ifdef PASSMNGR_NO_TRACE
+#define TRACE_SPAN(name)
+#else
+#define TRACE_CONCAT(a, b) a##b
+#define TRACE_SPAN_NAME(line) TRACE_CONCAT(trace_span_, line)
+#define TRACE_SPAN(name) trace_span_t TRACE_SPAN_NAME(__LINE__)(name)
+#endif
+
+struct trace_event_t
+{
+	const char* name;
+	int64_t start;	// Nanoseconds since tracing started
+	int64_t duration;
+};
+
+/*
+	The events of one thread. Only the owning thread writes to a ring, so recording an event takes no lock; the count is published with release so that the rings can be read once the threads are idle.
+*/
+struct trace_ring_t
+{
+	trace_event_t events[TRACE_RING_SIZE];
+	std::atomic<uint64_t> count{0};
+	unsigned int thread = 0;
+};
+
+/*
+	A span that records its lifetime to the calling thread's ring when tracing is on, and otherwise costs one test
+*/
+class trace_span_t
+{
+	const char* name;
+	int64_t start;
+
+	public:
+	trace_span_t(const char*);
+	~trace_span_t();
+};
+
+bool start_tracing();
+int64_t get_trace_time();
+trace_ring_t* get_trace_ring();
+void write_trace();
+
+bool tracing = start_tracing();
+
+std::chrono::steady_clock::time_point& get_trace_epoch()
+{
+	static std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	return epoch;
+}
+
+std::string& get_trace_filename()
+{
+	static std::string filename;
+	return filename;
+}
+
+/*
+	Every ring, guarded by a mutex that is only taken when a thread records its first event and when the trace is written
+*/
+std::vector<trace_ring_t*>& get_trace_rings(std::unique_lock<std::mutex>& lock)
+{
+	static std::mutex mutex;
+	static std::vector<trace_ring_t*> rings;
+
+	lock = std::unique_lock<std::mutex>(mutex);
+	return rings;
+}
+
+/*
+	Turn tracing on if the environment names a trace file, and write the trace to it on exit
+*/
+bool start_tracing()
+{
+	const char* filename = std::getenv(TRACE_ENVIRONMENT_VARIABLE);
+	if (!filename || !*filename)
+		return false;
+
+	get_trace_filename() = filename;
+	get_trace_epoch();
+
+	std::unique_lock<std::mutex> lock;
+	get_trace_rings(lock);	// Statics made before the exit handler is registered outlive it
+	lock.unlock();
+
+	std::atexit(write_trace);
+	return true;
+}
+
+int64_t get_trace_time()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - get_trace_epoch()).count();
+}
+
+/*
+	The calling thread's ring, created and registered the first time the thread records an event
+*/
+trace_ring_t* get_trace_ring()
+{
+	thread_local trace_ring_t* ring = nullptr;
+
+	if (!ring)
+	{
+		std::unique_lock<std::mutex> lock;
+		std::vector<trace_ring_t*>& rings = get_trace_rings(lock);
+
+		ring = new trace_ring_t();
+		ring->thread = static_cast<unsigned int>(rings.size()) + 1;
+		rings.push_back(ring);
+	}
+
+	return ring;
+}
+
+trace_span_t::trace_span_t(const char* name)
+{
+	this->name = name;
+	if (tracing)
+		start = get_trace_time();
+}
+
+trace_span_t::~trace_span_t()
+{
+	if (!tracing)
+		return;
+
+	trace_ring_t* ring = get_trace_ring();
+	uint64_t n = ring->count.load(std::memory_order_relaxed);
+	trace_event_t& event = ring->events[n % TRACE_RING_SIZE];
+
+	event.name = name;
+	event.start = start;
+	event.duration = get_trace_time() - start;
+	ring->count.store(n + 1, std::memory_order_release);
+}
+
+/*
+	Write every ring as complete events in the Chrome trace format, which chrome://tracing and Perfetto open. Rings that overflowed keep their latest events.
+*/
+void write_trace()
+{
+	std::ofstream file(get_trace_filename(), std::ios::trunc | std::ios::binary);
+	if (!file.is_open())
+		return;
+
+	std::string buffer;
+	json_writer_t writer(buffer, &file);
+	std::unique_lock<std::mutex> lock;
+	std::vector<trace_ring_t*>& rings = get_trace_rings(lock);
+
+	writer.begin_object();
+	writer.key("displayTimeUnit").value("ns");
+	writer.key("traceEvents").begin_array();
+
+	for (unsigned int i = 0; i < rings.size(); i++)
+	{
+		uint64_t count = rings.at(i)->count.load(std::memory_order_acquire);
+		uint64_t first = count > TRACE_RING_SIZE ? count - TRACE_RING_SIZE : 0;
+
+		for (uint64_t j = first; j < count; j++)
+		{
+			const trace_event_t& event = rings.at(i)->events[j % TRACE_RING_SIZE];
+
+			writer.begin_object();
+			writer.key("name").value(event.name);
+			writer.key("ph").value("X");
+			writer.key("ts").value(event.start / 1000.0);
+			writer.key("dur").value(event.duration / 1000.0);
+			writer.key("pid").value(1LL);
+			writer.key("tid").value(static_cast<long long>(rings.at(i)->thread));
+			writer.end_object();
+			writer.end_line();
+		}
+	}
+
+	writer.end_array();
+	writer.end_object();
+	writer.end_line();
+}
\ No newline at end of file
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "memory.h"
+
+/*
+	A radix trie of strings, where each edge holds the longest run of characters shared by every string below it. Each node counts the strings below it so that prefix counts take time proportional to the prefix length alone.
+*/
+class radix_trie_t
+{
+	struct node_t
+	{
+		std::string label;	// Characters on the edge leading to this node
+		std::vector<std::unique_ptr<node_t>> children;	// Sorted by the first character of their labels
+		unsigned int count = 0;	// Number of times the string ending at this node was inserted
+		size_t size = 0;	// Number of strings ending at or below this node
+	};
+
+	node_t root;
+
+	std::vector<std::unique_ptr<node_t>>::iterator find_child(node_t*, char);
+	node_t* find_prefix(const std::string&, std::string&);
+	void collect(node_t*, std::string&, std::vector<std::string>&, size_t);
+
+	public:
+	void insert(const std::string&);
+	bool erase(const std::string&);
+	void clear();
+
+	size_t size();
+	unsigned int count(const std::string&);
+	size_t count_prefix(const std::string&);
+	std::vector<std::string> complete(const std::string&, size_t);
+	std::string extend(const std::string&);
+	void account_memory(memory_report_t&, memory_subsystem_t);
+};
+
+/*
+	Find the child whose label starts with the specified character, or where it would be inserted
+*/
+std::vector<std::unique_ptr<radix_trie_t::node_t>>::iterator radix_trie_t::find_child(node_t* node, char c)
+{
+	return std::lower_bound(node->children.begin(), node->children.end(), c, [](const std::unique_ptr<node_t>& child, char c)
+	{
+		return static_cast<unsigned char>(child->label[0]) < static_cast<unsigned char>(c);
+	});
+}
+
+/*
+	Find the highest node whose strings all start with the prefix. The path parameter is set to the characters on the way to that node, which may run past the end of the prefix.
+*/
+radix_trie_t::node_t* radix_trie_t::find_prefix(const std::string& prefix, std::string& path)
+{
+	node_t* node = &root;
+	size_t i = 0;
+	path.clear();
+
+	while (i < prefix.length())
+	{
+		std::vector<std::unique_ptr<node_t>>::iterator it = find_child(node, prefix[i]);
+		if (it == node->children.end() || (*it)->label[0] != prefix[i])
+			return nullptr;
+
+		node_t* child = it->get();
+		size_t n = std::min(child->label.length(), prefix.length() - i);
+		if (child->label.compare(0, n, prefix, i, n) != 0)
+			return nullptr;
+
+		path += child->label;
+		i += child->label.length();
+		node = child;
+	}
+
+	return node;
+}
+
+/*
+	Append up to max strings below a node, in sorted order
+*/
+void radix_trie_t::collect(node_t* node, std::string& path, std::vector<std::string>& out, size_t max)
+{
+	for (unsigned int i = 0; i < node->count && out.size() < max; i++)
+		out.push_back(path);
+
+	for (unsigned int i = 0; i < node->children.size() && out.size() < max; i++)
+	{
+		node_t* child = node->children.at(i).get();
+
+		path += child->label;
+		collect(child, path, out, max);
+		path.erase(path.length() - child->label.length());
+	}
+}
+
+void radix_trie_t::insert(const std::string& key)
+{
+	node_t* node = &root;
+	size_t i = 0;
+
+	node->size++;
+	while (i < key.length())
+	{
+		std::vector<std::unique_ptr<node_t>>::iterator it = find_child(node, key[i]);
+
+		if (it == node->children.end() || (*it)->label[0] != key[i])	// No edge shares a first character, so the rest of the key gets its own
+		{
+			std::unique_ptr<node_t> leaf(new node_t());
+			leaf->label = key.substr(i);
+			leaf->count = 1;
+			leaf->size = 1;
+			node->children.insert(it, std::move(leaf));
+			return;
+		}
+
+		node_t* child = it->get();
+		size_t shared = 0;
+		while (shared < child->label.length() && i + shared < key.length() && child->label[shared] == key[i + shared])
+			shared++;
+
+		if (shared < child->label.length())	// Split the edge where the key leaves it
+		{
+			std::unique_ptr<node_t> split(new node_t());
+			split->label = child->label.substr(0, shared);
+			split->size = child->size;
+
+			child->label.erase(0, shared);
+			split->children.push_back(std::move(*it));
+			*it = std::move(split);
+			child = it->get();
+		}
+
+		child->size++;
+		i += shared;
+		node = child;
+	}
+
+	node->count++;
+}
+
+/*
+	Remove one copy of a string, merging edges that are left with a single child
+*/
+bool radix_trie_t::erase(const std::string& key)
+{
+	std::vector<node_t*> path = { &root };
+	size_t i = 0;
+
+	while (i < key.length())
+	{
+		node_t* node = path.back();
+		std::vector<std::unique_ptr<node_t>>::iterator it = find_child(node, key[i]);
+		if (it == node->children.end() || key.compare(i, (*it)->label.length(), (*it)->label) != 0)
+			return false;
+
+		i += (*it)->label.length();
+		path.push_back(it->get());
+	}
+
+	if (path.back()->count == 0)
+		return false;
+
+	path.back()->count--;
+	for (unsigned int j = 0; j < path.size(); j++)
+		path.at(j)->size--;
+
+	for (size_t j = path.size() - 1; j > 0; j--)	// Tidy up from the bottom, never removing the root
+	{
+		node_t* node = path.at(j);
+		node_t* parent = path.at(j - 1);
+		std::vector<std::unique_ptr<node_t>>::iterator it = find_child(parent, node->label[0]);
+
+		if (node->size == 0)
+			parent->children.erase(it);
+		else if (node->count == 0 && node->children.size() == 1)	// Fold the only child into this edge
+		{
+			std::unique_ptr<node_t> child = std::move(node->children.front());
+			child->label = node->label + child->label;
+			*it = std::move(child);
+		}
+		else
+			break;
+	}
+
+	return true;
+}
+
+void radix_trie_t::clear()
+{
+	root.children.clear();
+	root.count = 0;
+	root.size = 0;
+}
+
+size_t radix_trie_t::size()
+{
+	return root.size;
+}
+
+/*
+	Number of copies of a string
+*/
+unsigned int radix_trie_t::count(const std::string& key)
+{
+	std::string path;
+	node_t* node = find_prefix(key, path);
+
+	return node && path.length() == key.length() ? node->count : 0;
+}
+
+/*
+	Number of strings starting with the prefix
+*/
+size_t radix_trie_t::count_prefix(const std::string& prefix)
+{
+	std::string path;
+	node_t* node = find_prefix(prefix, path);
+
+	return node ? node->size : 0;
+}
+
+/*
+	Return up to max strings starting with the prefix, in sorted order
+*/
+std::vector<std::string> radix_trie_t::complete(const std::string& prefix, size_t max)
+{
+	std::vector<std::string> out;
+	std::string path;
+	node_t* node = find_prefix(prefix, path);
+
+	if (node)
+		collect(node, path, out, max);
+
+	return out;
+}
+
+/*
+	Extend a prefix for as long as every string starting with it continues the same way, as tab completion does
+*/
+std::string radix_trie_t::extend(const std::string& prefix)
+{
+	std::string path;
+	node_t* node = find_prefix(prefix, path);
+
+	if (!node)
+		return prefix;
+
+	while (node->count == 0 && node->children.size() == 1)
+	{
+		node = node->children.front().get();
+		path += node->label;
+	}
+
+	return path;
+}
+
+/*
+	Add every node below the root, with its label and child list, to a memory report under the specified subsystem
+*/
+void radix_trie_t::account_memory(memory_report_t& report, memory_subsystem_t subsystem)
+{
+	std::vector<node_t*> stack(1, &root);
+	size_t nodes = 0;
+	size_t bytes = 0;
+
+	while (!stack.empty())
+	{
+		node_t* node = stack.back();
+		stack.pop_back();
+
+		bytes += heap_bytes_of(node->label) + heap_bytes_of(node->children);
+		for (unsigned int i = 0; i < node->children.size(); i++)
+			stack.push_back(node->children.at(i).get());
+
+		if (node != &root)
+		{
+			nodes++;
+			bytes += sizeof(node_t);
+		}
+	}
+
+	report.add(subsystem, nodes, bytes);
+}
\ No newline at end of file
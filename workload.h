@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "response.h"
+
+#define WORKLOAD_ENVIRONMENT_VARIABLE "PASSMNGR_RECORD"	// Names a file to record to in every mode, including the interactive one
+#define WORKLOAD_HEADER "# passmngr workload 1"
+#define WORKLOAD_FLUSH_SIZE (1 << 16)	// Bytes of log lines held before they are written out
+#define WORKLOAD_SECRET '*'	// Starts a redacted argument, followed by the length of the text it stands for
+
+/*
+	One recorded operation, as read back for replay
+*/
+struct workload_operation_t
+{
+	int64_t start;	// Microseconds since recording started
+	int64_t duration;	// Microseconds the operation took when it was recorded
+	std::string operation;
+	std::vector<std::string> arguments;
+};
+
+/*
+	Writes session operations to a log, one per line, as tab-separated fields: start and duration in microseconds, the operation, and its arguments. Site names and security-level codes are replaced by aliases numbered in the order they are first seen, so the log keeps which operations touch the same credentials without naming them. Secrets, usernames, and free text are replaced by their length alone.
+*/
+class workload_recorder_t
+{
+	std::ofstream file;
+	std::string buffer;
+	std::unordered_map<std::string, std::string> names;	// Aliases by site name
+	std::unordered_map<std::string, std::string> levels;	// Aliases by security-level code
+	std::chrono::steady_clock::time_point start;
+
+	public:
+	~workload_recorder_t();
+
+	bool open(std::string);
+	bool is_open();
+	int64_t get_time();
+	std::string alias_name(const std::string&);
+	std::string alias_level(const std::string&);
+	void write(int64_t, int64_t, const char*, const std::string&);
+	void flush();
+};
+
+/*
+	Records an operation with its redacted arguments when its scope ends. Only the outermost operation on a thread is recorded, so operations made of other operations are logged once. When nothing is being recorded, adding arguments does nothing.
+*/
+class workload_event_t
+{
+	const char* operation;
+	std::string arguments;
+	int64_t start;
+	bool recorded;
+
+	public:
+	workload_event_t(const char*);
+	~workload_event_t();
+
+	workload_event_t& name(const std::string&);
+	workload_event_t& level(const std::string&);
+	workload_event_t& secret(const std::string&);
+	workload_event_t& field(const std::string&);
+	workload_event_t& number(long long);
+	workload_event_t& query(const std::string&);
+};
+
+workload_recorder_t& get_workload_recorder();
+unsigned int& get_workload_depth();
+std::string redact(const std::string&);
+std::vector<workload_operation_t> read_workload(std::string);
+
+workload_recorder_t& get_workload_recorder()
+{
+	static workload_recorder_t recorder;
+	return recorder;
+}
+
+/*
+	Depth of the recorded operations running on the calling thread
+*/
+unsigned int& get_workload_depth()
+{
+	thread_local unsigned int depth = 0;
+	return depth;
+}
+
+/*
+	Stand-in for text that must not be logged, keeping only its length
+*/
+std::string redact(const std::string& text)
+{
+	return WORKLOAD_SECRET + std::to_string(text.length());
+}
+
+workload_recorder_t::~workload_recorder_t()
+{
+	flush();
+}
+
+bool workload_recorder_t::open(std::string filename)
+{
+	file.open(filename, std::ios::trunc | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	start = std::chrono::steady_clock::now();
+	buffer = WORKLOAD_HEADER "\n";
+	return true;
+}
+
+bool workload_recorder_t::is_open()
+{
+	return file.is_open();
+}
+
+/*
+	Microseconds since recording started
+*/
+int64_t workload_recorder_t::get_time()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string workload_recorder_t::alias_name(const std::string& name)
+{
+	std::unordered_map<std::string, std::string>::iterator it = names.find(name);
+	if (it == names.end())
+		it = names.emplace(name, "site" + std::to_string(names.size() + 1)).first;
+
+	return it->second;
+}
+
+std::string workload_recorder_t::alias_level(const std::string& code)
+{
+	std::unordered_map<std::string, std::string>::iterator it = levels.find(code);
+	if (it == levels.end())
+		it = levels.emplace(code, "level" + std::to_string(levels.size() + 1)).first;
+
+	return it->second;
+}
+
+void workload_recorder_t::write(int64_t start, int64_t duration, const char* operation, const std::string& arguments)
+{
+	buffer += std::to_string(start);
+	buffer += '\t';
+	buffer += std::to_string(duration);
+	buffer += '\t';
+	buffer += operation;
+	buffer += arguments;
+	buffer += '\n';
+
+	if (buffer.size() >= WORKLOAD_FLUSH_SIZE)
+		flush();
+}
+
+void workload_recorder_t::flush()
+{
+	if (file.is_open() && !buffer.empty())
+	{
+		file.write(buffer.data(), buffer.size());
+		file.flush();
+	}
+
+	buffer.clear();
+}
+
+workload_event_t::workload_event_t(const char* operation)
+{
+	this->operation = operation;
+	recorded = get_workload_depth()++ == 0 && get_workload_recorder().is_open();
+
+	if (recorded)
+		start = get_workload_recorder().get_time();
+}
+
+workload_event_t::~workload_event_t()
+{
+	get_workload_depth()--;
+
+	if (recorded)
+	{
+		workload_recorder_t& recorder = get_workload_recorder();
+		recorder.write(start, recorder.get_time() - start, operation, arguments);
+	}
+}
+
+workload_event_t& workload_event_t::name(const std::string& name)
+{
+	if (recorded)
+		arguments += '\t' + get_workload_recorder().alias_name(name);
+
+	return *this;
+}
+
+workload_event_t& workload_event_t::level(const std::string& code)
+{
+	if (recorded)
+		arguments += '\t' + get_workload_recorder().alias_level(code);
+
+	return *this;
+}
+
+workload_event_t& workload_event_t::secret(const std::string& text)
+{
+	if (recorded)
+		arguments += '\t' + redact(text);
+
+	return *this;
+}
+
+/*
+	Add the field a modification applies to, logged by its first letter alone as modify_credentials reads it
+*/
+workload_event_t& workload_event_t::field(const std::string& text)
+{
+	if (recorded)
+	{
+		arguments += '\t';
+		arguments += text.empty() ? '?' : static_cast<char>(std::tolower(static_cast<unsigned char>(text[0])));
+	}
+
+	return *this;
+}
+
+workload_event_t& workload_event_t::number(long long n)
+{
+	if (recorded)
+		arguments += '\t' + std::to_string(n);
+
+	return *this;
+}
+
+/*
+	Add a search query with the structure of its filters kept and their text redacted. Security-level codes are aliased, and the fixed values of expired: and has: are kept as they are.
+*/
+workload_event_t& workload_event_t::query(const std::string& query)
+{
+	if (!recorded)
+		return *this;
+
+	std::vector<std::string> words = tokenize(query);
+	std::string out;
+
+	for (unsigned int i = 0; i < words.size(); i++)
+	{
+		size_t colon = words.at(i).find(':');
+		std::string field = colon == std::string::npos ? std::string() : words.at(i).substr(0, colon);
+		std::string value = colon == std::string::npos ? words.at(i) : words.at(i).substr(colon + 1);
+
+		std::transform(field.begin(), field.end(), field.begin(),
+			[](unsigned char c) { return std::tolower(c); });
+
+		if (!out.empty())
+			out += ' ';
+
+		if (field == "level")
+			out += "level:" + get_workload_recorder().alias_level(value);
+		else if (field == "expired" || field == "has")
+			out += words.at(i);
+		else if (field == "name" || field == "domain" || field == "user")
+			out += field + ':' + redact(value);
+		else
+			out += redact(words.at(i));	// Bare words and URLs
+	}
+
+	arguments += '\t' + out;
+	return *this;
+}
+
+/*
+	Read every operation in a log written by workload_recorder_t, skipping the header and malformed lines
+*/
+std::vector<workload_operation_t> read_workload(std::string filename)
+{
+	std::vector<workload_operation_t> out;
+	std::ifstream file(filename, std::ios::binary);
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::vector<std::string> fields;
+		std::stringstream row(line);
+		std::string field;
+
+		while (std::getline(row, field, '\t'))
+			fields.push_back(field);
+		if (fields.size() < 3)
+			continue;
+
+		workload_operation_t operation;
+		try
+		{
+			operation.start = std::stoll(fields.at(0));
+			operation.duration = std::stoll(fields.at(1));
+		}
+		catch (const std::exception&)	// Times that aren't numbers
+		{
+			continue;
+		}
+
+		operation.operation = fields.at(2);
+		operation.arguments.assign(fields.begin() + 3, fields.end());
+		out.push_back(operation);
+	}
+
+	return out;
+}
\ No newline at end of file